@@ -19,33 +19,57 @@ typedef struct {
 
 #define BASIC_ARRAY_NULL ((basic_array){BASIC_BLOCK_NULL, 0})
 
+// The number of indices ahead of the current one whose elements are
+// prefetched by the gather, scatter and permute functions. Override at
+// build time to tune for a particular memory system.
+#ifndef BASIC_ARRAY_PREFETCH_DISTANCE
+    #define BASIC_ARRAY_PREFETCH_DISTANCE 16
+#endif
+
 static inline bool basic_array_isnull(basic_array const *array);
 static inline bool basic_array_isinit(basic_array const *array);
 
 basic_array basic_array_move(basic_array *array);
 basic_array basic_array_clone(basic_array const *array);
 
-basic_array basic_array_alloc(size_t elem_size, int elem_count);
-basic_array *basic_array_realloc(basic_array *array, int elem_count);
+basic_array basic_array_alloc(size_t elem_size, size_t elem_count);
+basic_array *basic_array_realloc(basic_array *array, size_t elem_count);
 void basic_array_dealloc(basic_array *array);
 
 basic_array basic_array_fromblock(basic_block *block, size_t elem_size);
 basic_block basic_array_toblock(basic_array *array);
 
-static inline int basic_array_cap(basic_array const *array);
+static inline size_t basic_array_cap(basic_array const *array);
+
+void *basic_array_at(basic_array *array, size_t index);
+void const *basic_array_at_c(basic_array const *array, size_t index);
+
+basic_span basic_array_get(basic_array *array, size_t index);
+
+void basic_array_gather(
+        basic_array *dest,
+        basic_array const *src,
+        size_t const *indices,
+        size_t n);
 
-void *basic_array_at(basic_array *array, int index);
-void const *basic_array_at_c(basic_array const *array, int index);
+void basic_array_scatter(
+        basic_array *dest,
+        basic_array const *src,
+        size_t const *indices,
+        size_t n);
 
-basic_span basic_array_get(basic_array *array, int index);
+bool basic_array_permute(
+        basic_array *array,
+        size_t const *perm,
+        size_t n);
 
-int basic_array_cap(basic_array const *array)
+size_t basic_array_cap(basic_array const *array)
 {
     BASIC_ASSERT_PTR_NONNULL(array);
     BASIC_ASSERT(basic_array_isinit(array),
             "basic_array object must be initialised");
 
-    return (int)(array->data.size / array->elem_size);
+    return array->data.size / array->elem_size;
 }
 
 bool basic_array_isnull(basic_array const *array)
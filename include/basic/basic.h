@@ -7,9 +7,22 @@
 
     #define BASIC_VPRINTF_FMT(fmt) \
         __attribute__((__format__(__printf__, (fmt), 0)))
+
+    #define BASIC_PREFETCH_READ(addr)   __builtin_prefetch((addr), 0, 3)
+    #define BASIC_PREFETCH_WRITE(addr)  __builtin_prefetch((addr), 1, 3)
 #else
     #define BASIC_PRINTF_FMT(fmt, arg)  // Nothing
     #define BASIC_VPRINTF_FMT(fmt)      // Nothing
+
+    #define BASIC_PREFETCH_READ(addr)   ((void)(addr))
+    #define BASIC_PREFETCH_WRITE(addr)  ((void)(addr))
+#endif
+
+// The size of a cache line, used to pad data written by different threads
+// so that it is not falsely shared. Override at build time for targets with
+// a different line size.
+#ifndef BASIC_CACHE_LINE_SIZE
+    #define BASIC_CACHE_LINE_SIZE 64
 #endif
 
 #endif // BASIC_BASIC_H_
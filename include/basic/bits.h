@@ -0,0 +1,147 @@
+/**
+ * @file bits.h
+ *
+ * Word-level kernels shared by the bit containers. Each function operates
+ * on an array of 64-bit words; the containers own the storage and enforce
+ * their own invariants.
+ *
+ * The bulk kernels use AVX2 or AVX-512 when the translation unit is built
+ * with the corresponding target flags (e.g. @c -mavx2, @c -mavx512f,
+ * @c -mavx512vpopcntdq), and fall back to portable scalar code otherwise.
+ */
+
+#ifndef BASIC_BITS_H_
+#define BASIC_BITS_H_
+
+#include <stdint.h>
+
+/**
+ * @brief The number of bits in each word of a bit container.
+ */
+#define BASIC_BITS_PER_WORD 64
+
+/**
+ * @brief Returns the number of words needed to hold @c bit_count bits.
+ */
+static inline int basic_bits_words_for(int bit_count);
+
+/**
+ * @brief Returns the number of set bits in @c word.
+ */
+static inline int basic_bits_popcount(uint64_t word);
+
+/**
+ * @brief Returns the index of the lowest set bit in @c word.
+ *
+ * With GCC or Clang and BMI enabled this compiles to a single @c tzcnt.
+ *
+ * @pre @c word must be nonzero
+ */
+static inline int basic_bits_ctz(uint64_t word);
+
+/**
+ * @brief Returns the index of the highest set bit in @c word, which is the
+ *  base-2 logarithm of @c word rounded down.
+ *
+ * @pre @c word must be nonzero
+ */
+static inline int basic_bits_log2(uint64_t word);
+
+/**
+ * @brief Returns the smallest power of two no less than @c n, or 0 if it
+ *  does not fit in 64 bits.
+ *
+ * Containers with an int capacity must also check the result against
+ * @c INT_MAX, since any @c n above 2^30 rounds past it.
+ */
+static inline uint64_t basic_bits_ceil_pow2(uint64_t n);
+
+/**
+ * @brief Returns the total number of set bits in the first @c word_count
+ *  words of @c words.
+ */
+int basic_bits_popcount_words(uint64_t const *words, int word_count);
+
+/**
+ * @brief Computes @c dest[i] &= @c src[i] for the first @c word_count words.
+ */
+void basic_bits_and(uint64_t *dest, uint64_t const *src, int word_count);
+
+/**
+ * @brief Computes @c dest[i] |= @c src[i] for the first @c word_count words.
+ */
+void basic_bits_or(uint64_t *dest, uint64_t const *src, int word_count);
+
+/**
+ * @brief Computes @c dest[i] ^= @c src[i] for the first @c word_count words.
+ */
+void basic_bits_xor(uint64_t *dest, uint64_t const *src, int word_count);
+
+/**
+ * @brief Computes @c dest[i] &= ~@c src[i] for the first @c word_count
+ *  words.
+ */
+void basic_bits_andnot(uint64_t *dest, uint64_t const *src, int word_count);
+
+/**
+ * @brief Returns the index of the first set bit at or after @c from in the
+ *  first @c bit_count bits of @c words, or -1 if there is none.
+ */
+int basic_bits_next(uint64_t const *words, int bit_count, int from);
+
+int basic_bits_words_for(int bit_count)
+{
+    return bit_count / BASIC_BITS_PER_WORD
+        + (bit_count % BASIC_BITS_PER_WORD != 0);
+}
+
+int basic_bits_popcount(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcountll(word);
+#else
+    word = word - ((word >> 1) & UINT64_C(0x5555555555555555));
+    word = (word & UINT64_C(0x3333333333333333))
+        + ((word >> 2) & UINT64_C(0x3333333333333333));
+    word = (word + (word >> 4)) & UINT64_C(0x0f0f0f0f0f0f0f0f);
+    return (int)((word * UINT64_C(0x0101010101010101)) >> 56);
+#endif
+}
+
+int basic_bits_ctz(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(word);
+#else
+    return basic_bits_popcount((word & -word) - 1);
+#endif
+}
+
+int basic_bits_log2(uint64_t word)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(word);
+#else
+    int log2 = 0;
+    while (word >>= 1) {
+        ++log2;
+    }
+
+    return log2;
+#endif
+}
+
+uint64_t basic_bits_ceil_pow2(uint64_t n)
+{
+    if (n <= 1) {
+        return 1;
+    }
+
+    if (n > UINT64_C(1) << 63) {
+        return 0;
+    }
+
+    return UINT64_C(1) << (basic_bits_log2(n - 1) + 1);
+}
+
+#endif // BASIC_BITS_H_
@@ -0,0 +1,149 @@
+/**
+ * @file bitset.h
+ */
+
+#ifndef BASIC_BITSET_H_
+#define BASIC_BITSET_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "assertion.h"
+#include "bits.h"
+#include "block.h"
+
+/**
+ * @struct basic_bitset
+ * @brief A fixed-size set of bits packed into 64-bit words.
+ *
+ * A basic_bitset stores @c bit_count bits in a freestore-allocated
+ * basic_block, one bit per element. Bits past @c bit_count in the final
+ * word are always zero, so that counting and bulk operations may work on
+ * whole words.
+ *
+ * @var basic_bitset::words
+ * @brief The basic_block holding the packed words.
+ *
+ * @var basic_bitset::bit_count
+ * @brief The number of bits in the set.
+ */
+typedef struct {
+    basic_block words;
+    int bit_count;
+} basic_bitset;
+
+/**
+ * @brief The value representing a basic_bitset in the null state.
+ */
+#define BASIC_BITSET_NULL ((basic_bitset){BASIC_BLOCK_NULL, 0})
+
+static inline bool basic_bitset_isnull(basic_bitset const *bitset);
+static inline bool basic_bitset_isinit(basic_bitset const *bitset);
+
+basic_bitset basic_bitset_move(basic_bitset *bitset);
+basic_bitset basic_bitset_clone(basic_bitset const *bitset);
+
+/**
+ * @brief Allocates a basic_bitset of @c bit_count bits, all clear.
+ *
+ * @pre @c bit_count must be positive
+ *
+ * @returns An initialised basic_bitset, or @ref BASIC_BITSET_NULL if the
+ *  allocation fails.
+ */
+basic_bitset basic_bitset_new(int bit_count);
+void basic_bitset_destroy(basic_bitset *bitset);
+
+static inline void basic_bitset_set(basic_bitset *bitset, int index);
+static inline void basic_bitset_clear(basic_bitset *bitset, int index);
+static inline void basic_bitset_flip(basic_bitset *bitset, int index);
+static inline bool basic_bitset_test(basic_bitset const *bitset, int index);
+
+/**
+ * @brief Sets every bit of the basic_bitset to @c value.
+ */
+void basic_bitset_fill(basic_bitset *bitset, bool value);
+
+/**
+ * @brief Returns the number of set bits in the basic_bitset.
+ */
+int basic_bitset_count(basic_bitset const *bitset);
+
+/**
+ * @brief Returns the index of the first set bit at or after @c from, or -1
+ *  if there is none.
+ *
+ * Iterating over the set bits is written as
+ * @code
+ * for (int i = basic_bitset_next(&set, 0); i != -1;
+ *         i = basic_bitset_next(&set, i + 1)) { ... }
+ * @endcode
+ *
+ * @pre @c from must be in [0, bit_count]
+ */
+int basic_bitset_next(basic_bitset const *bitset, int from);
+
+/**
+ * @brief Bulk set operations, computing @c dest = @c dest op @c src one
+ *  word (or SIMD vector of words) at a time.
+ *
+ * @pre @c dest and @c src must be initialised and have equal @c bit_count
+ */
+void basic_bitset_and(basic_bitset *dest, basic_bitset const *src);
+void basic_bitset_or(basic_bitset *dest, basic_bitset const *src);
+void basic_bitset_xor(basic_bitset *dest, basic_bitset const *src);
+void basic_bitset_andnot(basic_bitset *dest, basic_bitset const *src);
+
+bool basic_bitset_isnull(basic_bitset const *bitset)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    return basic_block_isnull(&bitset->words) && !bitset->bit_count;
+}
+
+bool basic_bitset_isinit(basic_bitset const *bitset)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    return basic_block_isinit(&bitset->words) && bitset->bit_count > 0;
+}
+
+void basic_bitset_set(basic_bitset *bitset, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(index >= 0 && index < bitset->bit_count,
+            "index %d out of range", index);
+
+    ((uint64_t *)bitset->words.ptr)[index / BASIC_BITS_PER_WORD]
+        |= UINT64_C(1) << (index % BASIC_BITS_PER_WORD);
+}
+
+void basic_bitset_clear(basic_bitset *bitset, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(index >= 0 && index < bitset->bit_count,
+            "index %d out of range", index);
+
+    ((uint64_t *)bitset->words.ptr)[index / BASIC_BITS_PER_WORD]
+        &= ~(UINT64_C(1) << (index % BASIC_BITS_PER_WORD));
+}
+
+void basic_bitset_flip(basic_bitset *bitset, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(index >= 0 && index < bitset->bit_count,
+            "index %d out of range", index);
+
+    ((uint64_t *)bitset->words.ptr)[index / BASIC_BITS_PER_WORD]
+        ^= UINT64_C(1) << (index % BASIC_BITS_PER_WORD);
+}
+
+bool basic_bitset_test(basic_bitset const *bitset, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(index >= 0 && index < bitset->bit_count,
+            "index %d out of range", index);
+
+    return (((uint64_t const *)bitset->words.ptr)[index / BASIC_BITS_PER_WORD]
+            >> (index % BASIC_BITS_PER_WORD)) & 1;
+}
+
+#endif // BASIC_BITSET_H_
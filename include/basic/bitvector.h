@@ -0,0 +1,162 @@
+/**
+ * @file bitvector.h
+ */
+
+#ifndef BASIC_BITVECTOR_H_
+#define BASIC_BITVECTOR_H_
+
+#include <stdbool.h>
+
+#include "assertion.h"
+#include "bitset.h"
+
+/**
+ * @struct basic_bitvector
+ * @brief A growable sequence of bits.
+ *
+ * A basic_bitvector stores its bits in a basic_bitset whose @c bit_count is
+ * the capacity of the basic_bitvector, and grows that storage by doubling.
+ * Bits between @c bit_count and the capacity are always zero, so the
+ * underlying basic_bitset may be passed directly to whole-set queries such
+ * as @ref basic_rank_select_new.
+ *
+ * @var basic_bitvector::bits
+ * @brief The storage, with @c bits.bit_count equal to the capacity.
+ *
+ * @var basic_bitvector::bit_count
+ * @brief The number of bits in the basic_bitvector.
+ */
+typedef struct {
+    basic_bitset bits;
+    int bit_count;
+} basic_bitvector;
+
+/**
+ * @brief The value representing a basic_bitvector in the null state.
+ */
+#define BASIC_BITVECTOR_NULL ((basic_bitvector){BASIC_BITSET_NULL, 0})
+
+static inline bool basic_bitvector_isnull(basic_bitvector const *bitvector);
+static inline bool basic_bitvector_isinit(basic_bitvector const *bitvector);
+static inline bool basic_bitvector_isempty(basic_bitvector const *bitvector);
+
+basic_bitvector basic_bitvector_move(basic_bitvector *bitvector);
+basic_bitvector basic_bitvector_clone(basic_bitvector const *bitvector);
+
+/**
+ * @brief Creates an empty basic_bitvector with room for @c initial_cap bits.
+ *
+ * @pre @c initial_cap must be positive
+ */
+basic_bitvector basic_bitvector_new(int initial_cap);
+void basic_bitvector_destroy(basic_bitvector *bitvector);
+
+/**
+ * @brief Appends a bit with the given value.
+ *
+ * @retval true If the bit was appended.
+ * @retval false If growing the storage failed.
+ */
+bool basic_bitvector_pushback(basic_bitvector *bitvector, bool value);
+void basic_bitvector_popback(basic_bitvector *bitvector);
+
+/**
+ * @brief Sets the number of bits to @c bit_count, growing if needed.
+ *  Bits added by the resize are clear.
+ *
+ * @retval true If the resize succeeded.
+ * @retval false If growing the storage failed.
+ */
+bool basic_bitvector_resize(basic_bitvector *bitvector, int bit_count);
+
+static inline void basic_bitvector_set(basic_bitvector *bitvector, int index);
+static inline void basic_bitvector_clear(basic_bitvector *bitvector, int index);
+static inline void basic_bitvector_flip(basic_bitvector *bitvector, int index);
+
+static inline bool basic_bitvector_test(
+        basic_bitvector const *bitvector,
+        int index);
+
+/**
+ * @brief Returns the number of set bits in the basic_bitvector.
+ */
+int basic_bitvector_count(basic_bitvector const *bitvector);
+
+/**
+ * @brief Returns the index of the first set bit at or after @c from, or -1
+ *  if there is none.
+ *
+ * @pre @c from must be in [0, bit_count]
+ */
+int basic_bitvector_next(basic_bitvector const *bitvector, int from);
+
+/**
+ * @brief Bulk set operations, computing @c dest = @c dest op @c src.
+ *
+ * @pre @c dest and @c src must be initialised and have equal @c bit_count
+ */
+void basic_bitvector_and(basic_bitvector *dest, basic_bitvector const *src);
+void basic_bitvector_or(basic_bitvector *dest, basic_bitvector const *src);
+void basic_bitvector_xor(basic_bitvector *dest, basic_bitvector const *src);
+
+void basic_bitvector_andnot(
+        basic_bitvector *dest,
+        basic_bitvector const *src);
+
+bool basic_bitvector_isnull(basic_bitvector const *bitvector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    return basic_bitset_isnull(&bitvector->bits) && !bitvector->bit_count;
+}
+
+bool basic_bitvector_isinit(basic_bitvector const *bitvector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    return basic_bitset_isinit(&bitvector->bits)
+        && bitvector->bit_count >= 0
+        && bitvector->bit_count <= bitvector->bits.bit_count;
+}
+
+bool basic_bitvector_isempty(basic_bitvector const *bitvector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    return basic_bitvector_isinit(bitvector) && !bitvector->bit_count;
+}
+
+void basic_bitvector_set(basic_bitvector *bitvector, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(index >= 0 && index < bitvector->bit_count,
+            "index %d out of range", index);
+
+    basic_bitset_set(&bitvector->bits, index);
+}
+
+void basic_bitvector_clear(basic_bitvector *bitvector, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(index >= 0 && index < bitvector->bit_count,
+            "index %d out of range", index);
+
+    basic_bitset_clear(&bitvector->bits, index);
+}
+
+void basic_bitvector_flip(basic_bitvector *bitvector, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(index >= 0 && index < bitvector->bit_count,
+            "index %d out of range", index);
+
+    basic_bitset_flip(&bitvector->bits, index);
+}
+
+bool basic_bitvector_test(basic_bitvector const *bitvector, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(index >= 0 && index < bitvector->bit_count,
+            "index %d out of range", index);
+
+    return basic_bitset_test(&bitvector->bits, index);
+}
+
+#endif // BASIC_BITVECTOR_H_
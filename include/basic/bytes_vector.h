@@ -0,0 +1,160 @@
+/**
+ * @file bytes_vector.h
+ */
+
+#ifndef BASIC_BYTES_VECTOR_H_
+#define BASIC_BYTES_VECTOR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "assertion.h"
+#include "span.h"
+#include "vector.h"
+
+/**
+ * @struct basic_bytes_vector
+ * @brief A vector of byte strings of any length, which may contain NULs.
+ *
+ * Strings are stored back to back in one buffer with no terminators. The
+ * boundaries are kept apart in @c offsets, whose entry @c i is where string
+ * @c i starts and whose entry @c i + 1 is where it ends. Finding a string
+ * and its length is therefore O(1), and strings are handed out as
+ * basic_span views, so hashing, comparing and copying them never scans for
+ * a terminator.
+ *
+ * @var basic_bytes_vector::bytes
+ * @brief The contents of every string, in order.
+ *
+ * @var basic_bytes_vector::offsets
+ * @brief The boundaries of the strings, one more than there are strings.
+ *  The first is always 0 and the last is the size of @c bytes.
+ */
+typedef struct {
+    basic_vector bytes;
+    basic_vector offsets;
+} basic_bytes_vector;
+
+/**
+ * @brief The value representing a basic_bytes_vector in the null state.
+ */
+#define BASIC_BYTES_VECTOR_NULL \
+    ((basic_bytes_vector){BASIC_VECTOR_NULL, BASIC_VECTOR_NULL})
+
+static inline bool basic_bytes_vector_isnull(
+        basic_bytes_vector const *bytes_vector);
+static inline bool basic_bytes_vector_isinit(
+        basic_bytes_vector const *bytes_vector);
+static inline bool basic_bytes_vector_isempty(
+        basic_bytes_vector const *bytes_vector);
+
+basic_bytes_vector basic_bytes_vector_move(basic_bytes_vector *bytes_vector);
+
+basic_bytes_vector basic_bytes_vector_clone(
+        basic_bytes_vector const *bytes_vector);
+
+/**
+ * @brief Creates an empty basic_bytes_vector with room for @c string_cap
+ *  strings holding @c byte_cap bytes in total.
+ *
+ * @returns An initialised basic_bytes_vector, or
+ *  @ref BASIC_BYTES_VECTOR_NULL if an allocation failed.
+ */
+basic_bytes_vector basic_bytes_vector_new(size_t byte_cap, size_t string_cap);
+
+void basic_bytes_vector_destroy(basic_bytes_vector *bytes_vector);
+
+/**
+ * @brief Inserts a copy of the @c string->size bytes at @c string->ptr as
+ *  the string at @c index. The bytes may include NULs, and may be empty, in
+ *  which case @c string->ptr may be NULL. @c string may be a view of this
+ *  vector, as returned by @ref basic_bytes_vector_get.
+ *
+ * @retval true On success.
+ * @retval false If an allocation failed. The vector is unchanged.
+ */
+bool basic_bytes_vector_insert(
+        basic_bytes_vector *bytes_vector,
+        size_t index,
+        basic_span const *string);
+
+void basic_bytes_vector_remove(basic_bytes_vector *bytes_vector, size_t index);
+
+static inline bool basic_bytes_vector_insertback(
+        basic_bytes_vector *bytes_vector,
+        basic_span const *string);
+
+static inline void basic_bytes_vector_removeback(
+        basic_bytes_vector *bytes_vector);
+
+/**
+ * @brief Returns a view of the string at @c index. The view is invalidated
+ *  by the next insertion.
+ */
+basic_span basic_bytes_vector_get(
+        basic_bytes_vector const *bytes_vector,
+        size_t index);
+
+/**
+ * @brief Returns the length of the string at @c index, in bytes.
+ */
+size_t basic_bytes_vector_size(
+        basic_bytes_vector const *bytes_vector,
+        size_t index);
+
+/**
+ * @brief Returns the number of strings.
+ */
+static inline size_t basic_bytes_vector_count(
+        basic_bytes_vector const *bytes_vector);
+
+bool basic_bytes_vector_isnull(basic_bytes_vector const *bytes_vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    return basic_vector_isnull(&bytes_vector->bytes)
+        && basic_vector_isnull(&bytes_vector->offsets);
+}
+
+bool basic_bytes_vector_isinit(basic_bytes_vector const *bytes_vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    return basic_vector_isinit(&bytes_vector->bytes)
+        && basic_vector_isinit(&bytes_vector->offsets)
+        && bytes_vector->offsets.elem_count > 0;
+}
+
+bool basic_bytes_vector_isempty(basic_bytes_vector const *bytes_vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    return basic_bytes_vector_isinit(bytes_vector)
+        && bytes_vector->offsets.elem_count == 1;
+}
+
+bool basic_bytes_vector_insertback(
+        basic_bytes_vector *bytes_vector,
+        basic_span const *string)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    return basic_bytes_vector_insert(bytes_vector,
+            basic_bytes_vector_count(bytes_vector),
+            string);
+}
+
+void basic_bytes_vector_removeback(basic_bytes_vector *bytes_vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    BASIC_ASSERT(!basic_bytes_vector_isempty(bytes_vector),
+            "basic_bytes_vector object must be non-empty");
+    basic_bytes_vector_remove(bytes_vector,
+            basic_bytes_vector_count(bytes_vector) - 1);
+}
+
+size_t basic_bytes_vector_count(basic_bytes_vector const *bytes_vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    BASIC_ASSERT(basic_bytes_vector_isinit(bytes_vector),
+            "basic_bytes_vector object must be initialised");
+    return bytes_vector->offsets.elem_count - 1;
+}
+
+#endif // BASIC_BYTES_VECTOR_H_
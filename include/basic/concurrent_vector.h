@@ -0,0 +1,156 @@
+/**
+ * @file concurrent_vector.h
+ */
+
+#ifndef BASIC_CONCURRENT_VECTOR_H_
+#define BASIC_CONCURRENT_VECTOR_H_
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "assertion.h"
+#include "basic.h"
+
+/**
+ * @brief The maximum number of segments in a basic_concurrent_vector.
+ *
+ * Segment @c k holds @c base_cap << k elements, so this bounds the capacity
+ * well beyond @c INT_MAX for any base capacity.
+ */
+#define BASIC_CONCURRENT_VECTOR_SEGMENTS 32
+
+/**
+ * @struct basic_concurrent_vector
+ * @brief An append-only vector that any number of threads can append to and
+ *  read from concurrently.
+ *
+ * Storage is a table of segments whose sizes double, so an element's
+ * segment and offset follow from its index with one bit scan. Segments are
+ * allocated on first use and never reallocated, so a pointer to an element
+ * stays valid until the basic_concurrent_vector is destroyed.
+ *
+ * Appending makes sure the segments for the next indices exist, reserves
+ * them with a compare-and-swap on @c elem_count, copies the elements into
+ * place and then sets their bits in the owning segment's ready bitmap with
+ * release ordering, one word at a time. Readers check that bit
+ * with acquire ordering, so reads are wait-free and appenders never wait
+ * on each other.
+ *
+ * Each segment is laid out as its ready bitmap followed by its elements.
+ *
+ * @var basic_concurrent_vector::segments
+ * @brief The segment table. Null entries have not been allocated yet.
+ *
+ * @var basic_concurrent_vector::elem_size
+ * @brief The size of each element, in bytes.
+ *
+ * @var basic_concurrent_vector::base_cap
+ * @brief The capacity of the first segment, always a power of two.
+ *
+ * @var basic_concurrent_vector::elem_count
+ * @brief The number of indices reserved so far. Elements below this count
+ *  may still be being written.
+ */
+typedef struct {
+    _Atomic(unsigned char *) segments[BASIC_CONCURRENT_VECTOR_SEGMENTS];
+    size_t elem_size;
+    int base_cap;
+
+    alignas(BASIC_CACHE_LINE_SIZE) atomic_int elem_count;
+} basic_concurrent_vector;
+
+/**
+ * @brief The value representing a basic_concurrent_vector in the null state.
+ */
+#define BASIC_CONCURRENT_VECTOR_NULL ((basic_concurrent_vector){.elem_size = 0})
+
+static inline bool basic_concurrent_vector_isnull(
+        basic_concurrent_vector const *vector);
+static inline bool basic_concurrent_vector_isinit(
+        basic_concurrent_vector const *vector);
+
+/**
+ * @brief Creates an empty basic_concurrent_vector and allocates its first
+ *  segment.
+ *
+ * @param[in] elem_size The size of each element, in bytes.
+ * @param[in] base_cap The capacity of the first segment, rounded up to a
+ *  power of two.
+ *
+ * @returns An initialised basic_concurrent_vector, or
+ *  @ref BASIC_CONCURRENT_VECTOR_NULL if the allocation fails or
+ *  @c base_cap rounds up past @c INT_MAX.
+ */
+basic_concurrent_vector basic_concurrent_vector_new(
+        size_t elem_size,
+        int base_cap);
+
+/**
+ * @brief Frees every segment. No other thread may be using the
+ *  basic_concurrent_vector.
+ */
+void basic_concurrent_vector_destroy(basic_concurrent_vector *vector);
+
+/**
+ * @brief Appends a copy of @c n contiguous elements, which receive
+ *  consecutive indices.
+ *
+ * @returns The index of the first appended element, or -1 if a segment
+ *  could not be allocated or the count would pass @c INT_MAX. In that case
+ *  no index is reserved.
+ */
+int basic_concurrent_vector_append_n(
+        basic_concurrent_vector *vector,
+        void const *elems,
+        int n);
+
+static inline int basic_concurrent_vector_append(
+        basic_concurrent_vector *vector,
+        void const *elem);
+
+/**
+ * @brief Returns the number of indices reserved so far, which is an upper
+ *  bound on the number of readable elements.
+ */
+static inline int basic_concurrent_vector_count(
+        basic_concurrent_vector const *vector);
+
+/**
+ * @brief Returns a pointer to the element at @c index, or @c NULL if that
+ *  element has not been published yet. Wait-free.
+ */
+void *basic_concurrent_vector_at(basic_concurrent_vector *vector, int index);
+void const *basic_concurrent_vector_at_c(
+        basic_concurrent_vector const *vector,
+        int index);
+
+bool basic_concurrent_vector_isnull(basic_concurrent_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return !vector->elem_size && !vector->base_cap;
+}
+
+bool basic_concurrent_vector_isinit(basic_concurrent_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return vector->elem_size
+        && vector->base_cap > 0
+        && !(vector->base_cap & (vector->base_cap - 1));
+}
+
+int basic_concurrent_vector_append(
+        basic_concurrent_vector *vector,
+        void const *elem)
+{
+    return basic_concurrent_vector_append_n(vector, elem, 1);
+}
+
+int basic_concurrent_vector_count(basic_concurrent_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return atomic_load_explicit(&vector->elem_count, memory_order_acquire);
+}
+
+#endif // BASIC_CONCURRENT_VECTOR_H_
@@ -0,0 +1,147 @@
+/**
+ * @file deque.h
+ */
+
+#ifndef BASIC_DEQUE_H_
+#define BASIC_DEQUE_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "assertion.h"
+#include "array.h"
+#include "span.h"
+
+/**
+ * @struct basic_deque
+ * @brief A double-ended queue stored in a power-of-two ring buffer.
+ *
+ * Elements occupy the @c elem_count slots starting at @c head and wrapping
+ * around the end of the basic_array. Because the capacity is a power of
+ * two, wrapping is a mask rather than a division, and pushing or popping
+ * at either end is O(1).
+ *
+ * @var basic_deque::data
+ * @brief The ring buffer.
+ *
+ * @var basic_deque::head
+ * @brief The slot index of the front element.
+ *
+ * @var basic_deque::elem_count
+ * @brief The number of elements in the basic_deque.
+ *
+ * @var basic_deque::elem_cap
+ * @brief The number of slots in the ring buffer, always a power of two.
+ */
+typedef struct {
+    basic_array data;
+    int head;
+    int elem_count;
+    int elem_cap;
+} basic_deque;
+
+/**
+ * @brief The value representing a basic_deque in the null state.
+ */
+#define BASIC_DEQUE_NULL ((basic_deque){BASIC_ARRAY_NULL, 0, 0, 0})
+
+static inline bool basic_deque_isnull(basic_deque const *deque);
+static inline bool basic_deque_isinit(basic_deque const *deque);
+static inline bool basic_deque_isempty(basic_deque const *deque);
+
+basic_deque basic_deque_move(basic_deque *deque);
+basic_deque basic_deque_clone(basic_deque const *deque);
+
+/**
+ * @brief Creates an empty basic_deque.
+ *
+ * @param[in] elem_size The size of each element, in bytes.
+ * @param[in] initial_cap The minimum initial capacity, which is rounded up
+ *  to a power of two.
+ *
+ * @returns An initialised basic_deque, or @ref BASIC_DEQUE_NULL if the
+ *  allocation fails or @c initial_cap rounds up past @c INT_MAX.
+ */
+basic_deque basic_deque_new(size_t elem_size, int initial_cap);
+void basic_deque_destroy(basic_deque *deque);
+
+/**
+ * @brief Copies the element pointed to by @c elem onto the back or front of
+ *  the basic_deque, doubling the ring buffer if it is full.
+ *
+ * @retval true If the element was added.
+ * @retval false If growing the ring buffer failed.
+ */
+bool basic_deque_pushback(basic_deque *deque, void const *elem);
+bool basic_deque_pushfront(basic_deque *deque, void const *elem);
+
+void basic_deque_popback(basic_deque *deque);
+void basic_deque_popfront(basic_deque *deque);
+
+/**
+ * @brief Returns a pointer to the element at logical position @c index,
+ *  counting from the front.
+ */
+void *basic_deque_at(basic_deque *deque, int index);
+void const *basic_deque_at_c(basic_deque const *deque, int index);
+
+static inline void *basic_deque_front(basic_deque *deque);
+static inline void *basic_deque_back(basic_deque *deque);
+
+/**
+ * @brief Describes the contents of the basic_deque as at most two
+ *  contiguous spans, in order.
+ *
+ * @p first covers the elements from the front up to the end of the ring
+ * buffer, and @p second the elements that wrapped around to its start.
+ * Either may be @ref BASIC_SPAN_NULL; both are if the basic_deque is empty.
+ * The spans are invalidated by any push.
+ *
+ * @param[in] deque Pointer to the basic_deque to describe.
+ * @param[out] first Set to the span of the unwrapped elements.
+ * @param[out] second Set to the span of the wrapped elements.
+ */
+void basic_deque_spans(
+        basic_deque *deque,
+        basic_span *first,
+        basic_span *second);
+
+bool basic_deque_isnull(basic_deque const *deque)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    return basic_array_isnull(&deque->data)
+        && !deque->head
+        && !deque->elem_count
+        && !deque->elem_cap;
+}
+
+bool basic_deque_isinit(basic_deque const *deque)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    return basic_array_isinit(&deque->data)
+        && deque->elem_cap > 0
+        && !(deque->elem_cap & (deque->elem_cap - 1))
+        && deque->head >= 0
+        && deque->head < deque->elem_cap
+        && deque->elem_count >= 0
+        && deque->elem_count <= deque->elem_cap;
+}
+
+bool basic_deque_isempty(basic_deque const *deque)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    return basic_deque_isinit(deque) && !deque->elem_count;
+}
+
+void *basic_deque_front(basic_deque *deque)
+{
+    return basic_deque_at(deque, 0);
+}
+
+void *basic_deque_back(basic_deque *deque)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    return basic_deque_at(deque, deque->elem_count - 1);
+}
+
+#endif // BASIC_DEQUE_H_
@@ -0,0 +1,165 @@
+/**
+ * @file frontcoded_strings.h
+ */
+
+#ifndef BASIC_FRONTCODED_STRINGS_H_
+#define BASIC_FRONTCODED_STRINGS_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "array.h"
+#include "assertion.h"
+#include "block.h"
+#include "string_vector.h"
+
+/**
+ * @struct basic_frontcoded_strings
+ * @brief An immutable, compressed copy of a sorted basic_string_vector.
+ *
+ * Sorted strings tend to share long prefixes with their neighbours, so
+ * they are stored in buckets of @c bucket_size strings in which the first
+ * is kept in full and each of the rest as the length of the prefix it
+ * shares with the one before, followed by the remaining suffix. The
+ * lengths are variable-length integers and every string is terminated by a
+ * NUL, so there is no padding.
+ *
+ * The first string of each bucket can be compared directly, so searches
+ * binary search the buckets and then walk the one bucket that can hold the
+ * answer, comparing each string against the key through the shared prefix
+ * lengths without rebuilding it. Searches are O(log n + bucket_size), and
+ * reading a string decodes at most @c bucket_size of them.
+ *
+ * @var basic_frontcoded_strings::data
+ * @brief The encoded buckets, back to back.
+ *
+ * @var basic_frontcoded_strings::buckets
+ * @brief The offset into @c data of each bucket, as size_t.
+ *
+ * @var basic_frontcoded_strings::string_count
+ * @brief The number of strings.
+ *
+ * @var basic_frontcoded_strings::bucket_size
+ * @brief The number of strings in each bucket but the last.
+ */
+typedef struct {
+    basic_block data;
+    basic_array buckets;
+    size_t string_count;
+    size_t bucket_size;
+} basic_frontcoded_strings;
+
+/**
+ * @brief The value representing a basic_frontcoded_strings in the null
+ *  state.
+ */
+#define BASIC_FRONTCODED_STRINGS_NULL \
+    ((basic_frontcoded_strings){BASIC_BLOCK_NULL, BASIC_ARRAY_NULL, 0, 0})
+
+static inline bool basic_frontcoded_strings_isnull(
+        basic_frontcoded_strings const *strings);
+static inline bool basic_frontcoded_strings_isinit(
+        basic_frontcoded_strings const *strings);
+
+/**
+ * @brief Encodes the strings of @c sorted, which must be in strcmp order
+ *  (see @ref basic_string_vector_sort), in buckets of @c bucket_size.
+ *
+ * Larger buckets compress better and search more slowly; 16 is a
+ * reasonable start.
+ *
+ * @returns An initialised basic_frontcoded_strings, or
+ *  @ref BASIC_FRONTCODED_STRINGS_NULL if an allocation failed.
+ */
+basic_frontcoded_strings basic_frontcoded_strings_new(
+        basic_string_vector const *sorted,
+        size_t bucket_size);
+
+void basic_frontcoded_strings_destroy(basic_frontcoded_strings *strings);
+
+/**
+ * @brief Returns the number of strings.
+ */
+static inline size_t basic_frontcoded_strings_count(
+        basic_frontcoded_strings const *strings);
+
+/**
+ * @brief Returns the number of bytes of memory the strings occupy.
+ */
+static inline size_t basic_frontcoded_strings_memory(
+        basic_frontcoded_strings const *strings);
+
+/**
+ * @brief Decodes the string at @c index into @c buf as snprintf would,
+ *  writing at most @c size bytes including the NUL.
+ *
+ * @returns The length of the string, which is at least @c size if it was
+ *  truncated.
+ */
+size_t basic_frontcoded_strings_get(
+        basic_frontcoded_strings const *strings,
+        size_t index,
+        char *buf,
+        size_t size);
+
+/**
+ * @brief Returns the index of the first string that does not compare less
+ *  than @c string, or the string count if there is none.
+ */
+size_t basic_frontcoded_strings_lower_bound(
+        basic_frontcoded_strings const *strings,
+        char const *string);
+
+/**
+ * @brief Looks up @c string, storing its index in @c *index if it is
+ *  present.
+ *
+ * @retval true If @c string is present.
+ * @retval false If it is not, in which case @c *index is unchanged.
+ */
+bool basic_frontcoded_strings_find(
+        basic_frontcoded_strings const *strings,
+        char const *string,
+        size_t *index);
+
+/**
+ * @brief Finds the strings that start with @c prefix, which are
+ *  consecutive.
+ *
+ * @returns The number of such strings. The first of them is at @c *first,
+ *  which is set even if there are none.
+ */
+size_t basic_frontcoded_strings_prefix_range(
+        basic_frontcoded_strings const *strings,
+        char const *prefix,
+        size_t *first);
+
+bool basic_frontcoded_strings_isnull(basic_frontcoded_strings const *strings)
+{
+    BASIC_ASSERT_PTR_NONNULL(strings);
+    return basic_block_isnull(&strings->data)
+        && basic_array_isnull(&strings->buckets)
+        && !strings->string_count;
+}
+
+bool basic_frontcoded_strings_isinit(basic_frontcoded_strings const *strings)
+{
+    BASIC_ASSERT_PTR_NONNULL(strings);
+    return basic_block_isinit(&strings->data)
+        && basic_array_isinit(&strings->buckets)
+        && strings->bucket_size;
+}
+
+size_t basic_frontcoded_strings_count(basic_frontcoded_strings const *strings)
+{
+    BASIC_ASSERT_PTR_NONNULL(strings);
+    return strings->string_count;
+}
+
+size_t basic_frontcoded_strings_memory(basic_frontcoded_strings const *strings)
+{
+    BASIC_ASSERT_PTR_NONNULL(strings);
+    return strings->data.size + strings->buckets.data.size;
+}
+
+#endif // BASIC_FRONTCODED_STRINGS_H_
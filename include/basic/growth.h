@@ -0,0 +1,88 @@
+/**
+ * @file growth.h
+ */
+
+#ifndef BASIC_GROWTH_H_
+#define BASIC_GROWTH_H_
+
+#include <stddef.h>
+
+/**
+ * @brief The strategies a growable container may use to pick its next
+ *  capacity.
+ *
+ * - @c basic_growth_double multiplies the capacity by two.
+ * - @c basic_growth_one_and_half multiplies the capacity by 1.5, which
+ *  wastes less memory at the cost of more frequent reallocation.
+ * - @c basic_growth_fixed adds a fixed number of elements.
+ * - @c basic_growth_page and @c basic_growth_hugepage grow the allocation
+ *  to the next whole 4 KiB or 2 MiB boundary that fits the request. Large
+ *  allocations are typically mmap-backed, and realloc can extend them with
+ *  mremap rather than copying, so linear growth in whole pages keeps the
+ *  resident size close to the live size.
+ */
+typedef enum {
+    basic_growth_double,
+    basic_growth_one_and_half,
+    basic_growth_fixed,
+    basic_growth_page,
+    basic_growth_hugepage
+} basic_growth_kind;
+
+/**
+ * @struct basic_growth_policy
+ * @brief Describes how a container grows when it runs out of capacity.
+ *
+ * A zero-initialised basic_growth_policy is @ref BASIC_GROWTH_DOUBLE.
+ *
+ * @var basic_growth_policy::kind
+ * @brief The growth strategy.
+ *
+ * @var basic_growth_policy::increment
+ * @brief The number of elements added per step by @c basic_growth_fixed.
+ *  Unused by the other strategies.
+ */
+typedef struct {
+    basic_growth_kind kind;
+    size_t increment;
+} basic_growth_policy;
+
+#define BASIC_GROWTH_DOUBLE \
+    ((basic_growth_policy){basic_growth_double, 0})
+
+#define BASIC_GROWTH_ONE_AND_HALF \
+    ((basic_growth_policy){basic_growth_one_and_half, 0})
+
+#define BASIC_GROWTH_FIXED(n) \
+    ((basic_growth_policy){basic_growth_fixed, (n)})
+
+#define BASIC_GROWTH_PAGE \
+    ((basic_growth_policy){basic_growth_page, 0})
+
+#define BASIC_GROWTH_HUGEPAGE \
+    ((basic_growth_policy){basic_growth_hugepage, 0})
+
+/**
+ * @brief Returns the capacity a container with capacity @c cap should grow
+ *  to in order to hold at least @c min_cap elements of @c elem_size bytes.
+ *
+ * @param[in] policy Pointer to the growth policy to apply.
+ * @param[in] cap The current capacity, in elements.
+ * @param[in] min_cap The minimum capacity required, in elements.
+ * @param[in] elem_size The size of each element, in bytes.
+ *
+ * @pre @c policy must be non-NULL, and its increment must be positive if
+ *  its kind is @c basic_growth_fixed
+ * @pre @c cap must be positive and @c elem_size nonzero
+ *
+ * @returns A capacity no less than @c min_cap whose size in bytes fits in a
+ *  @c size_t, or 0 if @c min_cap elements would not fit. Steps that would
+ *  overflow are clamped to the largest capacity that fits.
+ */
+size_t basic_growth_next_cap(
+        basic_growth_policy const *policy,
+        size_t cap,
+        size_t min_cap,
+        size_t elem_size);
+
+#endif // BASIC_GROWTH_H_
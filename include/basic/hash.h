@@ -0,0 +1,63 @@
+/**
+ * @file hash.h
+ */
+
+#ifndef BASIC_HASH_H_
+#define BASIC_HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "assertion.h"
+#include "span.h"
+
+/**
+ * @brief The type of a hash function over the bytes of a key.
+ */
+typedef uint64_t (*basic_hash_fn)(basic_span const *key);
+
+/**
+ * @brief Hashes @c size bytes starting at @c data.
+ *
+ * This is MurmurHash64A. It reads eight bytes per step and finishes with a
+ * full avalanche, so every output bit depends on every input bit and both
+ * the high and low bits of the result can be used to index tables.
+ *
+ * @param[in] data Pointer to the bytes to hash. May be @c NULL if @c size
+ *  is zero.
+ * @param[in] size The number of bytes to hash.
+ * @param[in] seed A value mixed into the initial state.
+ *
+ * @returns The 64-bit hash.
+ */
+uint64_t basic_hash_bytes(void const *data, size_t size, uint64_t seed);
+
+/**
+ * @brief Hashes the memory area represented by the basic_span pointed to by
+ *  @c span. Suitable as a @ref basic_hash_fn.
+ */
+static inline uint64_t basic_hash_span(basic_span const *span);
+
+/**
+ * @brief Mixes the bits of @c value with the SplitMix64 finaliser. A cheap
+ *  hash for integer keys.
+ */
+static inline uint64_t basic_hash_u64(uint64_t value);
+
+uint64_t basic_hash_span(basic_span const *span)
+{
+    BASIC_ASSERT_PTR_NONNULL(span);
+    return basic_hash_bytes(span->ptr, span->size, 0);
+}
+
+uint64_t basic_hash_u64(uint64_t value)
+{
+    value ^= value >> 30;
+    value *= UINT64_C(0xbf58476d1ce4e5b9);
+    value ^= value >> 27;
+    value *= UINT64_C(0x94d049bb133111eb);
+    value ^= value >> 31;
+    return value;
+}
+
+#endif // BASIC_HASH_H_
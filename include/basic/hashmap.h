@@ -0,0 +1,221 @@
+/**
+ * @file hashmap.h
+ */
+
+#ifndef BASIC_HASHMAP_H_
+#define BASIC_HASHMAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "assertion.h"
+#include "array.h"
+#include "hash.h"
+
+/**
+ * @struct basic_hashmap
+ * @brief An open-addressing hash map from fixed-size keys to fixed-size
+ *  values.
+ *
+ * Each slot has a control byte that is either empty (high bit set) or
+ * holds the low seven bits of its key's hash. Lookups probe linearly from
+ * the slot given by the remaining hash bits, comparing sixteen control
+ * bytes at a time with SSE2 where available. Only slots whose control byte
+ * matches have their keys compared, and a lookup stops at the first group
+ * that contains an empty slot. The first sixteen control bytes are
+ * mirrored past the end so that a group can be loaded at any slot without
+ * wrapping.
+ *
+ * Erasing uses backward-shift deletion. Later entries of the same probe
+ * run move back into the gap, so there are no tombstones and probe
+ * lengths do not degrade under churn. The table is kept at most 7/8 full.
+ *
+ * Keys are compared bytewise, so they must not contain padding with
+ * indeterminate contents.
+ *
+ * @var basic_hashmap::ctrl
+ * @brief The control bytes, @c slot_cap plus a mirrored group.
+ *
+ * @var basic_hashmap::slots
+ * @brief The slots, each a key followed by its value.
+ *
+ * @var basic_hashmap::key_size
+ * @brief The size of each key, in bytes.
+ *
+ * @var basic_hashmap::value_size
+ * @brief The size of each value, in bytes.
+ *
+ * @var basic_hashmap::value_offset
+ * @brief The offset of the value within a slot, aligned for the value.
+ *
+ * @var basic_hashmap::hash
+ * @brief The hash function applied to keys.
+ *
+ * @var basic_hashmap::elem_count
+ * @brief The number of entries.
+ *
+ * @var basic_hashmap::slot_cap
+ * @brief The number of slots, a power of two no smaller than a group.
+ */
+typedef struct {
+    basic_array ctrl;
+    basic_array slots;
+    size_t key_size;
+    size_t value_size;
+    size_t value_offset;
+    basic_hash_fn hash;
+    int elem_count;
+    int slot_cap;
+} basic_hashmap;
+
+/**
+ * @brief The value representing a basic_hashmap in the null state.
+ */
+#define BASIC_HASHMAP_NULL \
+    ((basic_hashmap){BASIC_ARRAY_NULL, BASIC_ARRAY_NULL, 0, 0, 0, NULL, 0, 0})
+
+static inline bool basic_hashmap_isnull(basic_hashmap const *map);
+static inline bool basic_hashmap_isinit(basic_hashmap const *map);
+static inline bool basic_hashmap_isempty(basic_hashmap const *map);
+
+basic_hashmap basic_hashmap_move(basic_hashmap *map);
+basic_hashmap basic_hashmap_clone(basic_hashmap const *map);
+
+/**
+ * @brief Creates an empty basic_hashmap.
+ *
+ * @param[in] key_size The size of each key, in bytes.
+ * @param[in] value_size The size of each value, in bytes. May be zero for a
+ *  set.
+ * @param[in] hash The hash function, or @c NULL for @ref basic_hash_span.
+ * @param[in] initial_cap The number of entries to make room for.
+ *
+ * @returns An initialised basic_hashmap, or @ref BASIC_HASHMAP_NULL if the
+ *  allocation fails.
+ */
+basic_hashmap basic_hashmap_new(
+        size_t key_size,
+        size_t value_size,
+        basic_hash_fn hash,
+        int initial_cap);
+void basic_hashmap_destroy(basic_hashmap *map);
+
+/**
+ * @brief Returns a pointer to the value stored for @c key, or @c NULL if
+ *  there is none.
+ */
+void *basic_hashmap_find(basic_hashmap *map, void const *key);
+void const *basic_hashmap_find_c(basic_hashmap const *map, void const *key);
+
+static inline bool basic_hashmap_contains(
+        basic_hashmap const *map,
+        void const *key);
+
+/**
+ * @brief Returns a pointer to the value slot for @c key, adding an entry
+ *  with an uninitialised value if there is none.
+ *
+ * @param[in] map Pointer to the basic_hashmap.
+ * @param[in] key Pointer to the key.
+ * @param[out] inserted If not @c NULL, set to whether an entry was added.
+ *
+ * @returns A pointer to the value, or @c NULL if the table had to grow and
+ *  could not.
+ */
+void *basic_hashmap_emplace(
+        basic_hashmap *map,
+        void const *key,
+        bool *inserted);
+
+/**
+ * @brief Sets the value for @c key, adding an entry if there is none.
+ *
+ * @retval true On success.
+ * @retval false If the table had to grow and could not.
+ */
+bool basic_hashmap_insert(
+        basic_hashmap *map,
+        void const *key,
+        void const *value);
+
+/**
+ * @brief Removes the entry for @c key, if any.
+ *
+ * @returns Whether an entry was removed.
+ */
+bool basic_hashmap_erase(basic_hashmap *map, void const *key);
+
+void basic_hashmap_clear(basic_hashmap *map);
+
+/**
+ * @brief Grows the table so that @c elem_count entries fit without
+ *  rehashing.
+ *
+ * @retval true On success, including when no growth was needed.
+ * @retval false If the allocation failed. The basic_hashmap is unchanged.
+ */
+bool basic_hashmap_reserve(basic_hashmap *map, int elem_count);
+
+/**
+ * @brief Rebuilds the table with at least @c slot_cap slots, or as few as
+ *  the current entries allow if @c slot_cap is smaller. Passing 0 shrinks
+ *  the table to fit.
+ *
+ * @retval true On success.
+ * @retval false If the allocation failed. The basic_hashmap is unchanged.
+ */
+bool basic_hashmap_rehash(basic_hashmap *map, int slot_cap);
+
+/**
+ * @brief Returns the index of the first occupied slot at or after @c from,
+ *  or -1 if there is none.
+ *
+ * Iterate with
+ * @code
+ * for (int i = basic_hashmap_next(map, 0); i != -1;
+ *         i = basic_hashmap_next(map, i + 1))
+ * @endcode
+ * Any insertion or erasure invalidates slot indices.
+ */
+int basic_hashmap_next(basic_hashmap const *map, int from);
+
+void const *basic_hashmap_key_at(basic_hashmap const *map, int slot);
+void *basic_hashmap_value_at(basic_hashmap *map, int slot);
+
+bool basic_hashmap_isnull(basic_hashmap const *map)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    return basic_array_isnull(&map->ctrl)
+        && basic_array_isnull(&map->slots)
+        && !map->key_size
+        && !map->hash
+        && !map->elem_count
+        && !map->slot_cap;
+}
+
+bool basic_hashmap_isinit(basic_hashmap const *map)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    return basic_array_isinit(&map->ctrl)
+        && basic_array_isinit(&map->slots)
+        && map->key_size
+        && map->hash
+        && map->elem_count >= 0
+        && map->slot_cap > 0
+        && !(map->slot_cap & (map->slot_cap - 1))
+        && map->elem_count < map->slot_cap;
+}
+
+bool basic_hashmap_isempty(basic_hashmap const *map)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    return basic_hashmap_isinit(map) && !map->elem_count;
+}
+
+bool basic_hashmap_contains(basic_hashmap const *map, void const *key)
+{
+    return basic_hashmap_find_c(map, key) != NULL;
+}
+
+#endif // BASIC_HASHMAP_H_
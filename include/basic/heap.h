@@ -0,0 +1,218 @@
+/**
+ * @file heap.h
+ */
+
+#ifndef BASIC_HEAP_H_
+#define BASIC_HEAP_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "assertion.h"
+#include "block.h"
+#include "vector.h"
+
+/**
+ * @brief The type of a heap comparator.
+ *
+ * @returns A negative value if @c lhs should come out of the heap before
+ *  @c rhs, and zero or a positive value otherwise.
+ */
+typedef int (*basic_heap_cmp)(void const *lhs, void const *rhs, void *ctx);
+
+/**
+ * @struct basic_heap_order
+ * @brief How a basic_heap orders its elements, and its arity.
+ *
+ * If @c cmp is @c NULL, elements are ordered by the @c uint64_t key at
+ * @c key_offset bytes into each element, smallest first, which suits
+ * deadlines and sequence numbers without an indirect call per comparison.
+ *
+ * @var basic_heap_order::cmp
+ * @brief The comparator, or @c NULL to order by key.
+ *
+ * @var basic_heap_order::ctx
+ * @brief Passed through to @c cmp.
+ *
+ * @var basic_heap_order::key_offset
+ * @brief The offset of the @c uint64_t key, used when @c cmp is @c NULL.
+ *
+ * @var basic_heap_order::arity
+ * @brief The number of children per node, at least 2.
+ */
+typedef struct {
+    basic_heap_cmp cmp;
+    void *ctx;
+    size_t key_offset;
+    int arity;
+} basic_heap_order;
+
+/**
+ * @brief The default arity. Four children per node make the heap half as
+ *  deep as a binary heap, and the children of a node share a cache line
+ *  for small elements.
+ */
+#define BASIC_HEAP_ARITY 4
+
+#define BASIC_HEAP_BY_CMP(cmp, ctx) \
+    ((basic_heap_order){(cmp), (ctx), 0, BASIC_HEAP_ARITY})
+#define BASIC_HEAP_BY_KEY(key_offset) \
+    ((basic_heap_order){NULL, NULL, (key_offset), BASIC_HEAP_ARITY})
+
+/**
+ * @struct basic_heap
+ * @brief A d-ary min-heap priority queue on a basic_vector.
+ *
+ * Each element pushed gets a handle that follows it as it moves, so it can
+ * later be updated or erased in O(log n) without a search. Handles of
+ * popped or erased elements are reused.
+ *
+ * @var basic_heap::elems
+ * @brief The elements in heap order.
+ *
+ * @var basic_heap::handle_of
+ * @brief The handle of the element at each position, as @c int.
+ *
+ * @var basic_heap::index_of
+ * @brief The position of the element for each handle, as @c int. A free
+ *  handle instead holds @c -2 minus the next free handle.
+ *
+ * @var basic_heap::scratch
+ * @brief One element of scratch space for sifting.
+ *
+ * @var basic_heap::order
+ * @brief The ordering and arity.
+ *
+ * @var basic_heap::free_handle
+ * @brief The first free handle, or -1 if there is none.
+ */
+typedef struct {
+    basic_vector elems;
+    basic_vector handle_of;
+    basic_vector index_of;
+    basic_block scratch;
+    basic_heap_order order;
+    int free_handle;
+} basic_heap;
+
+/**
+ * @brief The value representing a basic_heap in the null state.
+ */
+#define BASIC_HEAP_NULL ((basic_heap){ \
+    BASIC_VECTOR_NULL, \
+    BASIC_VECTOR_NULL, \
+    BASIC_VECTOR_NULL, \
+    BASIC_BLOCK_NULL, \
+    {NULL, NULL, 0, 0}, \
+    0})
+
+static inline bool basic_heap_isnull(basic_heap const *heap);
+static inline bool basic_heap_isinit(basic_heap const *heap);
+static inline bool basic_heap_isempty(basic_heap const *heap);
+
+basic_heap basic_heap_move(basic_heap *heap);
+basic_heap basic_heap_clone(basic_heap const *heap);
+
+/**
+ * @brief Creates an empty basic_heap.
+ *
+ * @param[in] elem_size The size of each element, in bytes.
+ * @param[in] initial_cap The initial capacity.
+ * @param[in] order The ordering, e.g. @ref BASIC_HEAP_BY_KEY.
+ *
+ * @returns An initialised basic_heap, or @ref BASIC_HEAP_NULL if an
+ *  allocation fails.
+ */
+basic_heap basic_heap_new(
+        size_t elem_size,
+        int initial_cap,
+        basic_heap_order order);
+
+/**
+ * @brief Creates a basic_heap from the elements of an existing basic_vector
+ *  in O(n), taking ownership of the basic_vector.
+ *
+ * The element at index @c i of the basic_vector gets handle @c i.
+ *
+ * @returns An initialised basic_heap, or @ref BASIC_HEAP_NULL if an
+ *  allocation fails, in which case @c vector is left unchanged.
+ */
+basic_heap basic_heap_from_vector(
+        basic_vector *vector,
+        basic_heap_order order);
+
+void basic_heap_destroy(basic_heap *heap);
+
+/**
+ * @brief Copies the element pointed to by @c elem into the basic_heap.
+ *
+ * @returns The new element's handle, or -1 if an allocation failed.
+ */
+int basic_heap_push(basic_heap *heap, void const *elem);
+
+/**
+ * @brief Removes the first element, copying it to @c out unless @c out is
+ *  @c NULL. Its handle becomes free.
+ */
+void basic_heap_pop(basic_heap *heap, void *out);
+
+/**
+ * @brief Returns a pointer to the first element. The element must not be
+ *  modified in a way that changes its order; use
+ *  @ref basic_heap_replace_top instead.
+ */
+void const *basic_heap_top(basic_heap const *heap);
+int basic_heap_top_handle(basic_heap const *heap);
+
+/**
+ * @brief Replaces the first element with a copy of @c elem and restores the
+ *  heap order with a single sift, which is cheaper than a pop followed by a
+ *  push. The top handle now refers to the new element.
+ */
+void basic_heap_replace_top(basic_heap *heap, void const *elem);
+
+/**
+ * @brief Replaces the element with handle @c handle by a copy of @c elem and
+ *  moves it up or down to its place. Decrease-key is the common case.
+ */
+void basic_heap_update(basic_heap *heap, int handle, void const *elem);
+
+/**
+ * @brief Removes the element with handle @c handle. The handle becomes
+ *  free.
+ */
+void basic_heap_erase(basic_heap *heap, int handle);
+
+/**
+ * @brief Returns a pointer to the element with handle @c handle.
+ */
+void const *basic_heap_at_handle(basic_heap const *heap, int handle);
+
+bool basic_heap_isnull(basic_heap const *heap)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    return basic_vector_isnull(&heap->elems)
+        && basic_vector_isnull(&heap->handle_of)
+        && basic_vector_isnull(&heap->index_of)
+        && basic_block_isnull(&heap->scratch)
+        && !heap->order.arity;
+}
+
+bool basic_heap_isinit(basic_heap const *heap)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    return basic_vector_isinit(&heap->elems)
+        && basic_vector_isinit(&heap->handle_of)
+        && basic_vector_isinit(&heap->index_of)
+        && basic_block_isinit(&heap->scratch)
+        && heap->order.arity >= 2
+        && heap->handle_of.elem_count == heap->elems.elem_count;
+}
+
+bool basic_heap_isempty(basic_heap const *heap)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    return basic_heap_isinit(heap) && !heap->elems.elem_count;
+}
+
+#endif // BASIC_HEAP_H_
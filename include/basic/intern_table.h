@@ -0,0 +1,145 @@
+/**
+ * @file intern_table.h
+ */
+
+#ifndef BASIC_INTERN_TABLE_H_
+#define BASIC_INTERN_TABLE_H_
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "assertion.h"
+#include "basic.h"
+#include "concurrent_vector.h"
+#include "span.h"
+
+typedef struct basic_intern_index basic_intern_index;
+typedef struct basic_intern_block basic_intern_block;
+
+/**
+ * @struct basic_intern_table
+ * @brief Stores each distinct string once and names it by a dense integer
+ *  id, so that repeated strings cost one id each and compare as integers.
+ *
+ * The bytes of each string are copied once into large blocks that are
+ * never moved, with a terminating NUL. @c strings maps each id to a
+ * basic_span of those bytes, and @c index is an open-addressing hash table
+ * from strings to ids whose slots hold the id and 32 bits of the hash.
+ *
+ * Looking up a string and looking up an id are lock-free and may run on any
+ * number of threads alongside interning. Interning a new string takes a
+ * writer lock; interning one already present does not. When the index
+ * grows, the new table is published atomically and the old one is kept
+ * until the basic_intern_table is destroyed, so readers still probing it
+ * are unaffected. The old tables together are never larger than the
+ * current one.
+ *
+ * A basic_intern_table must be created before any thread starts using it
+ * and must not be moved or copied afterwards.
+ *
+ * @var basic_intern_table::strings
+ * @brief The string for each id.
+ *
+ * @var basic_intern_table::index
+ * @brief The current hash index.
+ *
+ * @var basic_intern_table::blocks
+ * @brief The block strings are being copied into, which links to the
+ *  earlier ones.
+ *
+ * @var basic_intern_table::index_count
+ * @brief The number of strings in the index.
+ *
+ * @var basic_intern_table::write_lock
+ * @brief Serialises interning of new strings.
+ */
+typedef struct {
+    basic_concurrent_vector strings;
+    _Atomic(basic_intern_index *) index;
+    basic_intern_block *blocks;
+    int index_count;
+
+    alignas(BASIC_CACHE_LINE_SIZE) atomic_flag write_lock;
+} basic_intern_table;
+
+/**
+ * @brief The value representing a basic_intern_table in the null state.
+ */
+#define BASIC_INTERN_TABLE_NULL \
+    ((basic_intern_table){.strings = BASIC_CONCURRENT_VECTOR_NULL})
+
+static inline bool basic_intern_table_isnull(basic_intern_table const *table);
+static inline bool basic_intern_table_isinit(basic_intern_table const *table);
+
+/**
+ * @brief Creates an empty basic_intern_table with room for @c initial_cap
+ *  strings before its index first grows.
+ *
+ * @returns An initialised basic_intern_table, or
+ *  @ref BASIC_INTERN_TABLE_NULL if an allocation failed.
+ */
+basic_intern_table basic_intern_table_new(int initial_cap);
+
+/**
+ * @brief Frees every string and index. No other thread may be using the
+ *  basic_intern_table.
+ */
+void basic_intern_table_destroy(basic_intern_table *table);
+
+/**
+ * @brief Returns the id of @c string, storing a copy of it first if it is
+ *  not yet in the table. The string may contain NULs.
+ *
+ * Ids are handed out from 0 in the order strings are first interned, and
+ * are never reused.
+ *
+ * @returns The id, or -1 if an allocation failed.
+ */
+int basic_intern_table_intern(
+        basic_intern_table *table,
+        basic_span const *string);
+
+/**
+ * @brief Returns the id of @c string, or -1 if it has not been interned.
+ *  Lock-free.
+ */
+int basic_intern_table_find(
+        basic_intern_table const *table,
+        basic_span const *string);
+
+/**
+ * @brief Returns the string with id @c id. Its bytes are followed by a NUL
+ *  and stay valid until the table is destroyed. Wait-free.
+ */
+basic_span basic_intern_table_get(basic_intern_table const *table, int id);
+
+/**
+ * @brief Returns the number of ids handed out so far.
+ */
+static inline int basic_intern_table_count(basic_intern_table const *table);
+
+bool basic_intern_table_isnull(basic_intern_table const *table)
+{
+    BASIC_ASSERT_PTR_NONNULL(table);
+    return basic_concurrent_vector_isnull(&table->strings)
+        && !atomic_load_explicit(&table->index, memory_order_relaxed);
+}
+
+bool basic_intern_table_isinit(basic_intern_table const *table)
+{
+    BASIC_ASSERT_PTR_NONNULL(table);
+    return basic_concurrent_vector_isinit(&table->strings)
+        && atomic_load_explicit(&table->index, memory_order_relaxed);
+}
+
+int basic_intern_table_count(basic_intern_table const *table)
+{
+    BASIC_ASSERT_PTR_NONNULL(table);
+    BASIC_ASSERT(basic_intern_table_isinit(table),
+            "basic_intern_table object must be initialised");
+    return basic_concurrent_vector_count(&table->strings);
+}
+
+#endif // BASIC_INTERN_TABLE_H_
@@ -0,0 +1,254 @@
+/**
+ * @file mapped_vector.h
+ */
+
+#ifndef BASIC_MAPPED_VECTOR_H_
+#define BASIC_MAPPED_VECTOR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "assertion.h"
+#include "growth.h"
+
+/**
+ * @brief Identifies a file as holding a basic_mapped_vector.
+ */
+#define BASIC_MAPPED_VECTOR_MAGIC UINT64_C(0x726f746365766362)
+
+/**
+ * @brief The file format version written by this library. Files with any
+ *  other version are rejected.
+ */
+#define BASIC_MAPPED_VECTOR_VERSION 1
+
+/**
+ * @brief The offset of the first element in the file. The header is padded
+ *  to a cache line so that the elements are aligned for any type.
+ */
+#define BASIC_MAPPED_VECTOR_DATA_OFFSET 64
+
+/**
+ * @struct basic_mapped_vector_header
+ * @brief The header at the start of a basic_mapped_vector file.
+ *
+ * Fields are stored in native byte order, so files are only portable
+ * between machines with the same endianness.
+ *
+ * @var basic_mapped_vector_header::magic
+ * @brief Always @ref BASIC_MAPPED_VECTOR_MAGIC.
+ *
+ * @var basic_mapped_vector_header::version
+ * @brief The file format version.
+ *
+ * @var basic_mapped_vector_header::data_offset
+ * @brief The offset of the first element, in bytes.
+ *
+ * @var basic_mapped_vector_header::elem_size
+ * @brief The size of each element, in bytes.
+ *
+ * @var basic_mapped_vector_header::elem_count
+ * @brief The number of elements.
+ *
+ * @var basic_mapped_vector_header::checksum
+ * @brief A hash of the fields above, updated when the vector is flushed or
+ *  closed.
+ */
+typedef struct {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t data_offset;
+    uint64_t elem_size;
+    uint64_t elem_count;
+    uint64_t checksum;
+} basic_mapped_vector_header;
+
+/**
+ * @struct basic_mapped_vector
+ * @brief A vector of fixed-size elements stored in a memory-mapped file.
+ *
+ * The file holds a @ref basic_mapped_vector_header followed by the elements
+ * at @ref BASIC_MAPPED_VECTOR_DATA_OFFSET, and the whole file is mapped
+ * shared. Elements are read and written in place, so reopening a file only
+ * maps it and checks the header, however many elements it holds. The
+ * elements must therefore be plain data, free of pointers.
+ *
+ * Growing extends the file with @c ftruncate and remaps it, moving the
+ * mapping only if it cannot be extended in place. Pointers into the vector
+ * are invalidated by growth, as with basic_vector.
+ *
+ * Every change reaches the file through the page cache even if the process
+ * exits without closing the vector, but only @ref basic_mapped_vector_flush
+ * waits for it to reach the disk. The header checksum is brought up to
+ * date by flushing and closing. It covers the header alone, so reopening
+ * rejects a file whose element count changed after the last flush or
+ * close, but not one in which only elements were overwritten in place.
+ *
+ * @var basic_mapped_vector::header
+ * @brief The start of the mapping.
+ *
+ * @var basic_mapped_vector::map_size
+ * @brief The size of the mapping and the file, in bytes.
+ *
+ * @var basic_mapped_vector::elem_cap
+ * @brief The number of elements the file has room for.
+ *
+ * @var basic_mapped_vector::growth
+ * @brief The policy used to pick the next capacity.
+ *
+ * @var basic_mapped_vector::fd
+ * @brief The open file.
+ */
+typedef struct {
+    basic_mapped_vector_header *header;
+    size_t map_size;
+    size_t elem_cap;
+    basic_growth_policy growth;
+    int fd;
+} basic_mapped_vector;
+
+/**
+ * @brief The value representing a basic_mapped_vector in the null state.
+ */
+#define BASIC_MAPPED_VECTOR_NULL \
+    ((basic_mapped_vector){NULL, 0, 0, BASIC_GROWTH_DOUBLE, -1})
+
+static inline bool basic_mapped_vector_isnull(
+        basic_mapped_vector const *vector);
+static inline bool basic_mapped_vector_isinit(
+        basic_mapped_vector const *vector);
+static inline bool basic_mapped_vector_isempty(
+        basic_mapped_vector const *vector);
+
+/**
+ * @brief Opens the basic_mapped_vector stored at @c path, creating an empty
+ *  one with room for @c initial_cap elements if the file does not exist or
+ *  is empty.
+ *
+ * @returns An initialised basic_mapped_vector, or
+ *  @ref BASIC_MAPPED_VECTOR_NULL if the file could not be opened, created or
+ *  mapped, or if its header is corrupt, stale, of another version or for
+ *  another element size.
+ */
+basic_mapped_vector basic_mapped_vector_open(
+        char const *path,
+        size_t elem_size,
+        size_t initial_cap);
+
+/**
+ * @brief Brings the header checksum up to date, then unmaps and closes the
+ *  file.
+ */
+void basic_mapped_vector_close(basic_mapped_vector *vector);
+
+/**
+ * @brief Brings the header checksum up to date and waits for the file to
+ *  reach the disk.
+ *
+ * @retval true On success.
+ * @retval false If @c msync failed.
+ */
+bool basic_mapped_vector_flush(basic_mapped_vector *vector);
+
+void basic_mapped_vector_set_growth(
+        basic_mapped_vector *vector,
+        basic_growth_policy growth);
+
+/**
+ * @brief Grows the file so that it has room for at least @c elem_cap
+ *  elements.
+ *
+ * @retval true On success.
+ * @retval false If the file could not be extended or remapped. The vector
+ *  is unchanged.
+ */
+bool basic_mapped_vector_reserve(basic_mapped_vector *vector, size_t elem_cap);
+
+/**
+ * @brief Appends copies of the @c count elements at @c src, growing the
+ *  file at most once.
+ *
+ * @retval true On success.
+ * @retval false If the file could not grow. The vector is unchanged.
+ */
+bool basic_mapped_vector_append(
+        basic_mapped_vector *vector,
+        void const *src,
+        size_t count);
+
+static inline bool basic_mapped_vector_insertback(
+        basic_mapped_vector *vector,
+        void const *elem);
+
+void basic_mapped_vector_removeback(basic_mapped_vector *vector);
+
+void *basic_mapped_vector_at(basic_mapped_vector *vector, size_t index);
+
+static inline size_t basic_mapped_vector_count(
+        basic_mapped_vector const *vector);
+
+static inline size_t basic_mapped_vector_elem_size(
+        basic_mapped_vector const *vector);
+
+/**
+ * @brief Returns a pointer to the first element.
+ */
+static inline void *basic_mapped_vector_data(basic_mapped_vector *vector);
+
+bool basic_mapped_vector_isnull(basic_mapped_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return !vector->header
+        && !vector->map_size
+        && !vector->elem_cap
+        && vector->fd < 0;
+}
+
+bool basic_mapped_vector_isinit(basic_mapped_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return vector->header
+        && vector->elem_cap > 0
+        && vector->elem_cap >= vector->header->elem_count
+        && vector->fd >= 0;
+}
+
+bool basic_mapped_vector_isempty(basic_mapped_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return basic_mapped_vector_isinit(vector) && !vector->header->elem_count;
+}
+
+bool basic_mapped_vector_insertback(
+        basic_mapped_vector *vector,
+        void const *elem)
+{
+    return basic_mapped_vector_append(vector, elem, 1);
+}
+
+size_t basic_mapped_vector_count(basic_mapped_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_mapped_vector_isinit(vector),
+            "basic_mapped_vector object must be initialised");
+    return (size_t)vector->header->elem_count;
+}
+
+size_t basic_mapped_vector_elem_size(basic_mapped_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_mapped_vector_isinit(vector),
+            "basic_mapped_vector object must be initialised");
+    return (size_t)vector->header->elem_size;
+}
+
+void *basic_mapped_vector_data(basic_mapped_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_mapped_vector_isinit(vector),
+            "basic_mapped_vector object must be initialised");
+    return (unsigned char *)vector->header + BASIC_MAPPED_VECTOR_DATA_OFFSET;
+}
+
+#endif // BASIC_MAPPED_VECTOR_H_
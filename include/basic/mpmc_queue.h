@@ -0,0 +1,167 @@
+/**
+ * @file mpmc_queue.h
+ */
+
+#ifndef BASIC_MPMC_QUEUE_H_
+#define BASIC_MPMC_QUEUE_H_
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "assertion.h"
+#include "array.h"
+#include "basic.h"
+
+/**
+ * @struct basic_mpmc_queue
+ * @brief A bounded, lock-free queue for any number of producer and consumer
+ *  threads.
+ *
+ * Each slot of the power-of-two ring holds a sequence number followed by
+ * one element. A slot whose sequence equals a producer's position is free
+ * for that producer, and one whose sequence equals a consumer's position
+ * plus one holds an element for that consumer. Producers and consumers
+ * claim positions with a compare-and-swap on @c enqueue_pos or
+ * @c dequeue_pos, copy the element, and then publish the slot by storing
+ * its next sequence number with release ordering. Producers and consumers
+ * therefore only contend on their own counter, and never on the same slot.
+ *
+ * A basic_mpmc_queue must be created before any thread starts using it and
+ * must not be moved or copied afterwards. To place one on the heap, use
+ * @c aligned_alloc with @ref BASIC_CACHE_LINE_SIZE.
+ *
+ * @var basic_mpmc_queue::slots
+ * @brief The ring of slots, each an @c atomic_size_t sequence number
+ *  followed by an element.
+ *
+ * @var basic_mpmc_queue::elem_size
+ * @brief The size of each element, in bytes.
+ *
+ * @var basic_mpmc_queue::elem_cap
+ * @brief The number of slots, always a power of two.
+ *
+ * @var basic_mpmc_queue::enqueue_pos
+ * @brief The next position producers will claim.
+ *
+ * @var basic_mpmc_queue::dequeue_pos
+ * @brief The next position consumers will claim.
+ */
+typedef struct {
+    basic_array slots;
+    size_t elem_size;
+    int elem_cap;
+
+    alignas(BASIC_CACHE_LINE_SIZE) atomic_size_t enqueue_pos;
+    alignas(BASIC_CACHE_LINE_SIZE) atomic_size_t dequeue_pos;
+} basic_mpmc_queue;
+
+/**
+ * @brief The value representing a basic_mpmc_queue in the null state.
+ */
+#define BASIC_MPMC_QUEUE_NULL ((basic_mpmc_queue){.slots = BASIC_ARRAY_NULL})
+
+static inline bool basic_mpmc_queue_isnull(basic_mpmc_queue const *queue);
+static inline bool basic_mpmc_queue_isinit(basic_mpmc_queue const *queue);
+
+/**
+ * @brief Creates an empty basic_mpmc_queue.
+ *
+ * @param[in] elem_size The size of each element, in bytes.
+ * @param[in] cap The minimum capacity, which is rounded up to a power of
+ *  two no smaller than two. The queue never grows.
+ *
+ * @returns An initialised basic_mpmc_queue, or @ref BASIC_MPMC_QUEUE_NULL
+ *  if the allocation fails or @c cap rounds up past @c INT_MAX.
+ */
+basic_mpmc_queue basic_mpmc_queue_new(size_t elem_size, int cap);
+void basic_mpmc_queue_destroy(basic_mpmc_queue *queue);
+
+/**
+ * @brief Copies up to @c n elements from @c elems into the basic_mpmc_queue
+ *  without blocking.
+ *
+ * The elements occupy consecutive positions, so a consumer popping in bulk
+ * sees them in order, although other consumers may take some of them.
+ *
+ * @returns The number of elements pushed, which is zero if the queue was
+ *  full.
+ */
+int basic_mpmc_queue_try_push_n(
+        basic_mpmc_queue *queue,
+        void const *elems,
+        int n);
+
+/**
+ * @brief Copies up to @c n elements out of the basic_mpmc_queue into
+ *  @c elems without blocking.
+ *
+ * @returns The number of elements popped, which is zero if the queue was
+ *  empty.
+ */
+int basic_mpmc_queue_try_pop_n(basic_mpmc_queue *queue, void *elems, int n);
+
+/**
+ * @brief Pushes or pops exactly @c n elements, spinning and then yielding
+ *  the processor while the queue is full or empty.
+ *
+ * These never return early, so a consumer must not wait for more elements
+ * than the producers will push.
+ */
+void basic_mpmc_queue_push_n(
+        basic_mpmc_queue *queue,
+        void const *elems,
+        int n);
+void basic_mpmc_queue_pop_n(basic_mpmc_queue *queue, void *elems, int n);
+
+static inline bool basic_mpmc_queue_try_push(
+        basic_mpmc_queue *queue,
+        void const *elem);
+static inline bool basic_mpmc_queue_try_pop(
+        basic_mpmc_queue *queue,
+        void *elem);
+
+static inline void basic_mpmc_queue_push(
+        basic_mpmc_queue *queue,
+        void const *elem);
+static inline void basic_mpmc_queue_pop(basic_mpmc_queue *queue, void *elem);
+
+bool basic_mpmc_queue_isnull(basic_mpmc_queue const *queue)
+{
+    BASIC_ASSERT_PTR_NONNULL(queue);
+    return basic_array_isnull(&queue->slots)
+        && !queue->elem_size
+        && !queue->elem_cap;
+}
+
+bool basic_mpmc_queue_isinit(basic_mpmc_queue const *queue)
+{
+    BASIC_ASSERT_PTR_NONNULL(queue);
+    return basic_array_isinit(&queue->slots)
+        && queue->elem_size
+        && queue->elem_cap > 1
+        && !(queue->elem_cap & (queue->elem_cap - 1));
+}
+
+bool basic_mpmc_queue_try_push(basic_mpmc_queue *queue, void const *elem)
+{
+    return basic_mpmc_queue_try_push_n(queue, elem, 1) == 1;
+}
+
+bool basic_mpmc_queue_try_pop(basic_mpmc_queue *queue, void *elem)
+{
+    return basic_mpmc_queue_try_pop_n(queue, elem, 1) == 1;
+}
+
+void basic_mpmc_queue_push(basic_mpmc_queue *queue, void const *elem)
+{
+    basic_mpmc_queue_push_n(queue, elem, 1);
+}
+
+void basic_mpmc_queue_pop(basic_mpmc_queue *queue, void *elem)
+{
+    basic_mpmc_queue_pop_n(queue, elem, 1);
+}
+
+#endif // BASIC_MPMC_QUEUE_H_
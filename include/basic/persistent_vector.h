@@ -0,0 +1,189 @@
+/**
+ * @file persistent_vector.h
+ */
+
+#ifndef BASIC_PERSISTENT_VECTOR_H_
+#define BASIC_PERSISTENT_VECTOR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "assertion.h"
+
+/**
+ * @brief The number of children of each interior node and the number of
+ *  elements in each leaf, as a power of two.
+ */
+#define BASIC_PERSISTENT_VECTOR_BITS 5
+#define BASIC_PERSISTENT_VECTOR_BRANCH (1 << BASIC_PERSISTENT_VECTOR_BITS)
+
+typedef struct basic_persistent_vector_node basic_persistent_vector_node;
+
+/**
+ * @struct basic_persistent_vector
+ * @brief A vector of fixed-size elements whose versions share structure.
+ *
+ * Elements live in the leaves of a radix-balanced tree with 32 slots per
+ * node, except for the last, partially filled leaf, which is held apart as
+ * the tail. Appends go to the tail, so they touch the tree only once every
+ * 32 elements, and an element at any index is found in
+ * log32(n) steps.
+ *
+ * Nodes are reference counted and may be shared between versions. Cloning
+ * a basic_persistent_vector is O(1): it takes a reference to the root and
+ * tail. Modifying a version copies only the nodes on the path to the
+ * change that are shared with another version, and changes nodes it alone
+ * references in place. A freshly built or uniquely held vector therefore
+ * behaves like a transient, mutating in place until a clone shares its
+ * nodes, after which the clone is unaffected by further changes. Memory per
+ * version grows with the size of each change, not the size of the vector.
+ *
+ * Reference counts are atomic, so versions sharing nodes may be read,
+ * modified and destroyed from different threads. A single version must not
+ * be modified concurrently with any other use of it.
+ *
+ * @var basic_persistent_vector::root
+ * @brief The root of the tree, or @c NULL if every element is in the tail.
+ *
+ * @var basic_persistent_vector::tail
+ * @brief The last leaf, or @c NULL if the vector is empty.
+ *
+ * @var basic_persistent_vector::elem_size
+ * @brief The size of each element, in bytes.
+ *
+ * @var basic_persistent_vector::elem_count
+ * @brief The number of elements.
+ *
+ * @var basic_persistent_vector::shift
+ * @brief The number of index bits below the root's children.
+ */
+typedef struct {
+    basic_persistent_vector_node *root;
+    basic_persistent_vector_node *tail;
+    size_t elem_size;
+    size_t elem_count;
+    int shift;
+} basic_persistent_vector;
+
+/**
+ * @brief The value representing a basic_persistent_vector in the null state.
+ */
+#define BASIC_PERSISTENT_VECTOR_NULL \
+    ((basic_persistent_vector){NULL, NULL, 0, 0, 0})
+
+static inline bool basic_persistent_vector_isnull(
+        basic_persistent_vector const *vector);
+static inline bool basic_persistent_vector_isinit(
+        basic_persistent_vector const *vector);
+static inline bool basic_persistent_vector_isempty(
+        basic_persistent_vector const *vector);
+
+basic_persistent_vector basic_persistent_vector_move(
+        basic_persistent_vector *vector);
+
+/**
+ * @brief Returns a new version sharing every node with @c vector. O(1), and
+ *  never fails.
+ */
+basic_persistent_vector basic_persistent_vector_clone(
+        basic_persistent_vector const *vector);
+
+/**
+ * @brief Creates an empty basic_persistent_vector. No memory is allocated
+ *  until the first element is appended.
+ */
+basic_persistent_vector basic_persistent_vector_new(size_t elem_size);
+
+/**
+ * @brief Releases this version's references, freeing the nodes no other
+ *  version shares.
+ */
+void basic_persistent_vector_destroy(basic_persistent_vector *vector);
+
+/**
+ * @brief Overwrites the element at @c index with a copy of @c elem.
+ *
+ * @retval true On success.
+ * @retval false If a shared node could not be copied. The elements are
+ *  unchanged.
+ */
+bool basic_persistent_vector_set(
+        basic_persistent_vector *vector,
+        size_t index,
+        void const *elem);
+
+/**
+ * @brief Appends a copy of @c elem.
+ *
+ * @retval true On success.
+ * @retval false If a node could not be allocated. The elements are
+ *  unchanged.
+ */
+bool basic_persistent_vector_pushback(
+        basic_persistent_vector *vector,
+        void const *elem);
+
+/**
+ * @brief Removes the last element.
+ *
+ * @retval true On success.
+ * @retval false If a shared node could not be copied. The elements are
+ *  unchanged.
+ */
+bool basic_persistent_vector_popback(basic_persistent_vector *vector);
+
+/**
+ * @brief Returns a new version of @c vector with the element at @c index
+ *  replaced by a copy of @c elem, leaving @c vector unchanged.
+ *
+ * @returns The new version, or @ref BASIC_PERSISTENT_VECTOR_NULL if an
+ *  allocation failed.
+ */
+basic_persistent_vector basic_persistent_vector_with(
+        basic_persistent_vector const *vector,
+        size_t index,
+        void const *elem);
+
+/**
+ * @brief Returns a new version of @c vector with a copy of @c elem
+ *  appended, leaving @c vector unchanged.
+ *
+ * @returns The new version, or @ref BASIC_PERSISTENT_VECTOR_NULL if an
+ *  allocation failed.
+ */
+basic_persistent_vector basic_persistent_vector_with_pushback(
+        basic_persistent_vector const *vector,
+        void const *elem);
+
+/**
+ * @brief Returns a pointer to the element at @c index. The element must not
+ *  be modified through it, since other versions may share it.
+ */
+void const *basic_persistent_vector_at(
+        basic_persistent_vector const *vector,
+        size_t index);
+
+bool basic_persistent_vector_isnull(basic_persistent_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return !vector->root
+        && !vector->tail
+        && !vector->elem_size
+        && !vector->elem_count;
+}
+
+bool basic_persistent_vector_isinit(basic_persistent_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return vector->elem_size
+        && vector->shift >= BASIC_PERSISTENT_VECTOR_BITS
+        && (vector->tail || !vector->elem_count);
+}
+
+bool basic_persistent_vector_isempty(basic_persistent_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return basic_persistent_vector_isinit(vector) && !vector->elem_count;
+}
+
+#endif // BASIC_PERSISTENT_VECTOR_H_
@@ -0,0 +1,98 @@
+/**
+ * @file rank_select.h
+ */
+
+#ifndef BASIC_RANK_SELECT_H_
+#define BASIC_RANK_SELECT_H_
+
+#include <stdbool.h>
+
+#include "assertion.h"
+#include "array.h"
+#include "bitset.h"
+
+/**
+ * @struct basic_rank_select
+ * @brief A support structure answering rank and select queries over a
+ *  basic_bitset.
+ *
+ * The structure stores the number of set bits preceding each 512-bit
+ * superblock of the basic_bitset it was built from. A rank query then
+ * costs one table lookup plus at most eight word popcounts, and a select
+ * query a binary search over the superblocks plus the same word scan.
+ *
+ * The basic_rank_select does not observe later changes to the basic_bitset;
+ * it must be rebuilt with @ref basic_rank_select_new after the bitset is
+ * modified.
+ *
+ * @var basic_rank_select::ranks
+ * @brief A basic_array of int, where element @c i is the number of set bits
+ *  before superblock @c i. The final element is the total count.
+ *
+ * @var basic_rank_select::bit_count
+ * @brief The @c bit_count of the basic_bitset the structure was built from.
+ */
+typedef struct {
+    basic_array ranks;
+    int bit_count;
+} basic_rank_select;
+
+/**
+ * @brief The value representing a basic_rank_select in the null state.
+ */
+#define BASIC_RANK_SELECT_NULL ((basic_rank_select){BASIC_ARRAY_NULL, 0})
+
+static inline bool basic_rank_select_isnull(
+        basic_rank_select const *rank_select);
+
+static inline bool basic_rank_select_isinit(
+        basic_rank_select const *rank_select);
+
+/**
+ * @brief Builds the rank/select directory for @c bitset in a single pass.
+ *
+ * @returns An initialised basic_rank_select, or @ref BASIC_RANK_SELECT_NULL
+ *  if the allocation fails.
+ */
+basic_rank_select basic_rank_select_new(basic_bitset const *bitset);
+void basic_rank_select_destroy(basic_rank_select *rank_select);
+
+/**
+ * @brief Returns the number of set bits in [0, @c index) of @c bitset.
+ *
+ * @pre @c rank_select must have been built from @c bitset, and @c bitset
+ *  must not have been modified since
+ * @pre @c index must be in [0, bit_count]
+ */
+int basic_rank_select_rank(
+        basic_rank_select const *rank_select,
+        basic_bitset const *bitset,
+        int index);
+
+/**
+ * @brief Returns the index of the set bit of rank @c rank (counting from
+ *  zero) in @c bitset, or -1 if @c bitset has no more than @c rank set bits.
+ *
+ * @pre @c rank_select must have been built from @c bitset, and @c bitset
+ *  must not have been modified since
+ * @pre @c rank must be non-negative
+ */
+int basic_rank_select_select(
+        basic_rank_select const *rank_select,
+        basic_bitset const *bitset,
+        int rank);
+
+bool basic_rank_select_isnull(basic_rank_select const *rank_select)
+{
+    BASIC_ASSERT_PTR_NONNULL(rank_select);
+    return basic_array_isnull(&rank_select->ranks) && !rank_select->bit_count;
+}
+
+bool basic_rank_select_isinit(basic_rank_select const *rank_select)
+{
+    BASIC_ASSERT_PTR_NONNULL(rank_select);
+    return basic_array_isinit(&rank_select->ranks)
+        && rank_select->bit_count > 0;
+}
+
+#endif // BASIC_RANK_SELECT_H_
@@ -0,0 +1,173 @@
+/**
+ * @file rcu_vector.h
+ */
+
+#ifndef BASIC_RCU_VECTOR_H_
+#define BASIC_RCU_VECTOR_H_
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "assertion.h"
+#include "array.h"
+#include "basic.h"
+#include "vector.h"
+
+/**
+ * @struct basic_rcu_vector
+ * @brief Publishes successive versions of a read-mostly basic_vector to
+ *  any number of reader threads without a shared lock.
+ *
+ * Writers build a new basic_vector privately and publish it with
+ * @ref basic_rcu_vector_publish, which swaps it in atomically. Readers
+ * bracket their use of the current version with
+ * @ref basic_rcu_vector_read_lock and @ref basic_rcu_vector_read_unlock.
+ * Both are wait-free, and neither writes to memory shared with other
+ * readers.
+ *
+ * Old versions are reclaimed by epoch. Each registered reader owns a
+ * cache-line-sized slot. Entering a read section stores the global epoch
+ * in that slot, and leaving it stores zero. Publishing retires the old
+ * version, tagged with the epoch at which it was replaced, and advances
+ * the epoch. A retired version is freed once every reader slot is either
+ * idle or holds a later epoch, since such readers can only have seen a
+ * newer version.
+ *
+ * A basic_rcu_vector must be created before any thread starts using it and
+ * must not be moved or copied afterwards.
+ *
+ * @var basic_rcu_vector::current
+ * @brief The published version.
+ *
+ * @var basic_rcu_vector::readers
+ * @brief The reader slots, one cache line each, plus one line of slack so
+ *  that they can be aligned. Each holds the epoch its reader announced and
+ *  whether it is claimed.
+ *
+ * @var basic_rcu_vector::retired
+ * @brief Replaced versions awaiting reclamation, each with the epoch at
+ *  which it was replaced.
+ *
+ * @var basic_rcu_vector::reader_cap
+ * @brief The number of reader slots.
+ *
+ * @var basic_rcu_vector::epoch
+ * @brief The global epoch, starting at 1. Zero marks an idle reader.
+ *
+ * @var basic_rcu_vector::write_lock
+ * @brief Serialises writers.
+ */
+typedef struct {
+    _Atomic(basic_vector *) current;
+    basic_array readers;
+    basic_vector retired;
+    int reader_cap;
+
+    alignas(BASIC_CACHE_LINE_SIZE) atomic_uint_least64_t epoch;
+    atomic_flag write_lock;
+} basic_rcu_vector;
+
+/**
+ * @brief The value representing a basic_rcu_vector in the null state.
+ */
+#define BASIC_RCU_VECTOR_NULL ((basic_rcu_vector){.readers = BASIC_ARRAY_NULL})
+
+static inline bool basic_rcu_vector_isnull(basic_rcu_vector const *rcu);
+static inline bool basic_rcu_vector_isinit(basic_rcu_vector const *rcu);
+
+/**
+ * @brief Creates a basic_rcu_vector publishing @c initial, taking ownership
+ *  of it.
+ *
+ * @param[in] initial Pointer to the first version.
+ * @param[in] reader_cap The maximum number of reader threads.
+ *
+ * @returns An initialised basic_rcu_vector, or @ref BASIC_RCU_VECTOR_NULL if
+ *  an allocation fails, in which case @c initial is left unchanged.
+ */
+basic_rcu_vector basic_rcu_vector_new(basic_vector *initial, int reader_cap);
+
+/**
+ * @brief Frees the current and every retired version. No other thread may
+ *  be using the basic_rcu_vector.
+ */
+void basic_rcu_vector_destroy(basic_rcu_vector *rcu);
+
+/**
+ * @brief Claims a reader slot for the calling thread.
+ *
+ * Slots released by @ref basic_rcu_vector_unregister are handed out
+ * again, lowest first.
+ *
+ * @returns The slot to pass to the read functions, or -1 if all
+ *  @c reader_cap slots are taken.
+ */
+int basic_rcu_vector_register(basic_rcu_vector *rcu);
+
+/**
+ * @brief Releases the slot claimed by @c reader so that another thread can
+ *  register. The reader must not be in a read section.
+ */
+void basic_rcu_vector_unregister(basic_rcu_vector *rcu, int reader);
+
+/**
+ * @brief Enters a read section and returns the current version, which
+ *  stays valid until the matching @ref basic_rcu_vector_read_unlock.
+ *  Wait-free. Read sections must not be nested on the same slot.
+ */
+basic_vector const *basic_rcu_vector_read_lock(
+        basic_rcu_vector *rcu,
+        int reader);
+
+/**
+ * @brief Leaves the read section entered on @c reader. Wait-free.
+ */
+void basic_rcu_vector_read_unlock(basic_rcu_vector *rcu, int reader);
+
+/**
+ * @brief Publishes @c vector as the current version, taking ownership of
+ *  it, and reclaims whatever retired versions no reader can still see.
+ *
+ * If the retired list cannot grow, waits for readers of the old version to
+ * leave and frees it directly.
+ *
+ * @retval true On success.
+ * @retval false If an allocation failed. @c vector is left unchanged.
+ */
+bool basic_rcu_vector_publish(basic_rcu_vector *rcu, basic_vector *vector);
+
+/**
+ * @brief Frees the retired versions no reader can still see.
+ *
+ * @returns The number of retired versions still awaiting reclamation.
+ */
+int basic_rcu_vector_reclaim(basic_rcu_vector *rcu);
+
+/**
+ * @brief Waits until every read section active at the call has ended, then
+ *  frees every retired version.
+ */
+void basic_rcu_vector_synchronize(basic_rcu_vector *rcu);
+
+bool basic_rcu_vector_isnull(basic_rcu_vector const *rcu)
+{
+    BASIC_ASSERT_PTR_NONNULL(rcu);
+    return basic_array_isnull(&rcu->readers)
+        && basic_vector_isnull(&rcu->retired)
+        && !rcu->reader_cap;
+}
+
+bool basic_rcu_vector_isinit(basic_rcu_vector const *rcu)
+{
+    BASIC_ASSERT_PTR_NONNULL(rcu);
+
+    // Readers check this concurrently with writers, so it only looks at
+    // fields that are fixed once the basic_rcu_vector is created
+    return basic_array_isinit(&rcu->readers)
+        && rcu->reader_cap > 0;
+}
+
+#endif // BASIC_RCU_VECTOR_H_
@@ -0,0 +1,199 @@
+/**
+ * @file soa.h
+ */
+
+#ifndef BASIC_SOA_H_
+#define BASIC_SOA_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "assertion.h"
+#include "array.h"
+#include "growth.h"
+#include "span.h"
+
+/**
+ * @struct basic_soa
+ * @brief A growable sequence of records stored as a structure of arrays.
+ *
+ * A basic_soa stores each field of its records in a separate basic_array
+ * (a *column*), so that a scan over a single field touches only that
+ * field's bytes. The schema is the list of field sizes given to
+ * @ref basic_soa_new, and every record-level operation keeps all columns
+ * the same length.
+ *
+ * @var basic_soa::columns
+ * @brief A basic_array of basic_array objects, one per field.
+ *
+ * @var basic_soa::field_count
+ * @brief The number of fields (columns) in each record.
+ *
+ * @var basic_soa::elem_count
+ * @brief The number of records currently stored.
+ *
+ * @var basic_soa::elem_cap
+ * @brief The number of records every column can hold without growing.
+ *
+ * @var basic_soa::growth
+ * @brief How the columns grow when an insert finds them full.
+ */
+typedef struct {
+    basic_array columns;
+    size_t field_count;
+    size_t elem_count;
+    size_t elem_cap;
+    basic_growth_policy growth;
+} basic_soa;
+
+/**
+ * @brief The value representing a basic_soa in the null state.
+ */
+#define BASIC_SOA_NULL \
+    ((basic_soa){BASIC_ARRAY_NULL, 0, 0, 0, BASIC_GROWTH_DOUBLE})
+
+static inline bool basic_soa_isnull(basic_soa const *soa);
+static inline bool basic_soa_isinit(basic_soa const *soa);
+static inline bool basic_soa_isempty(basic_soa const *soa);
+
+basic_soa basic_soa_move(basic_soa *soa);
+basic_soa basic_soa_clone(basic_soa const *soa);
+
+/**
+ * @brief Creates a basic_soa with one column per entry of @c field_sizes.
+ *
+ * @param[in] field_sizes Array of @c field_count field sizes, in bytes.
+ * @param[in] field_count The number of fields in each record.
+ * @param[in] initial_cap The initial record capacity of every column.
+ *
+ * @pre @c field_sizes must be non-NULL and contain no zero entries
+ * @pre @c field_count and @c initial_cap must be nonzero
+ *
+ * @returns An initialised basic_soa on success, or @ref BASIC_SOA_NULL if
+ *  any allocation fails.
+ */
+basic_soa basic_soa_new(
+        size_t const *field_sizes,
+        size_t field_count,
+        size_t initial_cap);
+
+void basic_soa_destroy(basic_soa *soa);
+
+/**
+ * @brief Sets the policy used to pick the record capacity every column
+ *  grows to when an insert finds the basic_soa full.
+ *
+ * A new basic_soa uses @ref BASIC_GROWTH_DOUBLE. The widest column bounds
+ * the capacity, so every column's size in bytes stays within a @c size_t.
+ *
+ * @pre @c growth.increment must be positive if @c growth.kind is
+ *  @c basic_growth_fixed
+ */
+void basic_soa_set_growth(basic_soa *soa, basic_growth_policy growth);
+
+/**
+ * @brief Inserts a record at @c index, shifting later records right in
+ *  every column.
+ *
+ * @param[in] soa Pointer to the basic_soa to insert into.
+ * @param[in] index The record index to insert at, in [0, elem_count].
+ * @param[in] fields Array of @c field_count pointers, where @c fields[i]
+ *  points to the value of field @c i.
+ *
+ * @retval true If the record was inserted.
+ * @retval false If growing the columns failed. The basic_soa is unchanged.
+ */
+bool basic_soa_insert(
+        basic_soa *soa,
+        size_t index,
+        void const *const *fields);
+
+/**
+ * @brief Removes the record at @c index from every column.
+ */
+void basic_soa_remove(basic_soa *soa, size_t index);
+
+static inline bool basic_soa_insertfront(
+        basic_soa *soa,
+        void const *const *fields);
+
+static inline bool basic_soa_insertback(
+        basic_soa *soa,
+        void const *const *fields);
+
+static inline void basic_soa_removefront(basic_soa *soa);
+static inline void basic_soa_removeback(basic_soa *soa);
+
+/**
+ * @brief Returns a pointer to field @c field of the record at @c index.
+ */
+void *basic_soa_at(basic_soa *soa, size_t index, size_t field);
+void const *basic_soa_at_c(
+        basic_soa const *soa,
+        size_t index,
+        size_t field);
+
+basic_span basic_soa_get(basic_soa *soa, size_t index, size_t field);
+
+/**
+ * @brief Returns a basic_span over the first @c elem_count values of
+ *  column @c field.
+ *
+ * The values of a column are contiguous, so the returned span may be
+ * scanned directly. The span is invalidated by any operation that grows
+ * the basic_soa.
+ *
+ * @returns A basic_span of size @c elem_count * field size, or
+ *  @ref BASIC_SPAN_NULL if the basic_soa is empty.
+ */
+basic_span basic_soa_column(basic_soa *soa, size_t field);
+
+size_t basic_soa_field_size(basic_soa const *soa, size_t field);
+
+bool basic_soa_isnull(basic_soa const *soa)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    return basic_array_isnull(&soa->columns)
+        && !soa->field_count
+        && !soa->elem_count
+        && !soa->elem_cap;
+}
+
+bool basic_soa_isinit(basic_soa const *soa)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    return basic_array_isinit(&soa->columns)
+        && soa->field_count > 0
+        && soa->elem_cap > 0
+        && soa->elem_cap >= soa->elem_count;
+}
+
+bool basic_soa_isempty(basic_soa const *soa)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    return basic_soa_isinit(soa) && !soa->elem_count;
+}
+
+bool basic_soa_insertfront(basic_soa *soa, void const *const *fields)
+{
+    return basic_soa_insert(soa, 0, fields);
+}
+
+bool basic_soa_insertback(basic_soa *soa, void const *const *fields)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    return basic_soa_insert(soa, soa->elem_count, fields);
+}
+
+void basic_soa_removefront(basic_soa *soa)
+{
+    basic_soa_remove(soa, 0);
+}
+
+void basic_soa_removeback(basic_soa *soa)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    basic_soa_remove(soa, soa->elem_count - 1);
+}
+
+#endif // BASIC_SOA_H_
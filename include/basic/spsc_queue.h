@@ -0,0 +1,149 @@
+/**
+ * @file spsc_queue.h
+ */
+
+#ifndef BASIC_SPSC_QUEUE_H_
+#define BASIC_SPSC_QUEUE_H_
+
+#include <stdalign.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "assertion.h"
+#include "array.h"
+#include "basic.h"
+
+/**
+ * @struct basic_spsc_queue
+ * @brief A bounded, lock-free queue for exactly one producer thread and one
+ *  consumer thread.
+ *
+ * @c head and @c tail are free-running counters masked into a power-of-two
+ * ring buffer. Only the consumer stores to @c head and only the producer
+ * stores to @c tail, each with release ordering, and each side reads the
+ * other's counter with acquire ordering. Each side also keeps a cached copy
+ * of the other's counter on its own cache line and only reloads the shared
+ * one when the cached value says the queue is full or empty, so in the
+ * steady state the two threads do not touch each other's cache lines.
+ *
+ * A basic_spsc_queue must be created before either thread starts using it
+ * and must not be moved or copied afterwards. To place one on the heap, use
+ * @c aligned_alloc with @ref BASIC_CACHE_LINE_SIZE so that the padding
+ * lines up with real cache lines.
+ *
+ * @var basic_spsc_queue::data
+ * @brief The ring buffer.
+ *
+ * @var basic_spsc_queue::elem_cap
+ * @brief The number of slots in the ring buffer, always a power of two.
+ *
+ * @var basic_spsc_queue::head
+ * @brief The number of elements popped so far. Written by the consumer.
+ *
+ * @var basic_spsc_queue::cached_tail
+ * @brief The consumer's last observed value of @c tail.
+ *
+ * @var basic_spsc_queue::tail
+ * @brief The number of elements pushed so far. Written by the producer.
+ *
+ * @var basic_spsc_queue::cached_head
+ * @brief The producer's last observed value of @c head.
+ */
+typedef struct {
+    basic_array data;
+    int elem_cap;
+
+    alignas(BASIC_CACHE_LINE_SIZE) atomic_size_t head;
+    size_t cached_tail;
+
+    alignas(BASIC_CACHE_LINE_SIZE) atomic_size_t tail;
+    size_t cached_head;
+} basic_spsc_queue;
+
+/**
+ * @brief The value representing a basic_spsc_queue in the null state.
+ */
+#define BASIC_SPSC_QUEUE_NULL ((basic_spsc_queue){.data = BASIC_ARRAY_NULL})
+
+static inline bool basic_spsc_queue_isnull(basic_spsc_queue const *queue);
+static inline bool basic_spsc_queue_isinit(basic_spsc_queue const *queue);
+
+/**
+ * @brief Creates an empty basic_spsc_queue.
+ *
+ * @param[in] elem_size The size of each element, in bytes.
+ * @param[in] cap The minimum capacity, which is rounded up to a power of
+ *  two. The queue never grows.
+ *
+ * @returns An initialised basic_spsc_queue, or @ref BASIC_SPSC_QUEUE_NULL
+ *  if the allocation fails or @c cap rounds up past @c INT_MAX.
+ */
+basic_spsc_queue basic_spsc_queue_new(size_t elem_size, int cap);
+void basic_spsc_queue_destroy(basic_spsc_queue *queue);
+
+/**
+ * @brief Copies up to @c n elements from @c elems onto the back of the
+ *  basic_spsc_queue. Must only be called by the producer.
+ *
+ * @param[in] queue Pointer to the basic_spsc_queue.
+ * @param[in] elems Pointer to @c n contiguous elements.
+ * @param[in] n The number of elements to push.
+ *
+ * @returns The number of elements pushed, which is less than @c n if the
+ *  queue filled up.
+ */
+int basic_spsc_queue_push_n(
+        basic_spsc_queue *queue,
+        void const *elems,
+        int n);
+
+/**
+ * @brief Copies up to @c n elements from the front of the basic_spsc_queue
+ *  into @c elems. Must only be called by the consumer.
+ *
+ * @param[in] queue Pointer to the basic_spsc_queue.
+ * @param[out] elems Pointer to room for @c n contiguous elements.
+ * @param[in] n The maximum number of elements to pop.
+ *
+ * @returns The number of elements popped, which is less than @c n if the
+ *  queue ran empty.
+ */
+int basic_spsc_queue_pop_n(basic_spsc_queue *queue, void *elems, int n);
+
+/**
+ * @brief Pushes or pops a single element.
+ *
+ * @retval true If the element was pushed or popped.
+ * @retval false If the queue was full or empty, respectively.
+ */
+static inline bool basic_spsc_queue_push(
+        basic_spsc_queue *queue,
+        void const *elem);
+static inline bool basic_spsc_queue_pop(basic_spsc_queue *queue, void *elem);
+
+bool basic_spsc_queue_isnull(basic_spsc_queue const *queue)
+{
+    BASIC_ASSERT_PTR_NONNULL(queue);
+    return basic_array_isnull(&queue->data) && !queue->elem_cap;
+}
+
+bool basic_spsc_queue_isinit(basic_spsc_queue const *queue)
+{
+    BASIC_ASSERT_PTR_NONNULL(queue);
+    return basic_array_isinit(&queue->data)
+        && queue->elem_cap > 0
+        && !(queue->elem_cap & (queue->elem_cap - 1));
+}
+
+bool basic_spsc_queue_push(basic_spsc_queue *queue, void const *elem)
+{
+    return basic_spsc_queue_push_n(queue, elem, 1) == 1;
+}
+
+bool basic_spsc_queue_pop(basic_spsc_queue *queue, void *elem)
+{
+    return basic_spsc_queue_pop_n(queue, elem, 1) == 1;
+}
+
+#endif // BASIC_SPSC_QUEUE_H_
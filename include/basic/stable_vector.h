@@ -0,0 +1,183 @@
+/**
+ * @file stable_vector.h
+ */
+
+#ifndef BASIC_STABLE_VECTOR_H_
+#define BASIC_STABLE_VECTOR_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "assertion.h"
+#include "array.h"
+#include "span.h"
+#include "vector.h"
+
+/**
+ * @struct basic_stable_vector
+ * @brief A vector whose elements never move, stored in fixed-size chunks.
+ *
+ * Elements live in chunks of @c 1 << chunk_shift elements, each a separate
+ * basic_array, and a basic_vector of the chunks acts as the directory.
+ * Indexing is a shift and a mask. Growing allocates one more chunk and
+ * appends it to the directory, so existing elements are never copied and
+ * pointers to them stay valid until they are removed. Shrinking frees
+ * whole chunks once they are no longer needed.
+ *
+ * @var basic_stable_vector::chunks
+ * @brief The chunk directory, a basic_vector of basic_array.
+ *
+ * @var basic_stable_vector::elem_size
+ * @brief The size of each element, in bytes.
+ *
+ * @var basic_stable_vector::chunk_shift
+ * @brief The base-2 logarithm of the number of elements per chunk.
+ *
+ * @var basic_stable_vector::elem_count
+ * @brief The number of elements in the basic_stable_vector.
+ */
+typedef struct {
+    basic_vector chunks;
+    size_t elem_size;
+    int chunk_shift;
+    size_t elem_count;
+} basic_stable_vector;
+
+/**
+ * @brief The value representing a basic_stable_vector in the null state.
+ */
+#define BASIC_STABLE_VECTOR_NULL \
+    ((basic_stable_vector){BASIC_VECTOR_NULL, 0, 0, 0})
+
+static inline bool basic_stable_vector_isnull(
+        basic_stable_vector const *vector);
+static inline bool basic_stable_vector_isinit(
+        basic_stable_vector const *vector);
+static inline bool basic_stable_vector_isempty(
+        basic_stable_vector const *vector);
+
+basic_stable_vector basic_stable_vector_move(basic_stable_vector *vector);
+basic_stable_vector basic_stable_vector_clone(
+        basic_stable_vector const *vector);
+
+/**
+ * @brief Creates an empty basic_stable_vector. No chunk is allocated until
+ *  the first element is added.
+ *
+ * @param[in] elem_size The size of each element, in bytes.
+ * @param[in] chunk_cap The number of elements per chunk, rounded up to a
+ *  power of two.
+ *
+ * @returns An initialised basic_stable_vector, or
+ *  @ref BASIC_STABLE_VECTOR_NULL if the allocation fails or a chunk of
+ *  @c chunk_cap rounded up would not fit in a @c size_t.
+ */
+basic_stable_vector basic_stable_vector_new(
+        size_t elem_size,
+        size_t chunk_cap);
+void basic_stable_vector_destroy(basic_stable_vector *vector);
+
+/**
+ * @brief Returns a pointer to a new, uninitialised slot at the back of the
+ *  basic_stable_vector, allocating a chunk if the last one is full.
+ *
+ * @returns A pointer to the new slot, or @c NULL if a chunk could not be
+ *  allocated.
+ */
+void *basic_stable_vector_emplace_back(basic_stable_vector *vector);
+
+/**
+ * @brief Copies the element pointed to by @c elem onto the back of the
+ *  basic_stable_vector.
+ *
+ * @retval true If the element was added.
+ * @retval false If a chunk could not be allocated.
+ */
+bool basic_stable_vector_pushback(
+        basic_stable_vector *vector,
+        void const *elem);
+
+/**
+ * @brief Removes elements from the back until @c elem_count remain, then
+ *  frees the chunks that are no longer needed.
+ *
+ * One empty chunk is kept as a spare so that alternately pushing and
+ * popping across a chunk boundary does not allocate every time.
+ */
+void basic_stable_vector_truncate(
+        basic_stable_vector *vector,
+        size_t elem_count);
+
+static inline void basic_stable_vector_popback(basic_stable_vector *vector);
+
+/**
+ * @brief Frees every chunk beyond those holding elements, including the
+ *  spare, and shrinks the chunk directory to fit.
+ *
+ * @retval true On success.
+ * @retval false If shrinking the directory failed. The chunks are still
+ *  freed and the basic_stable_vector is unchanged otherwise.
+ */
+bool basic_stable_vector_shrink_to_fit(basic_stable_vector *vector);
+
+void *basic_stable_vector_at(basic_stable_vector *vector, size_t index);
+void const *basic_stable_vector_at_c(
+        basic_stable_vector const *vector,
+        size_t index);
+
+/**
+ * @brief Returns the number of chunks that hold at least one element.
+ */
+static inline size_t basic_stable_vector_chunk_count(
+        basic_stable_vector const *vector);
+
+/**
+ * @brief Returns a span over the elements in chunk @c chunk, for sequential
+ *  iteration without per-element index arithmetic. Every chunk but the last
+ *  is full.
+ */
+basic_span basic_stable_vector_chunk(
+        basic_stable_vector *vector,
+        size_t chunk);
+
+bool basic_stable_vector_isnull(basic_stable_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return basic_vector_isnull(&vector->chunks)
+        && !vector->elem_size
+        && !vector->chunk_shift
+        && !vector->elem_count;
+}
+
+bool basic_stable_vector_isinit(basic_stable_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return basic_vector_isinit(&vector->chunks)
+        && vector->elem_size
+        && vector->chunk_shift >= 0;
+}
+
+bool basic_stable_vector_isempty(basic_stable_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return basic_stable_vector_isinit(vector) && !vector->elem_count;
+}
+
+void basic_stable_vector_popback(basic_stable_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(vector->elem_count > 0,
+            "basic_stable_vector object must be non-empty");
+
+    basic_stable_vector_truncate(vector, vector->elem_count - 1);
+}
+
+size_t basic_stable_vector_chunk_count(basic_stable_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    size_t const mask = ((size_t)1 << vector->chunk_shift) - 1;
+    return (vector->elem_count >> vector->chunk_shift)
+        + ((vector->elem_count & mask) != 0);
+}
+
+#endif // BASIC_STABLE_VECTOR_H_
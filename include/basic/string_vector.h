@@ -2,18 +2,33 @@
 #define BASIC_STRING_VECTOR_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "assertion.h"
 #include "array.h"
+#include "growth.h"
+#include "span.h"
+#include "vector.h"
 
+// Strings are stored back to back, each in a run of whole chunks.
+// string_offsets holds the index of the first chunk of each string, so that
+// any string is found in constant time.
 typedef struct {
     basic_array chunk_data;
-    int chunk_count;
-    int string_count;
+    basic_vector string_offsets;
+    size_t chunk_count;
+    size_t string_count;
+    basic_growth_policy growth;
 } basic_string_vector;
 
 #define BASIC_STRING_VECTOR_NULL \
-    ((basic_string_vector){BASIC_ARRAY_NULL, 0, 0})
+    ((basic_string_vector){ \
+        BASIC_ARRAY_NULL, \
+        BASIC_VECTOR_NULL, \
+        0, \
+        0, \
+        BASIC_GROWTH_DOUBLE \
+    })
 
 static inline bool basic_string_vector_isnull(
         basic_string_vector const *string_vector);
@@ -30,17 +45,100 @@ basic_string_vector basic_string_vector_move(
 basic_string_vector basic_string_vector_clone(
         basic_string_vector const *string_vector);
 
-basic_string_vector basic_string_vector_new(size_t chunk_size, int chunk_cap);
+basic_string_vector basic_string_vector_new(size_t chunk_size, size_t chunk_cap);
 void basic_string_vector_destroy(basic_string_vector *string_vector);
 
+/**
+ * @brief Builds a basic_string_vector holding each @c delim separated
+ *  string in @c buffer, in order.
+ *
+ * A delimiter at the very end does not start another string, but one
+ * anywhere else does, so consecutive delimiters yield empty strings. The
+ * buffer is scanned for delimiters with SIMD where available, the chunks
+ * and offsets are allocated once at their final size, and each string is
+ * copied once. Strings containing NUL read back only up to the NUL.
+ *
+ * @returns A basic_string_vector with @c chunk_size byte chunks, or
+ *  @ref BASIC_STRING_VECTOR_NULL if an allocation failed.
+ */
+basic_string_vector basic_string_vector_from_buffer(
+        basic_span const *buffer,
+        char delim,
+        size_t chunk_size);
+
+/**
+ * @brief Builds a basic_string_vector from the contents of the file at
+ *  @c path as @ref basic_string_vector_from_buffer does.
+ *
+ * If @c map_file is true the file is memory-mapped and the strings are
+ * copied straight out of the page cache. Otherwise, or if the file cannot
+ * be mapped (a pipe, say), it is read into a temporary buffer first.
+ *
+ * @returns A basic_string_vector, or @ref BASIC_STRING_VECTOR_NULL if the
+ *  file could not be read or an allocation failed.
+ */
+basic_string_vector basic_string_vector_from_file(
+        char const *path,
+        char delim,
+        size_t chunk_size,
+        bool map_file);
+
+void basic_string_vector_set_growth(
+        basic_string_vector *string_vector,
+        basic_growth_policy growth);
+
+/**
+ * @brief Makes room for at least @c chunk_cap chunks and @c string_cap
+ *  strings, so that inserts within both need not reallocate.
+ *
+ * Each string takes its length divided by the chunk size, plus one,
+ * chunks. Like @ref basic_vector_reserve, this allocates exactly what is
+ * asked for and never shrinks.
+ *
+ * @retval true On success.
+ * @retval false If an allocation failed. The strings are unchanged.
+ */
+bool basic_string_vector_reserve(
+        basic_string_vector *string_vector,
+        size_t chunk_cap,
+        size_t string_cap);
+
+bool basic_string_vector_shrink_to_fit(basic_string_vector *string_vector);
+
 bool basic_string_vector_insert(
         basic_string_vector *string_vector,
-        int index,
+        size_t index,
         char const *string);
 
+/**
+ * @brief Inserts copies of the @c count strings at @c strings so that the
+ *  first is at @c index, keeping their order.
+ *
+ * The chunks needed by all the strings are counted first, so the chunks
+ * and the offset index grow at most once each and the strings after
+ * @c index are shifted once, rather than once per string.
+ *
+ * @retval true On success.
+ * @retval false If an allocation failed. The strings are unchanged.
+ */
+bool basic_string_vector_insert_many(
+        basic_string_vector *string_vector,
+        size_t index,
+        char const *const *strings,
+        size_t count);
+
+/**
+ * @brief Appends copies of the @c count strings at @c strings, as
+ *  @ref basic_string_vector_insert_many does.
+ */
+static inline bool basic_string_vector_append(
+        basic_string_vector *string_vector,
+        char const *const *strings,
+        size_t count);
+
 void basic_string_vector_remove(
         basic_string_vector *string_vector,
-        int index);
+        size_t index);
 
 static inline bool basic_string_vector_insertback(
         basic_string_vector *string_vector,
@@ -58,7 +156,31 @@ static inline void basic_string_vector_removeback(
 
 char const *basic_string_vector_at(
         basic_string_vector const *string_vector,
-        int index);
+        size_t index);
+
+/**
+ * @brief Sorts the strings into strcmp order.
+ *
+ * The strings are ordered by a multikey quicksort that partitions on eight
+ * bytes at a time, cached beside a pointer to each string, so a shared
+ * prefix is read once rather than once per comparison. The chunks are then
+ * copied into a new array in sorted order in a single pass, so while
+ * sorting the basic_string_vector needs room for a second copy of its
+ * chunks and 24 bytes per string.
+ *
+ * @returns True on success, or false if an allocation failed, in which case
+ *  the basic_string_vector is unchanged.
+ */
+bool basic_string_vector_sort(basic_string_vector *string_vector);
+
+/**
+ * @brief Returns the index of the first string that does not compare less
+ *  than @c string, or the string count if there is none. The strings must
+ *  be in strcmp order.
+ */
+size_t basic_string_vector_lower_bound(
+        basic_string_vector const *string_vector,
+        char const *string);
 
 static inline char const *basic_string_vector_front(
         basic_string_vector const *string_vector);
@@ -70,6 +192,7 @@ bool basic_string_vector_isnull(basic_string_vector const *string_vector)
 {
     BASIC_ASSERT_PTR_NONNULL(string_vector);
     return basic_array_isnull(&string_vector->chunk_data)
+        && basic_vector_isnull(&string_vector->string_offsets)
         && !string_vector->chunk_count
         && !string_vector->string_count;
 }
@@ -78,8 +201,9 @@ bool basic_string_vector_isinit(basic_string_vector const *string_vector)
 {
     BASIC_ASSERT_PTR_NONNULL(string_vector);
     return basic_array_isinit(&string_vector->chunk_data)
-        && string_vector->chunk_count >= 0
-        && string_vector->string_count >= 0
+        && basic_vector_isinit(&string_vector->string_offsets)
+        && string_vector->string_offsets.elem_count
+            == string_vector->string_count
         && string_vector->string_count <= string_vector->chunk_count;
 }
 
@@ -101,6 +225,19 @@ bool basic_string_vector_insertback(
             string);
 }
 
+bool basic_string_vector_append(
+        basic_string_vector *string_vector,
+        char const *const *strings,
+        size_t count)
+{
+    BASIC_ASSERT_PTR_NONNULL(string_vector);
+    return basic_string_vector_insert_many(
+            string_vector,
+            string_vector->string_count,
+            strings,
+            count);
+}
+
 bool basic_string_vector_insertfront(
         basic_string_vector *string_vector,
         char const *string)
@@ -116,7 +253,8 @@ void basic_string_vector_removefront(basic_string_vector *string_vector)
 void basic_string_vector_removeback(basic_string_vector *string_vector)
 {
     BASIC_ASSERT_PTR_NONNULL(string_vector);
-    basic_string_vector_remove(string_vector, string_vector->string_count);
+    basic_string_vector_remove(string_vector,
+            string_vector->string_count - 1);
 }
 
 char const *basic_string_vector_front(
@@ -128,7 +266,8 @@ char const *basic_string_vector_front(
 char const *basic_string_vector_back(basic_string_vector const *string_vector)
 {
     BASIC_ASSERT_PTR_NONNULL(string_vector);
-    return basic_string_vector_at(string_vector, string_vector->string_count);
+    return basic_string_vector_at(string_vector,
+            string_vector->string_count - 1);
 }
 
 #endif // BASIC_STRING_VECTOR_H_
@@ -6,18 +6,25 @@
 #define BASIC_VECTOR_H_
 
 #include <stdbool.h>
+#include <stddef.h>
 
 #include "assertion.h"
 #include "array.h"
+#include "bitset.h"
+#include "growth.h"
 #include "span.h"
 
 typedef struct {
     basic_array data;
-    int elem_count;
-    int elem_cap;
+    size_t elem_count;
+    size_t elem_cap;
+    basic_growth_policy growth;
 } basic_vector;
 
-#define BASIC_VECTOR_NULL ((basic_vector){BASIC_ARRAY_NULL, 0, 0})
+#define BASIC_VECTOR_NULL \
+    ((basic_vector){BASIC_ARRAY_NULL, 0, 0, BASIC_GROWTH_DOUBLE})
+
+typedef bool (*basic_vector_pred)(void const *elem, void *ctx);
 
 static inline bool basic_vector_isnull(basic_vector const *vector);
 static inline bool basic_vector_isinit(basic_vector const *vector);
@@ -26,21 +33,58 @@ static inline bool basic_vector_isempty(basic_vector const *vector);
 basic_vector basic_vector_move(basic_vector *vector);
 basic_vector basic_vector_clone(basic_vector const *vector);
 
-basic_vector basic_vector_new(size_t elem_size, int initial_cap);
+basic_vector basic_vector_new(size_t elem_size, size_t initial_cap);
 void basic_vector_destroy(basic_vector *vector);
 
-bool basic_vector_insert(basic_vector *vector, int index, void *elem);
-void basic_vector_remove(basic_vector *vector, int index);
+void basic_vector_set_growth(
+        basic_vector *vector,
+        basic_growth_policy growth);
+
+bool basic_vector_reserve(basic_vector *vector, size_t elem_cap);
+bool basic_vector_shrink_to_fit(basic_vector *vector);
+
+bool basic_vector_insert(basic_vector *vector, size_t index, void *elem);
+void basic_vector_remove(basic_vector *vector, size_t index);
+
+bool basic_vector_insert_range(
+        basic_vector *vector,
+        size_t index,
+        void const *src,
+        size_t count);
+
+static inline bool basic_vector_append(
+        basic_vector *vector,
+        void const *src,
+        size_t count);
+
+void basic_vector_remove_range(basic_vector *vector, size_t index, size_t count);
+
+void *basic_vector_emplace(basic_vector *vector, size_t index);
+static inline void *basic_vector_emplace_back(basic_vector *vector);
+basic_span basic_vector_emplace_back_n(basic_vector *vector, size_t count);
+
+size_t basic_vector_remove_if(
+        basic_vector *vector,
+        basic_vector_pred pred,
+        void *ctx);
+
+size_t basic_vector_retain(
+        basic_vector *vector,
+        basic_vector_pred pred,
+        void *ctx);
+
+size_t basic_vector_dedup(basic_vector *vector);
+size_t basic_vector_compact(basic_vector *vector, basic_bitset const *mask);
 
 static inline bool basic_vector_insertfront(basic_vector *vector, void *elem);
 static inline bool basic_vector_insertback(basic_vector *vector, void *elem);
 static inline void basic_vector_removefront(basic_vector *vector);
 static inline void basic_vector_removeback(basic_vector *vector);
 
-void *basic_vector_at(basic_vector *vector, int index);
-void const *basic_vector_at_c(basic_vector const *vector, int index);
+void *basic_vector_at(basic_vector *vector, size_t index);
+void const *basic_vector_at_c(basic_vector const *vector, size_t index);
 
-basic_span basic_vector_get(basic_vector *vector, int index);
+basic_span basic_vector_get(basic_vector *vector, size_t index);
 
 static inline void *basic_vector_front(basic_vector *vector);
 static inline void const *basic_vector_front_c(basic_vector const *vector);
@@ -59,7 +103,6 @@ bool basic_vector_isinit(basic_vector const *vector)
 {
     BASIC_ASSERT_PTR_NONNULL(vector);
     return basic_array_isinit(&vector->data)
-        && vector->elem_count >= 0
         && vector->elem_cap > 0
         && (vector->elem_cap >= vector->elem_count);
 }
@@ -81,6 +124,18 @@ bool basic_vector_insertback(basic_vector *vector, void *elem)
     return basic_vector_insert(vector, vector->elem_count, elem);
 }
 
+bool basic_vector_append(basic_vector *vector, void const *src, size_t count)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return basic_vector_insert_range(vector, vector->elem_count, src, count);
+}
+
+void *basic_vector_emplace_back(basic_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    return basic_vector_emplace(vector, vector->elem_count);
+}
+
 void basic_vector_removefront(basic_vector *vector)
 {
     basic_vector_remove(vector, 0);
@@ -1,9 +1,43 @@
 #include "array.h"
 
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#endif
+
+#include "bits.h"
+
+enum {
+    prefetch_distance = BASIC_ARRAY_PREFETCH_DISTANCE
+};
+
 #ifdef BASIC_DEBUG
-static int valid_index(basic_array const *array, int index);
+static int valid_index(basic_array const *array, size_t index);
 #endif
 
+static void copy_elem(void *dest, void const *src, size_t elem_size);
+static bool is_marked(uint64_t const *marks, size_t index);
+
+static void prefetch_read(
+        basic_array const *array,
+        size_t const *indices,
+        size_t from,
+        size_t to);
+
+static void prefetch_write(
+        basic_array const *array,
+        size_t const *indices,
+        size_t from,
+        size_t to);
+
+static size_t gather_simd(
+        basic_array *dest,
+        basic_array const *src,
+        size_t const *indices,
+        size_t n);
+
 basic_array basic_array_move(basic_array *array)
 {
     BASIC_ASSERT_PTR_NONNULL(array);
@@ -36,11 +70,15 @@ basic_array basic_array_clone(basic_array const *array)
     };
 }
 
-basic_array basic_array_alloc(size_t elem_size, int elem_count)
+basic_array basic_array_alloc(size_t elem_size, size_t elem_count)
 {
     BASIC_ASSERT_NONZERO(elem_size);
     BASIC_ASSERT_POSITIVE(elem_count);
 
+    if (elem_count > SIZE_MAX / elem_size) {
+        return BASIC_ARRAY_NULL;
+    }
+
     basic_block data = basic_block_alloc(elem_size * elem_count);
     if (basic_block_isnull(&data)) {
         return BASIC_ARRAY_NULL;
@@ -52,13 +90,17 @@ basic_array basic_array_alloc(size_t elem_size, int elem_count)
     };
 }
 
-basic_array *basic_array_realloc(basic_array *array, int elem_count)
+basic_array *basic_array_realloc(basic_array *array, size_t elem_count)
 {
     BASIC_ASSERT_PTR_NONNULL(array);
     BASIC_ASSERT_POSITIVE(elem_count);
     BASIC_ASSERT(basic_array_isinit(array),
             "basic_array object must be initialised");
 
+    if (elem_count > SIZE_MAX / array->elem_size) {
+        return NULL;
+    }
+
     size_t const data_size = array->elem_size * elem_count;
     basic_block *data = basic_block_realloc(&array->data, data_size);
     return data ? array : NULL;
@@ -111,22 +153,21 @@ basic_block basic_array_toblock(basic_array *array)
     return data;
 }
 
-void *basic_array_at(basic_array *array, int index)
+void *basic_array_at(basic_array *array, size_t index)
 {
     BASIC_ASSERT_PTR_NONNULL(array);
     BASIC_ASSERT(basic_array_isinit(array),
             "basic_array object must be initialised");
-    BASIC_ASSERT(valid_index(array, index), "index %d is invalid", index);
-    return (void *)((char *)array->data.ptr
-            + (size_t)index * array->elem_size);
+    BASIC_ASSERT(valid_index(array, index), "index %zu is invalid", index);
+    return (void *)((char *)array->data.ptr + index * array->elem_size);
 }
 
-basic_span basic_array_get(basic_array *array, int index)
+basic_span basic_array_get(basic_array *array, size_t index)
 {
     BASIC_ASSERT_PTR_NONNULL(array);
     BASIC_ASSERT(basic_array_isinit(array),
             "basic_array object must be initialised");
-    BASIC_ASSERT(valid_index(array, index), "index %d is invalid", index);
+    BASIC_ASSERT(valid_index(array, index), "index %zu is invalid", index);
 
     return (basic_span){
         .ptr = (void *)((char *)array->data.ptr + index * array->elem_size),
@@ -134,17 +175,265 @@ basic_span basic_array_get(basic_array *array, int index)
     };
 }
 
-void const *basic_array_at_c(basic_array const *array, int index)
+void const *basic_array_at_c(basic_array const *array, size_t index)
 {
     BASIC_ASSERT_PTR_NONNULL(array);
     BASIC_ASSERT(basic_array_isinit(array),
             "basic_array object must be initialised");
-    BASIC_ASSERT(valid_index(array, index), "index %d is invalid", index);
+    BASIC_ASSERT(valid_index(array, index), "index %zu is invalid", index);
     return (void const *)((char const *)array->data.ptr
-            + (size_t)index * array->elem_size);
+            + index * array->elem_size);
+}
+
+void basic_array_gather(
+        basic_array *dest,
+        basic_array const *src,
+        size_t const *indices,
+        size_t n)
+{
+    BASIC_ASSERT_PTR_NONNULL(dest);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT_PTR_NONNULL(indices);
+    BASIC_ASSERT(basic_array_isinit(dest) && basic_array_isinit(src),
+            "basic_array objects must be initialised");
+    BASIC_ASSERT(dest->elem_size == src->elem_size,
+            "element sizes differ (%zu, %zu)",
+            dest->elem_size, src->elem_size);
+    BASIC_ASSERT(n <= basic_array_cap(dest),
+            "gather count %zu out of range", n);
+
+    for (size_t i = 0; i < n; ++i) {
+        BASIC_ASSERT(valid_index(src, indices[i]),
+                "index %zu is invalid", indices[i]);
+    }
+
+    size_t const elem_size = src->elem_size;
+    char *const dest_base = dest->data.ptr;
+    char const *const src_base = src->data.ptr;
+
+    // Prime the prefetcher with the first window of source elements; each
+    // iteration below then requests the element prefetch_distance ahead, so
+    // that many cache misses are in flight at once
+    prefetch_read(src, indices, 0, n < prefetch_distance ? n : prefetch_distance);
+
+    size_t i = gather_simd(dest, src, indices, n);
+    for (; i < n; ++i) {
+        if (i + prefetch_distance < n) {
+            prefetch_read(src, indices,
+                    i + prefetch_distance, i + prefetch_distance + 1);
+        }
+
+        copy_elem(dest_base + i * elem_size,
+                src_base + indices[i] * elem_size,
+                elem_size);
+    }
+}
+
+void basic_array_scatter(
+        basic_array *dest,
+        basic_array const *src,
+        size_t const *indices,
+        size_t n)
+{
+    BASIC_ASSERT_PTR_NONNULL(dest);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT_PTR_NONNULL(indices);
+    BASIC_ASSERT(basic_array_isinit(dest) && basic_array_isinit(src),
+            "basic_array objects must be initialised");
+    BASIC_ASSERT(dest->elem_size == src->elem_size,
+            "element sizes differ (%zu, %zu)",
+            dest->elem_size, src->elem_size);
+    BASIC_ASSERT(n <= basic_array_cap(src),
+            "scatter count %zu out of range", n);
+
+    for (size_t i = 0; i < n; ++i) {
+        BASIC_ASSERT(valid_index(dest, indices[i]),
+                "index %zu is invalid", indices[i]);
+    }
+
+    size_t const elem_size = src->elem_size;
+    char *const dest_base = dest->data.ptr;
+    char const *const src_base = src->data.ptr;
+
+    // AVX2 has no scatter instruction, so the stores are scalar; the
+    // destination lines are prefetched for writing instead
+    prefetch_write(dest, indices, 0,
+            n < prefetch_distance ? n : prefetch_distance);
+
+    for (size_t i = 0; i < n; ++i) {
+        if (i + prefetch_distance < n) {
+            prefetch_write(dest, indices,
+                    i + prefetch_distance, i + prefetch_distance + 1);
+        }
+
+        copy_elem(dest_base + indices[i] * elem_size,
+                src_base + i * elem_size,
+                elem_size);
+    }
 }
 
-int valid_index(basic_array const *array, int index)
+bool basic_array_permute(
+        basic_array *array,
+        size_t const *perm,
+        size_t n)
 {
-    return (index >= 0) && (index < basic_array_cap(array));
+    BASIC_ASSERT_PTR_NONNULL(array);
+    BASIC_ASSERT_PTR_NONNULL(perm);
+    BASIC_ASSERT(basic_array_isinit(array),
+            "basic_array object must be initialised");
+    BASIC_ASSERT(n <= basic_array_cap(array),
+            "permute count %zu out of range", n);
+
+    if (!n) {
+        return true;
+    }
+
+    size_t const elem_size = array->elem_size;
+    char *const base = array->data.ptr;
+
+    // The visited marks are kept in a plain word block rather than a
+    // basic_bitset, whose bit count is an int
+    basic_block visited = basic_block_alloc(
+            (n + BASIC_BITS_PER_WORD - 1) / BASIC_BITS_PER_WORD
+            * sizeof(uint64_t));
+    if (basic_block_isnull(&visited)) {
+        return false;
+    }
+
+    basic_block temp = basic_block_alloc(elem_size);
+    if (basic_block_isnull(&temp)) {
+        basic_block_dealloc(&visited);
+        return false;
+    }
+
+    uint64_t *const marks = visited.ptr;
+
+    // Follow each cycle of the permutation, so that every element is moved
+    // exactly once. Within a cycle the element two steps ahead is
+    // prefetched while the current one is copied.
+    for (size_t start = 0; start < n; ++start) {
+        if (is_marked(marks, start)) {
+            continue;
+        }
+
+        memcpy(temp.ptr, base + start * elem_size, elem_size);
+
+        size_t index = start;
+        for (;;) {
+            size_t const next = perm[index];
+            BASIC_ASSERT(next < n && !is_marked(marks, index),
+                    "perm is not a permutation of [0, %zu)", n);
+
+            marks[index / BASIC_BITS_PER_WORD]
+                |= UINT64_C(1) << (index % BASIC_BITS_PER_WORD);
+            if (next == start) {
+                memcpy(base + index * elem_size, temp.ptr, elem_size);
+                break;
+            }
+
+            BASIC_PREFETCH_READ(base + perm[next] * elem_size);
+            memcpy(base + index * elem_size,
+                    base + next * elem_size,
+                    elem_size);
+            index = next;
+        }
+    }
+
+    basic_block_dealloc(&temp);
+    basic_block_dealloc(&visited);
+    return true;
+}
+
+int valid_index(basic_array const *array, size_t index)
+{
+    return index < basic_array_cap(array);
+}
+
+bool is_marked(uint64_t const *marks, size_t index)
+{
+    return (marks[index / BASIC_BITS_PER_WORD]
+            >> (index % BASIC_BITS_PER_WORD)) & 1;
+}
+
+void copy_elem(void *dest, void const *src, size_t elem_size)
+{
+    // Fixed-size copies of the common element sizes compile to single moves
+    switch (elem_size) {
+    case sizeof(uint32_t):  memcpy(dest, src, sizeof(uint32_t)); break;
+    case sizeof(uint64_t):  memcpy(dest, src, sizeof(uint64_t)); break;
+    default:                memcpy(dest, src, elem_size); break;
+    }
+}
+
+void prefetch_read(
+        basic_array const *array,
+        size_t const *indices,
+        size_t from,
+        size_t to)
+{
+    char const *const base = array->data.ptr;
+    for (size_t i = from; i < to; ++i) {
+        BASIC_PREFETCH_READ(base + indices[i] * array->elem_size);
+    }
+}
+
+void prefetch_write(
+        basic_array const *array,
+        size_t const *indices,
+        size_t from,
+        size_t to)
+{
+    char const *const base = array->data.ptr;
+    for (size_t i = from; i < to; ++i) {
+        BASIC_PREFETCH_WRITE(base + indices[i] * array->elem_size);
+    }
+}
+
+size_t gather_simd(
+        basic_array *dest,
+        basic_array const *src,
+        size_t const *indices,
+        size_t n)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    // Gathers whole vectors of 4- or 8-byte elements per instruction, four
+    // 64-bit indices at a time, prefetching the source elements one batch
+    // beyond the window primed by the caller. Returns the number of
+    // elements gathered, leaving the remainder to the scalar loop.
+    if (src->elem_size == sizeof(uint32_t)) {
+        int const *const base = src->data.ptr;
+        for (; i + 4 <= n; i += 4) {
+            size_t const ahead = i + prefetch_distance;
+            prefetch_read(src, indices,
+                    ahead < n ? ahead : n, ahead + 4 < n ? ahead + 4 : n);
+
+            __m256i const vindex =
+                _mm256_loadu_si256((__m256i const *)(indices + i));
+            __m128i const v = _mm256_i64gather_epi32(base, vindex, 4);
+            _mm_storeu_si128((__m128i *)((uint32_t *)dest->data.ptr + i), v);
+        }
+    } else if (src->elem_size == sizeof(uint64_t)) {
+        long long const *const base = src->data.ptr;
+        for (; i + 4 <= n; i += 4) {
+            size_t const ahead = i + prefetch_distance;
+            prefetch_read(src, indices,
+                    ahead < n ? ahead : n, ahead + 4 < n ? ahead + 4 : n);
+
+            __m256i const vindex =
+                _mm256_loadu_si256((__m256i const *)(indices + i));
+            __m256i const v = _mm256_i64gather_epi64(base, vindex, 8);
+            _mm256_storeu_si256(
+                    (__m256i *)((uint64_t *)dest->data.ptr + i), v);
+        }
+    }
+#else
+    (void) dest;
+    (void) src;
+    (void) indices;
+    (void) n;
+#endif
+
+    return i;
 }
@@ -0,0 +1,126 @@
+// Measures basic_concurrent_vector append throughput as the number of
+// appending threads grows, then checks that every appended value was
+// published exactly once.
+//
+// Usage: concurrent_vector [append_count [max_threads]]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "concurrent_vector.h"
+
+enum {
+    base_cap = 1024,
+    default_append_count = 20 * 1000 * 1000,
+    thread_limit = 64
+};
+
+typedef struct {
+    basic_concurrent_vector *vector;
+    int first;
+    int count;
+} worker;
+
+static void *append(void *arg);
+static bool verify(basic_concurrent_vector const *vector, int append_count);
+static double now(void);
+
+int main(int argc, char **argv)
+{
+    int const append_count = argc > 1
+        ? atoi(argv[1])
+        : default_append_count;
+    int const max_threads = argc > 2 && atoi(argv[2]) < thread_limit
+        ? atoi(argv[2])
+        : thread_limit;
+
+    printf("%-8s %12s %14s\n", "threads", "seconds", "appends/s");
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        basic_concurrent_vector vector =
+            basic_concurrent_vector_new(sizeof(uint64_t), base_cap);
+        if (basic_concurrent_vector_isnull(&vector)) {
+            fprintf(stderr, "failed to allocate basic_concurrent_vector\n");
+            return EXIT_FAILURE;
+        }
+
+        worker workers[thread_limit];
+        pthread_t ids[thread_limit];
+        int const share = append_count / threads;
+
+        double const start = now();
+        for (int i = 0; i < threads; ++i) {
+            workers[i] = (worker) {
+                .vector = &vector,
+                .first = share * i,
+                .count = i == threads - 1 ? append_count - share * i : share
+            };
+            pthread_create(&ids[i], NULL, append, &workers[i]);
+        }
+
+        for (int i = 0; i < threads; ++i) {
+            pthread_join(ids[i], NULL);
+        }
+        double const elapsed = now() - start;
+
+        printf("%-8d %12.3f %14.0f\n",
+                threads,
+                elapsed,
+                append_count / elapsed);
+
+        bool const ok = verify(&vector, append_count);
+        basic_concurrent_vector_destroy(&vector);
+        if (!ok) {
+            fprintf(stderr, "lost or duplicated appends\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void *append(void *arg)
+{
+    worker const *const self = arg;
+
+    for (int i = 0; i < self->count; ++i) {
+        uint64_t const value = (uint64_t)(self->first + i);
+        if (basic_concurrent_vector_append(self->vector, &value) < 0) {
+            fprintf(stderr, "append failed\n");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    return NULL;
+}
+
+bool verify(basic_concurrent_vector const *vector, int append_count)
+{
+    if (basic_concurrent_vector_count(vector) != append_count) {
+        return false;
+    }
+
+    uint64_t sum = 0;
+    for (int i = 0; i < append_count; ++i) {
+        uint64_t const *const elem = basic_concurrent_vector_at_c(vector, i);
+        if (!elem) {
+            return false;
+        }
+
+        sum += *elem;
+    }
+
+    return sum == (uint64_t)append_count * (uint64_t)(append_count - 1) / 2;
+}
+
+double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
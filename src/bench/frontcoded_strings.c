@@ -0,0 +1,118 @@
+// Compares the memory taken by a sorted basic_string_vector of URL-like keys
+// with that of basic_frontcoded_strings built from it at several bucket
+// sizes, and the time to look up every key in each.
+//
+// Usage: frontcoded_strings [string_count]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "frontcoded_strings.h"
+
+enum {
+    chunk_size = 16,
+    default_string_count = 1000 * 1000
+};
+
+static double now(void);
+
+int main(int argc, char **argv)
+{
+    int const string_count = argc > 1
+        ? atoi(argv[1])
+        : default_string_count;
+
+    basic_string_vector sorted = basic_string_vector_new(chunk_size, 1024);
+    if (basic_string_vector_isnull(&sorted)) {
+        fprintf(stderr, "failed to allocate basic_string_vector\n");
+        return EXIT_FAILURE;
+    }
+
+    static char const *const sections[] = {
+        "articles", "images/thumbnails", "products/catalogue", "users"
+    };
+    uint64_t state = 88172645463325252u;
+    char buf[128];
+    for (int i = 0; i < string_count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        snprintf(buf, sizeof(buf), "https://www.example.com/%s/%llu/page-%u",
+                sections[state % 4],
+                (unsigned long long)(state >> 40),
+                (unsigned)(state >> 8) % 100);
+        if (!basic_string_vector_insertback(&sorted, buf)) {
+            fprintf(stderr, "failed to append string\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (!basic_string_vector_sort(&sorted)) {
+        fprintf(stderr, "failed to sort strings\n");
+        return EXIT_FAILURE;
+    }
+
+    size_t const vector_memory = sorted.chunk_count * chunk_size
+        + sorted.string_count * sizeof(size_t);
+
+    double const vector_start = now();
+    size_t vector_sum = 0;
+    for (size_t i = 0; i < sorted.string_count; i += 7) {
+        vector_sum += basic_string_vector_lower_bound(&sorted,
+                basic_string_vector_at(&sorted, i));
+    }
+    double const vector_elapsed = now() - vector_start;
+    size_t const lookups = (sorted.string_count + 6) / 7;
+
+    printf("%-14s %12s %8s %14s\n", "layout", "bytes", "ratio", "ns/lookup");
+    printf("%-14s %12zu %8.2f %14.1f\n",
+            "string_vector",
+            vector_memory,
+            1.0,
+            vector_elapsed * 1e9 / lookups);
+
+    for (size_t bucket_size = 4; bucket_size <= 64; bucket_size *= 2) {
+        basic_frontcoded_strings strings =
+            basic_frontcoded_strings_new(&sorted, bucket_size);
+        if (basic_frontcoded_strings_isnull(&strings)) {
+            fprintf(stderr, "failed to allocate basic_frontcoded_strings\n");
+            return EXIT_FAILURE;
+        }
+
+        double const start = now();
+        size_t sum = 0;
+        for (size_t i = 0; i < sorted.string_count; i += 7) {
+            sum += basic_frontcoded_strings_lower_bound(&strings,
+                    basic_string_vector_at(&sorted, i));
+        }
+        double const elapsed = now() - start;
+
+        size_t const memory = basic_frontcoded_strings_memory(&strings);
+        snprintf(buf, sizeof(buf), "frontcoded/%zu", bucket_size);
+        printf("%-14s %12zu %8.2f %14.1f\n",
+                buf,
+                memory,
+                (double)vector_memory / (double)memory,
+                elapsed * 1e9 / lookups);
+
+        basic_frontcoded_strings_destroy(&strings);
+        if (sum != vector_sum) {
+            fprintf(stderr, "lookups disagree\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    basic_string_vector_destroy(&sorted);
+    return EXIT_SUCCESS;
+}
+
+double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
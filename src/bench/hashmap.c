@@ -0,0 +1,152 @@
+// Measures basic_hashmap insert, lookup hit, lookup miss and erase times
+// for uint64_t keys and values at sizes from 1K entries upwards. Small
+// sizes are repeated so that every measurement covers a similar number of
+// operations.
+//
+// Usage: hashmap [max_entries]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "hashmap.h"
+
+enum {
+    min_entries = 1000,
+    default_max_entries = 10 * 1000 * 1000,
+    ops_per_measurement = 10 * 1000 * 1000
+};
+
+static uint64_t hash_u64_key(basic_span const *key);
+static bool run(int entry_count);
+static double now(void);
+
+int main(int argc, char **argv)
+{
+    int const max_entries = argc > 1 ? atoi(argv[1]) : default_max_entries;
+
+    printf("%-12s %10s %10s %10s %10s   (ns/op)\n",
+            "entries", "insert", "hit", "miss", "erase");
+
+    for (int n = min_entries; n <= max_entries; n *= 10) {
+        if (!run(n)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+bool run(int entry_count)
+{
+    uint64_t *const keys = malloc((size_t)entry_count * sizeof *keys);
+    uint64_t *const probes = malloc((size_t)entry_count * sizeof *probes);
+    if (!keys || !probes) {
+        fprintf(stderr, "failed to allocate keys\n");
+        free(keys);
+        free(probes);
+        return false;
+    }
+
+    // basic_hash_u64 is a bijection, so these keys are distinct. The
+    // probes are the same keys shuffled, so lookups do not follow the
+    // insertion order.
+    for (int i = 0; i < entry_count; ++i) {
+        keys[i] = basic_hash_u64((uint64_t)i);
+        probes[i] = keys[i];
+    }
+
+    for (int i = entry_count - 1; i > 0; --i) {
+        int const j = (int)(basic_hash_u64((uint64_t)i << 32)
+                % (uint64_t)(i + 1));
+        uint64_t const temp = probes[i];
+        probes[i] = probes[j];
+        probes[j] = temp;
+    }
+
+    int const reps = ops_per_measurement / entry_count > 0
+        ? ops_per_measurement / entry_count
+        : 1;
+    double insert = 0;
+    double hit = 0;
+    double miss = 0;
+    double erase = 0;
+    uint64_t found = 0;
+    bool ok = true;
+
+    for (int rep = 0; rep < reps && ok; ++rep) {
+        basic_hashmap map = basic_hashmap_new(sizeof(uint64_t),
+                sizeof(uint64_t),
+                hash_u64_key,
+                0);
+        if (basic_hashmap_isnull(&map)) {
+            fprintf(stderr, "failed to allocate basic_hashmap\n");
+            ok = false;
+            break;
+        }
+
+        double start = now();
+        for (int i = 0; i < entry_count && ok; ++i) {
+            ok = basic_hashmap_insert(&map, &keys[i], &keys[i]);
+        }
+        insert += now() - start;
+
+        start = now();
+        for (int i = 0; i < entry_count; ++i) {
+            found += basic_hashmap_find_c(&map, &probes[i]) != NULL;
+        }
+        hit += now() - start;
+
+        start = now();
+        for (int i = 0; i < entry_count; ++i) {
+            uint64_t const absent = basic_hash_u64((uint64_t)(entry_count + i));
+            found += basic_hashmap_find_c(&map, &absent) != NULL;
+        }
+        miss += now() - start;
+
+        start = now();
+        for (int i = 0; i < entry_count; ++i) {
+            basic_hashmap_erase(&map, &probes[i]);
+        }
+        erase += now() - start;
+
+        ok = ok && basic_hashmap_isempty(&map);
+        basic_hashmap_destroy(&map);
+    }
+
+    free(keys);
+    free(probes);
+
+    // Every hit probe must have been found and no miss probe
+    if (!ok || found != (uint64_t)reps * (uint64_t)entry_count) {
+        fprintf(stderr, "inconsistent results at %d entries\n", entry_count);
+        return false;
+    }
+
+    double const ops = (double)reps * entry_count / 1e9;
+    printf("%-12d %10.1f %10.1f %10.1f %10.1f\n",
+            entry_count,
+            insert / ops,
+            hit / ops,
+            miss / ops,
+            erase / ops);
+    return true;
+}
+
+uint64_t hash_u64_key(basic_span const *key)
+{
+    uint64_t value;
+    memcpy(&value, key->ptr, sizeof value);
+    return basic_hash_u64(value);
+}
+
+double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,136 @@
+// Measures interning throughput as the number of threads grows. Each thread
+// interns a stream of strings drawn from a small vocabulary, as a tokenizer
+// or log parser would, so after the first few thousand operations nearly
+// every call finds its string without taking the writer lock.
+//
+// Also reports the bytes stored against the bytes interned, which is what
+// keeping each distinct string once saves.
+//
+// Usage: intern_table [op_count [max_threads]]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "intern_table.h"
+
+enum {
+    vocabulary_size = 4096,
+    default_op_count = 1000 * 1000,
+    thread_limit = 64
+};
+
+typedef struct {
+    basic_intern_table *table;
+    int seed;
+    int count;
+    size_t bytes;
+    bool failed;
+} worker;
+
+static void *intern_strings(void *arg);
+static double now(void);
+
+int main(int argc, char **argv)
+{
+    int const op_count = argc > 1
+        ? atoi(argv[1])
+        : default_op_count;
+    int const max_threads = argc > 2 && atoi(argv[2]) < thread_limit
+        ? atoi(argv[2])
+        : 8;
+
+    printf("%-8s %14s %14s %14s\n",
+            "threads", "interns/s", "bytes in", "bytes stored");
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        basic_intern_table table = basic_intern_table_new(1024);
+        if (basic_intern_table_isnull(&table)) {
+            fprintf(stderr, "failed to allocate basic_intern_table\n");
+            return EXIT_FAILURE;
+        }
+
+        pthread_t ids[thread_limit];
+        worker workers[thread_limit];
+        double const start = now();
+        for (int i = 0; i < threads; ++i) {
+            workers[i] = (worker){
+                .table = &table,
+                .seed = i,
+                .count = op_count / threads
+            };
+            pthread_create(&ids[i], NULL, intern_strings, &workers[i]);
+        }
+
+        size_t bytes = 0;
+        bool failed = false;
+        for (int i = 0; i < threads; ++i) {
+            pthread_join(ids[i], NULL);
+            bytes += workers[i].bytes;
+            failed |= workers[i].failed;
+        }
+        double const elapsed = now() - start;
+
+        size_t stored = 0;
+        for (int i = 0; i < basic_intern_table_count(&table); ++i) {
+            stored += basic_intern_table_get(&table, i).size + 1;
+        }
+
+        printf("%-8d %14.0f %14zu %14zu\n",
+                threads,
+                op_count / elapsed,
+                bytes,
+                stored);
+
+        bool const ok = !failed
+            && basic_intern_table_count(&table) <= vocabulary_size;
+        basic_intern_table_destroy(&table);
+        if (!ok) {
+            fprintf(stderr, "interned strings do not round-trip\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+void *intern_strings(void *arg)
+{
+    worker *const w = arg;
+    uint64_t state = (uint64_t)w->seed * 0x9e3779b97f4a7c15u + 1;
+    char buf[48];
+
+    for (int i = 0; i < w->count; ++i) {
+        // Skew the draw towards low words, as natural text is
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        int const word = (int)(state % vocabulary_size
+                % (1 + state / vocabulary_size % vocabulary_size));
+        int const size = snprintf(buf, sizeof(buf), "token-%d-of-the-stream",
+                word);
+
+        basic_span const string = {buf, (size_t)size};
+        int const id = basic_intern_table_intern(w->table, &string);
+        if (id < 0
+                || basic_intern_table_get(w->table, id).size != (size_t)size) {
+            w->failed = true;
+            return NULL;
+        }
+
+        w->bytes += (size_t)size + 1;
+    }
+
+    return NULL;
+}
+
+double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,216 @@
+// Measures basic_mpmc_queue throughput as the number of threads grows from
+// 1 to 64, half of them producers and half consumers, for single-element
+// and bulk operations. The consumers sum what they pop and the total is
+// checked against what was pushed.
+//
+// Usage: mpmc_queue [message_count [max_threads]]
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "mpmc_queue.h"
+
+enum {
+    queue_cap = 1024,
+    default_message_count = 10 * 1000 * 1000,
+    thread_limit = 64,
+    max_batch = 16
+};
+
+typedef struct {
+    basic_mpmc_queue *queue;
+    atomic_llong *remaining;
+    uint64_t first;
+    uint64_t count;
+    int batch;
+    uint64_t sum;
+} worker;
+
+static double run(int thread_count, int batch, uint64_t message_count);
+static void *produce(void *arg);
+static void *consume(void *arg);
+static void *produce_consume(void *arg);
+static double now(void);
+
+int main(int argc, char **argv)
+{
+    uint64_t const message_count = argc > 1
+        ? strtoull(argv[1], NULL, 10)
+        : default_message_count;
+    int const max_threads = argc > 2 && atoi(argv[2]) < thread_limit
+        ? atoi(argv[2])
+        : thread_limit;
+    int const batches[] = {1, max_batch};
+
+    printf("%-8s %-8s %12s %14s\n", "threads", "batch", "seconds", "ops/s");
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        for (size_t i = 0; i < sizeof batches / sizeof batches[0]; ++i) {
+            double const elapsed = run(threads, batches[i], message_count);
+            if (elapsed < 0) {
+                return EXIT_FAILURE;
+            }
+
+            printf("%-8d %-8d %12.3f %14.0f\n",
+                    threads,
+                    batches[i],
+                    elapsed,
+                    (double)message_count / elapsed);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+double run(int thread_count, int batch, uint64_t message_count)
+{
+    basic_mpmc_queue queue = basic_mpmc_queue_new(sizeof(uint64_t), queue_cap);
+    if (basic_mpmc_queue_isnull(&queue)) {
+        fprintf(stderr, "failed to allocate basic_mpmc_queue\n");
+        return -1;
+    }
+
+    int const producers = thread_count > 1 ? thread_count / 2 : 1;
+    int const consumers = thread_count > 1 ? thread_count - producers : 0;
+    atomic_llong remaining = (long long)message_count;
+    worker workers[thread_limit];
+    pthread_t threads[thread_limit];
+
+    // Producers push disjoint ranges of 0..message_count
+    uint64_t const share = message_count / (uint64_t)producers;
+    for (int i = 0; i < producers; ++i) {
+        workers[i] = (worker) {
+            .queue = &queue,
+            .remaining = &remaining,
+            .first = share * (uint64_t)i,
+            .count = i == producers - 1
+                ? message_count - share * (uint64_t)i
+                : share,
+            .batch = batch
+        };
+    }
+
+    for (int i = producers; i < producers + consumers; ++i) {
+        workers[i] = (worker) {
+            .queue = &queue,
+            .remaining = &remaining,
+            .batch = batch
+        };
+    }
+
+    double const start = now();
+    if (!consumers) {
+        pthread_create(&threads[0], NULL, produce_consume, &workers[0]);
+    } else {
+        for (int i = 0; i < producers + consumers; ++i) {
+            pthread_create(&threads[i],
+                    NULL,
+                    i < producers ? produce : consume,
+                    &workers[i]);
+        }
+    }
+
+    uint64_t sum = 0;
+    for (int i = 0; i < producers + consumers; ++i) {
+        pthread_join(threads[i], NULL);
+        sum += workers[i].sum;
+    }
+
+    double const elapsed = now() - start;
+    basic_mpmc_queue_destroy(&queue);
+
+    if (sum != message_count * (message_count - 1) / 2) {
+        fprintf(stderr, "lost or duplicated messages\n");
+        return -1;
+    }
+
+    return elapsed;
+}
+
+void *produce(void *arg)
+{
+    worker *const self = arg;
+    uint64_t batch[max_batch];
+
+    for (uint64_t next = 0; next < self->count; ) {
+        int n = self->batch;
+        if (self->count - next < (uint64_t)n) {
+            n = (int)(self->count - next);
+        }
+
+        for (int i = 0; i < n; ++i) {
+            batch[i] = self->first + next + (uint64_t)i;
+        }
+
+        basic_mpmc_queue_push_n(self->queue, batch, n);
+        next += (uint64_t)n;
+    }
+
+    return NULL;
+}
+
+void *consume(void *arg)
+{
+    worker *const self = arg;
+    uint64_t batch[max_batch];
+
+    while (atomic_load_explicit(self->remaining, memory_order_relaxed) > 0) {
+        int const n = basic_mpmc_queue_try_pop_n(self->queue,
+                batch,
+                self->batch);
+        if (!n) {
+            sched_yield();
+            continue;
+        }
+
+        atomic_fetch_sub_explicit(self->remaining, n, memory_order_relaxed);
+        for (int i = 0; i < n; ++i) {
+            self->sum += batch[i];
+        }
+    }
+
+    return NULL;
+}
+
+void *produce_consume(void *arg)
+{
+    worker *const self = arg;
+    uint64_t batch[max_batch];
+
+    // With a single thread, push a batch and pop it straight back
+    for (uint64_t next = 0; next < self->count; ) {
+        int n = self->batch;
+        if (self->count - next < (uint64_t)n) {
+            n = (int)(self->count - next);
+        }
+
+        for (int i = 0; i < n; ++i) {
+            batch[i] = self->first + next + (uint64_t)i;
+        }
+
+        basic_mpmc_queue_push_n(self->queue, batch, n);
+        basic_mpmc_queue_pop_n(self->queue, batch, n);
+
+        for (int i = 0; i < n; ++i) {
+            self->sum += batch[i];
+        }
+
+        next += (uint64_t)n;
+    }
+
+    return NULL;
+}
+
+double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,209 @@
+// Measures read throughput on a read-mostly vector as the number of reader
+// threads grows, comparing basic_rcu_vector snapshots against a vector
+// guarded by a pthread read-write lock. One writer thread republishes the
+// vector every few milliseconds in both cases.
+//
+// Usage: rcu_vector [read_count [max_threads]]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "rcu_vector.h"
+
+enum {
+    elem_count = 1024,
+    default_read_count = 2 * 1000 * 1000,
+    thread_limit = 64,
+    write_interval_ns = 2 * 1000 * 1000
+};
+
+typedef struct {
+    basic_rcu_vector rcu;
+    pthread_rwlock_t lock;
+    basic_vector locked;
+    atomic_bool done;
+} shared;
+
+typedef struct {
+    shared *shared;
+    int count;
+    uint64_t sum;
+} worker;
+
+static basic_vector make_version(uint64_t value);
+static double run(shared *s, int threads, int read_count, bool use_rcu);
+static void *read_rcu(void *arg);
+static void *read_locked(void *arg);
+static void *write_rcu(void *arg);
+static void *write_locked(void *arg);
+static void pause_writer(void);
+static double now(void);
+
+int main(int argc, char **argv)
+{
+    int const read_count = argc > 1
+        ? atoi(argv[1])
+        : default_read_count;
+    int const max_threads = argc > 2 && atoi(argv[2]) < thread_limit
+        ? atoi(argv[2])
+        : thread_limit;
+
+    shared s = {.locked = make_version(0)};
+    basic_vector initial = make_version(0);
+    s.rcu = basic_rcu_vector_new(&initial, thread_limit);
+    if (basic_rcu_vector_isnull(&s.rcu) || basic_vector_isnull(&s.locked)) {
+        fprintf(stderr, "failed to allocate vectors\n");
+        return EXIT_FAILURE;
+    }
+
+    pthread_rwlock_init(&s.lock, NULL);
+    printf("%-8s %14s %14s\n", "threads", "rwlock reads/s", "rcu reads/s");
+
+    for (int threads = 1; threads <= max_threads; threads *= 2) {
+        double const locked = run(&s, threads, read_count, false);
+        double const rcu = run(&s, threads, read_count, true);
+        printf("%-8d %14.0f %14.0f\n",
+                threads,
+                read_count / locked,
+                read_count / rcu);
+    }
+
+    pthread_rwlock_destroy(&s.lock);
+    basic_vector_destroy(&s.locked);
+    basic_rcu_vector_destroy(&s.rcu);
+    return EXIT_SUCCESS;
+}
+
+basic_vector make_version(uint64_t value)
+{
+    basic_vector vector = basic_vector_new(sizeof(uint64_t), elem_count);
+    for (int i = 0; i < elem_count; ++i) {
+        if (!basic_vector_insertback(&vector, &value)) {
+            basic_vector_destroy(&vector);
+            break;
+        }
+    }
+
+    return vector;
+}
+
+double run(shared *s, int threads, int read_count, bool use_rcu)
+{
+    worker workers[thread_limit];
+    pthread_t ids[thread_limit];
+    pthread_t writer;
+    int const share = read_count / threads;
+
+    atomic_store(&s->done, false);
+    pthread_create(&writer, NULL, use_rcu ? write_rcu : write_locked, s);
+
+    double const start = now();
+    for (int i = 0; i < threads; ++i) {
+        workers[i] = (worker) {
+            .shared = s,
+            .count = i == threads - 1 ? read_count - share * i : share
+        };
+        pthread_create(&ids[i], NULL,
+                use_rcu ? read_rcu : read_locked,
+                &workers[i]);
+    }
+
+    for (int i = 0; i < threads; ++i) {
+        pthread_join(ids[i], NULL);
+    }
+    double const elapsed = now() - start;
+
+    atomic_store(&s->done, true);
+    pthread_join(writer, NULL);
+    return elapsed;
+}
+
+void *read_rcu(void *arg)
+{
+    worker *const self = arg;
+    basic_rcu_vector *const rcu = &self->shared->rcu;
+    int const reader = basic_rcu_vector_register(rcu);
+
+    for (int i = 0; i < self->count; ++i) {
+        basic_vector const *const version =
+            basic_rcu_vector_read_lock(rcu, reader);
+        self->sum += ((uint64_t const *)version->data.data.ptr)[
+            (size_t)i % elem_count];
+        basic_rcu_vector_read_unlock(rcu, reader);
+    }
+
+    basic_rcu_vector_unregister(rcu, reader);
+    return NULL;
+}
+
+void *read_locked(void *arg)
+{
+    worker *const self = arg;
+    shared *const s = self->shared;
+
+    for (int i = 0; i < self->count; ++i) {
+        pthread_rwlock_rdlock(&s->lock);
+        self->sum += ((uint64_t const *)s->locked.data.data.ptr)[
+            (size_t)i % elem_count];
+        pthread_rwlock_unlock(&s->lock);
+    }
+
+    return NULL;
+}
+
+void *write_rcu(void *arg)
+{
+    shared *const s = arg;
+
+    for (uint64_t value = 1; !atomic_load(&s->done); ++value) {
+        basic_vector version = make_version(value);
+        if (basic_vector_isnull(&version)
+                || !basic_rcu_vector_publish(&s->rcu, &version)) {
+            basic_vector_destroy(&version);
+        }
+
+        pause_writer();
+    }
+
+    basic_rcu_vector_synchronize(&s->rcu);
+    return NULL;
+}
+
+void *write_locked(void *arg)
+{
+    shared *const s = arg;
+
+    for (uint64_t value = 1; !atomic_load(&s->done); ++value) {
+        basic_vector version = make_version(value);
+        if (!basic_vector_isnull(&version)) {
+            pthread_rwlock_wrlock(&s->lock);
+            basic_vector old = basic_vector_move(&s->locked);
+            s->locked = basic_vector_move(&version);
+            pthread_rwlock_unlock(&s->lock);
+            basic_vector_destroy(&old);
+        }
+
+        pause_writer();
+    }
+
+    return NULL;
+}
+
+void pause_writer(void)
+{
+    struct timespec const interval = {.tv_nsec = write_interval_ns};
+    nanosleep(&interval, NULL);
+}
+
+double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,168 @@
+// Measures basic_spsc_queue throughput between two threads, one element at a
+// time and in batches. The consumer checks that it sees every message in
+// order, so the benchmark doubles as a stress test of the memory ordering.
+// Either side yields when it makes no progress so that the benchmark still
+// finishes on machines with fewer cores than threads, but the numbers are
+// only meaningful with the two threads pinned to separate cores.
+//
+// Usage: spsc_queue [message_count [producer_cpu consumer_cpu]]
+
+#define _GNU_SOURCE
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "spsc_queue.h"
+
+enum {
+    queue_cap = 4096,
+    default_message_count = 50 * 1000 * 1000,
+    max_batch = 64
+};
+
+typedef struct {
+    basic_spsc_queue *queue;
+    int batch;
+    int cpu;
+    uint64_t message_count;
+    bool ok;
+} worker;
+
+static void pin(int cpu);
+static void *produce(void *arg);
+static void *consume(void *arg);
+static double now(void);
+
+int main(int argc, char **argv)
+{
+    uint64_t const message_count = argc > 1
+        ? strtoull(argv[1], NULL, 10)
+        : default_message_count;
+    int const producer_cpu = argc > 3 ? atoi(argv[2]) : -1;
+    int const consumer_cpu = argc > 3 ? atoi(argv[3]) : -1;
+    int const batches[] = {1, 8, 32, max_batch};
+
+    basic_spsc_queue queue = basic_spsc_queue_new(sizeof(uint64_t), queue_cap);
+    if (basic_spsc_queue_isnull(&queue)) {
+        fprintf(stderr, "failed to allocate basic_spsc_queue\n");
+        return EXIT_FAILURE;
+    }
+
+    printf("%-8s %12s %14s\n", "batch", "seconds", "messages/s");
+
+    int status = EXIT_SUCCESS;
+    for (size_t i = 0; i < sizeof batches / sizeof batches[0]; ++i) {
+        worker producer = {
+            &queue, batches[i], producer_cpu, message_count, true
+        };
+        worker consumer = {
+            &queue, batches[i], consumer_cpu, message_count, true
+        };
+        pthread_t threads[2];
+
+        double const start = now();
+        pthread_create(&threads[0], NULL, consume, &consumer);
+        pthread_create(&threads[1], NULL, produce, &producer);
+        pthread_join(threads[1], NULL);
+        pthread_join(threads[0], NULL);
+        double const elapsed = now() - start;
+
+        printf("%-8d %12.3f %14.0f\n",
+                batches[i],
+                elapsed,
+                (double)message_count / elapsed);
+
+        if (!consumer.ok) {
+            fprintf(stderr, "messages arrived out of order\n");
+            status = EXIT_FAILURE;
+        }
+    }
+
+    basic_spsc_queue_destroy(&queue);
+    return status;
+}
+
+void pin(int cpu)
+{
+#ifdef __linux__
+    if (cpu >= 0) {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+    }
+#else
+    (void) cpu;
+#endif
+}
+
+void *produce(void *arg)
+{
+    worker *const self = arg;
+    uint64_t batch[max_batch];
+    uint64_t next = 0;
+
+    pin(self->cpu);
+
+    while (next < self->message_count) {
+        int n = self->batch;
+        if (self->message_count - next < (uint64_t)n) {
+            n = (int)(self->message_count - next);
+        }
+
+        for (int i = 0; i < n; ++i) {
+            batch[i] = next + (uint64_t)i;
+        }
+
+        int pushed = 0;
+        while (pushed < n) {
+            int const count = basic_spsc_queue_push_n(self->queue,
+                    batch + pushed,
+                    n - pushed);
+            if (!count) {
+                sched_yield();
+            }
+
+            pushed += count;
+        }
+
+        next += (uint64_t)n;
+    }
+
+    return NULL;
+}
+
+void *consume(void *arg)
+{
+    worker *const self = arg;
+    uint64_t batch[max_batch];
+    uint64_t expected = 0;
+
+    pin(self->cpu);
+
+    while (expected < self->message_count) {
+        int const n = basic_spsc_queue_pop_n(self->queue, batch, self->batch);
+        if (!n) {
+            sched_yield();
+        }
+
+        for (int i = 0; i < n; ++i) {
+            if (batch[i] != expected++) {
+                self->ok = false;
+            }
+        }
+    }
+
+    return NULL;
+}
+
+double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,301 @@
+// Measures how long it takes to visit every string in a basic_string_vector
+// by index as the number of strings grows. Strings span a varying number of
+// chunks, so finding one cannot be done by arithmetic alone; the time per
+// string should stay flat as the count grows.
+//
+// Then compares loading max_strings newline-separated strings with
+// basic_string_vector_from_buffer against inserting them one by one.
+//
+// Then compares inserting a batch of strings into the middle with
+// basic_string_vector_insert_many against inserting them one by one.
+//
+// Finally compares basic_string_vector_sort against qsort with strcmp over
+// pointers to the same strings, which are random keys with a shared prefix.
+//
+// Usage: string_vector [max_strings]
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "string_vector.h"
+
+enum {
+    chunk_size = 8,
+    batch_size = 1000,
+    default_max_strings = 1000 * 1000,
+    min_strings = 1000 * 1000 / 16
+};
+
+static int load(int string_count);
+static int merge(int string_count);
+static int sort(int string_count);
+static int compare_strings(void const *a, void const *b);
+static double now(void);
+
+int main(int argc, char **argv)
+{
+    int const max_strings = argc > 1
+        ? atoi(argv[1])
+        : default_max_strings;
+
+    printf("%-10s %12s %14s\n", "strings", "seconds", "ns/string");
+
+    for (int count = min_strings < max_strings ? min_strings : max_strings;
+            count <= max_strings;
+            count *= 2) {
+        basic_string_vector string_vector =
+            basic_string_vector_new(chunk_size, 1024);
+        if (basic_string_vector_isnull(&string_vector)) {
+            fprintf(stderr, "failed to allocate basic_string_vector\n");
+            return EXIT_FAILURE;
+        }
+
+        // Lengths from 1 to 24 bytes take one to four chunks
+        char buf[32];
+        for (int i = 0; i < count; ++i) {
+            int const len = 1 + i % 24;
+            memset(buf, 'a' + i % 26, (size_t)len);
+            buf[len] = '\0';
+            if (!basic_string_vector_insertback(&string_vector, buf)) {
+                fprintf(stderr, "failed to append string\n");
+                return EXIT_FAILURE;
+            }
+        }
+
+        size_t total = 0;
+        double const start = now();
+        for (int i = 0; i < count; ++i) {
+            total += strlen(basic_string_vector_at(&string_vector, (size_t)i));
+        }
+        double const elapsed = now() - start;
+
+        printf("%-10d %12.4f %14.2f\n",
+                count,
+                elapsed,
+                elapsed * 1e9 / count);
+
+        basic_string_vector_destroy(&string_vector);
+        if (total != (size_t)(count / 24) * 300
+                + (size_t)(count % 24) * (size_t)(count % 24 + 1) / 2) {
+            fprintf(stderr, "strings read back wrongly\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    if (load(max_strings) != EXIT_SUCCESS
+            || merge(max_strings / 4) != EXIT_SUCCESS) {
+        return EXIT_FAILURE;
+    }
+
+    return sort(max_strings);
+}
+
+int load(int string_count)
+{
+    // Lines of 1 to 24 bytes, as above
+    size_t const size = (size_t)string_count * 26;
+    char *const text = malloc(size);
+    if (!text) {
+        fprintf(stderr, "failed to allocate text\n");
+        return EXIT_FAILURE;
+    }
+
+    size_t used = 0;
+    for (int i = 0; i < string_count; ++i) {
+        size_t const len = (size_t)(1 + i % 24);
+        memset(text + used, 'a' + i % 26, len);
+        used += len;
+        text[used++] = '\n';
+    }
+
+    double const insert_start = now();
+    basic_string_vector inserted = basic_string_vector_new(chunk_size, 1024);
+    for (size_t start = 0, end = 0; end < used; ++end) {
+        if (text[end] == '\n') {
+            text[end] = '\0';
+            basic_string_vector_insertback(&inserted, text + start);
+            text[end] = '\n';
+            start = end + 1;
+        }
+    }
+    double const insert_elapsed = now() - insert_start;
+
+    basic_span const buffer = {text, used};
+    double const load_start = now();
+    basic_string_vector loaded =
+        basic_string_vector_from_buffer(&buffer, '\n', chunk_size);
+    double const load_elapsed = now() - load_start;
+
+    printf("\n%-12s %12s %12s\n", "load", "seconds", "MB/s");
+    printf("%-12s %12.4f %12.0f\n",
+            "insertback",
+            insert_elapsed,
+            (double)used / insert_elapsed / 1e6);
+    printf("%-12s %12.4f %12.0f\n",
+            "from_buffer",
+            load_elapsed,
+            (double)used / load_elapsed / 1e6);
+
+    bool const ok = loaded.string_count == inserted.string_count
+        && loaded.chunk_count == inserted.chunk_count
+        && !memcmp(loaded.chunk_data.data.ptr,
+                inserted.chunk_data.data.ptr,
+                loaded.chunk_count * chunk_size);
+
+    basic_string_vector_destroy(&inserted);
+    basic_string_vector_destroy(&loaded);
+    free(text);
+
+    if (!ok) {
+        fprintf(stderr, "loaded strings differ from inserted ones\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int merge(int string_count)
+{
+    static char bufs[batch_size][32];
+    char const *batch[batch_size];
+    for (int i = 0; i < batch_size; ++i) {
+        snprintf(bufs[i], sizeof(bufs[i]), "inserted string %d", i);
+        batch[i] = bufs[i];
+    }
+
+    basic_string_vector one_by_one = basic_string_vector_new(chunk_size,
+            1024);
+    for (int i = 0; i < string_count; ++i) {
+        if (!basic_string_vector_insertback(&one_by_one, "base string")) {
+            fprintf(stderr, "failed to append string\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    basic_string_vector many = basic_string_vector_clone(&one_by_one);
+    size_t const middle = (size_t)string_count / 2;
+
+    double const insert_start = now();
+    for (int i = 0; i < batch_size; ++i) {
+        basic_string_vector_insert(&one_by_one, middle + (size_t)i, batch[i]);
+    }
+    double const insert_elapsed = now() - insert_start;
+
+    double const many_start = now();
+    bool const inserted = basic_string_vector_insert_many(&many,
+            middle,
+            batch,
+            batch_size);
+    double const many_elapsed = now() - many_start;
+
+    printf("\n%-12s %12s %12s\n", "merge", "seconds", "ns/string");
+    printf("%-12s %12.4f %12.1f\n",
+            "insert",
+            insert_elapsed,
+            insert_elapsed * 1e9 / batch_size);
+    printf("%-12s %12.4f %12.1f\n",
+            "insert_many",
+            many_elapsed,
+            many_elapsed * 1e9 / batch_size);
+
+    // Chunks may differ past the end of each string, so compare strings
+    bool ok = inserted
+        && many.string_count == one_by_one.string_count
+        && many.chunk_count == one_by_one.chunk_count;
+    for (size_t i = 0; ok && i < many.string_count; ++i) {
+        ok = !strcmp(basic_string_vector_at(&many, i),
+                basic_string_vector_at(&one_by_one, i));
+    }
+
+    basic_string_vector_destroy(&one_by_one);
+    basic_string_vector_destroy(&many);
+
+    if (!ok) {
+        fprintf(stderr, "batch differs from strings inserted one by one\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int sort(int string_count)
+{
+    basic_string_vector string_vector = basic_string_vector_new(chunk_size,
+            1024);
+    char const **const pointers = malloc((size_t)string_count
+            * sizeof(*pointers));
+    if (basic_string_vector_isnull(&string_vector) || !pointers) {
+        fprintf(stderr, "failed to allocate strings\n");
+        return EXIT_FAILURE;
+    }
+
+    uint64_t state = 88172645463325252u;
+    char buf[32];
+    for (int i = 0; i < string_count; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        snprintf(buf, sizeof(buf), "user:%llx",
+                (unsigned long long)(state >> state % 32));
+        if (!basic_string_vector_insertback(&string_vector, buf)) {
+            fprintf(stderr, "failed to append string\n");
+            return EXIT_FAILURE;
+        }
+    }
+
+    for (int i = 0; i < string_count; ++i) {
+        pointers[i] = basic_string_vector_at(&string_vector, (size_t)i);
+    }
+
+    double const qsort_start = now();
+    qsort(pointers, (size_t)string_count, sizeof(*pointers), compare_strings);
+    double const qsort_elapsed = now() - qsort_start;
+
+    // The pointers lead into string_vector, so sort a copy of it
+    basic_string_vector sorted = basic_string_vector_clone(&string_vector);
+    double const sort_start = now();
+    bool ok = basic_string_vector_sort(&sorted);
+    double const sort_elapsed = now() - sort_start;
+
+    printf("\n%-12s %12s %12s\n", "sort", "seconds", "ns/string");
+    printf("%-12s %12.4f %12.1f\n",
+            "qsort",
+            qsort_elapsed,
+            qsort_elapsed * 1e9 / string_count);
+    printf("%-12s %12.4f %12.1f\n",
+            "sort",
+            sort_elapsed,
+            sort_elapsed * 1e9 / string_count);
+
+    for (int i = 0; ok && i < string_count; ++i) {
+        ok = !strcmp(basic_string_vector_at(&sorted, (size_t)i), pointers[i]);
+    }
+
+    basic_string_vector_destroy(&sorted);
+    basic_string_vector_destroy(&string_vector);
+    free(pointers);
+
+    if (!ok) {
+        fprintf(stderr, "sorted strings differ from qsort\n");
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
+
+int compare_strings(void const *a, void const *b)
+{
+    return strcmp(*(char const *const *)a, *(char const *const *)b);
+}
+
+double now(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,169 @@
+#include "bits.h"
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+    #include <immintrin.h>
+#endif
+
+typedef enum {
+    bits_op_and,
+    bits_op_or,
+    bits_op_xor,
+    bits_op_andnot
+} bits_op;
+
+static inline void bits_apply(
+        uint64_t *dest,
+        uint64_t const *src,
+        int word_count,
+        bits_op op);
+
+static inline uint64_t bits_apply_word(uint64_t lhs, uint64_t rhs, bits_op op);
+
+int basic_bits_popcount_words(uint64_t const *words, int word_count)
+{
+    int i = 0;
+    int count = 0;
+
+#if defined(__AVX512F__) && defined(__AVX512VPOPCNTDQ__)
+    __m512i acc = _mm512_setzero_si512();
+    for (; i + 8 <= word_count; i += 8) {
+        __m512i const v = _mm512_loadu_si512((void const *)(words + i));
+        acc = _mm512_add_epi64(acc, _mm512_popcnt_epi64(v));
+    }
+
+    count += (int)_mm512_reduce_add_epi64(acc);
+#elif defined(__AVX2__)
+    // Nibble lookup popcount (Mula et al.): split each byte into nibbles,
+    // look up their counts with vpshufb and sum bytes into 64-bit lanes
+    __m256i const lookup = _mm256_setr_epi8(
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    __m256i const low_mask = _mm256_set1_epi8(0x0f);
+    __m256i acc = _mm256_setzero_si256();
+
+    for (; i + 4 <= word_count; i += 4) {
+        __m256i const v = _mm256_loadu_si256((__m256i const *)(words + i));
+        __m256i const lo = _mm256_and_si256(v, low_mask);
+        __m256i const hi = _mm256_and_si256(_mm256_srli_epi16(v, 4), low_mask);
+        __m256i const bytes = _mm256_add_epi8(
+                _mm256_shuffle_epi8(lookup, lo),
+                _mm256_shuffle_epi8(lookup, hi));
+        acc = _mm256_add_epi64(acc,
+                _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+
+    count += (int)(_mm256_extract_epi64(acc, 0)
+            + _mm256_extract_epi64(acc, 1)
+            + _mm256_extract_epi64(acc, 2)
+            + _mm256_extract_epi64(acc, 3));
+#endif
+
+    for (; i < word_count; ++i) {
+        count += basic_bits_popcount(words[i]);
+    }
+
+    return count;
+}
+
+void basic_bits_and(uint64_t *dest, uint64_t const *src, int word_count)
+{
+    bits_apply(dest, src, word_count, bits_op_and);
+}
+
+void basic_bits_or(uint64_t *dest, uint64_t const *src, int word_count)
+{
+    bits_apply(dest, src, word_count, bits_op_or);
+}
+
+void basic_bits_xor(uint64_t *dest, uint64_t const *src, int word_count)
+{
+    bits_apply(dest, src, word_count, bits_op_xor);
+}
+
+void basic_bits_andnot(uint64_t *dest, uint64_t const *src, int word_count)
+{
+    bits_apply(dest, src, word_count, bits_op_andnot);
+}
+
+int basic_bits_next(uint64_t const *words, int bit_count, int from)
+{
+    if (from >= bit_count) {
+        return -1;
+    }
+
+    int const word_count = basic_bits_words_for(bit_count);
+    int word_index = from / BASIC_BITS_PER_WORD;
+
+    // Mask off the bits below `from` in the first word, then skip over
+    // empty words until one has a set bit
+    uint64_t word = words[word_index]
+        & (~UINT64_C(0) << (from % BASIC_BITS_PER_WORD));
+
+    while (!word) {
+        if (++word_index == word_count) {
+            return -1;
+        }
+
+        word = words[word_index];
+    }
+
+    int const index = word_index * BASIC_BITS_PER_WORD + basic_bits_ctz(word);
+    return index < bit_count ? index : -1;
+}
+
+// The op argument is a constant at every call site, so after inlining the
+// switch in bits_apply_word is resolved at compile time
+void bits_apply(
+        uint64_t *dest,
+        uint64_t const *src,
+        int word_count,
+        bits_op op)
+{
+    int i = 0;
+
+#if defined(__AVX512F__)
+    for (; i + 8 <= word_count; i += 8) {
+        __m512i const d = _mm512_loadu_si512((void const *)(dest + i));
+        __m512i const s = _mm512_loadu_si512((void const *)(src + i));
+        __m512i r;
+
+        switch (op) {
+        case bits_op_and:       r = _mm512_and_si512(d, s); break;
+        case bits_op_or:        r = _mm512_or_si512(d, s); break;
+        case bits_op_xor:       r = _mm512_xor_si512(d, s); break;
+        default:                r = _mm512_andnot_si512(s, d); break;
+        }
+
+        _mm512_storeu_si512((void *)(dest + i), r);
+    }
+#elif defined(__AVX2__)
+    for (; i + 4 <= word_count; i += 4) {
+        __m256i const d = _mm256_loadu_si256((__m256i const *)(dest + i));
+        __m256i const s = _mm256_loadu_si256((__m256i const *)(src + i));
+        __m256i r;
+
+        switch (op) {
+        case bits_op_and:       r = _mm256_and_si256(d, s); break;
+        case bits_op_or:        r = _mm256_or_si256(d, s); break;
+        case bits_op_xor:       r = _mm256_xor_si256(d, s); break;
+        default:                r = _mm256_andnot_si256(s, d); break;
+        }
+
+        _mm256_storeu_si256((__m256i *)(dest + i), r);
+    }
+#endif
+
+    for (; i < word_count; ++i) {
+        dest[i] = bits_apply_word(dest[i], src[i], op);
+    }
+}
+
+uint64_t bits_apply_word(uint64_t lhs, uint64_t rhs, bits_op op)
+{
+    switch (op) {
+    case bits_op_and:       return lhs & rhs;
+    case bits_op_or:        return lhs | rhs;
+    case bits_op_xor:       return lhs ^ rhs;
+    default:                return lhs & ~rhs;
+    }
+}
@@ -0,0 +1,169 @@
+#include "bitset.h"
+
+#include <string.h>
+
+static uint64_t *bitset_words(basic_bitset *bitset);
+static uint64_t const *bitset_words_c(basic_bitset const *bitset);
+static void bitset_clear_tail(basic_bitset *bitset);
+
+basic_bitset basic_bitset_move(basic_bitset *bitset)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(basic_bitset_isinit(bitset),
+            "basic_bitset object must be initialised");
+
+    basic_bitset temp = *bitset;
+    *bitset = BASIC_BITSET_NULL;
+    return temp;
+}
+
+basic_bitset basic_bitset_clone(basic_bitset const *bitset)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(basic_bitset_isnull(bitset) || basic_bitset_isinit(bitset),
+            "basic_bitset object must be null or initialised");
+
+    if (basic_bitset_isnull(bitset)) {
+        return BASIC_BITSET_NULL;
+    }
+
+    basic_block words = basic_block_clone(&bitset->words);
+    if (basic_block_isnull(&words)) {
+        return BASIC_BITSET_NULL;
+    }
+
+    return (basic_bitset) {
+        .words = basic_block_move(&words),
+        .bit_count = bitset->bit_count
+    };
+}
+
+basic_bitset basic_bitset_new(int bit_count)
+{
+    BASIC_ASSERT_POSITIVE(bit_count);
+
+    size_t const size = (size_t)basic_bits_words_for(bit_count)
+        * sizeof(uint64_t);
+
+    basic_block words = basic_block_alloc(size);
+    if (basic_block_isnull(&words)) {
+        return BASIC_BITSET_NULL;
+    }
+
+    return (basic_bitset) {
+        .words = basic_block_move(&words),
+        .bit_count = bit_count
+    };
+}
+
+void basic_bitset_destroy(basic_bitset *bitset)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+
+    if (basic_bitset_isinit(bitset)) {
+        basic_block_dealloc(&bitset->words);
+        *bitset = BASIC_BITSET_NULL;
+    }
+}
+
+void basic_bitset_fill(basic_bitset *bitset, bool value)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(basic_bitset_isinit(bitset),
+            "basic_bitset object must be initialised");
+
+    memset(bitset->words.ptr, value ? 0xff : 0, bitset->words.size);
+    bitset_clear_tail(bitset);
+}
+
+int basic_bitset_count(basic_bitset const *bitset)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(basic_bitset_isinit(bitset),
+            "basic_bitset object must be initialised");
+
+    return basic_bits_popcount_words(bitset_words_c(bitset),
+            basic_bits_words_for(bitset->bit_count));
+}
+
+int basic_bitset_next(basic_bitset const *bitset, int from)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(basic_bitset_isinit(bitset),
+            "basic_bitset object must be initialised");
+    BASIC_ASSERT(from >= 0 && from <= bitset->bit_count,
+            "index %d out of range", from);
+
+    return basic_bits_next(bitset_words_c(bitset), bitset->bit_count, from);
+}
+
+void basic_bitset_and(basic_bitset *dest, basic_bitset const *src)
+{
+    BASIC_ASSERT_PTR_NONNULL(dest);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT(basic_bitset_isinit(dest) && basic_bitset_isinit(src),
+            "basic_bitset objects must be initialised");
+    BASIC_ASSERT(dest->bit_count == src->bit_count,
+            "bit counts differ (%d, %d)", dest->bit_count, src->bit_count);
+
+    basic_bits_and(bitset_words(dest), bitset_words_c(src),
+            basic_bits_words_for(dest->bit_count));
+}
+
+void basic_bitset_or(basic_bitset *dest, basic_bitset const *src)
+{
+    BASIC_ASSERT_PTR_NONNULL(dest);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT(basic_bitset_isinit(dest) && basic_bitset_isinit(src),
+            "basic_bitset objects must be initialised");
+    BASIC_ASSERT(dest->bit_count == src->bit_count,
+            "bit counts differ (%d, %d)", dest->bit_count, src->bit_count);
+
+    basic_bits_or(bitset_words(dest), bitset_words_c(src),
+            basic_bits_words_for(dest->bit_count));
+}
+
+void basic_bitset_xor(basic_bitset *dest, basic_bitset const *src)
+{
+    BASIC_ASSERT_PTR_NONNULL(dest);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT(basic_bitset_isinit(dest) && basic_bitset_isinit(src),
+            "basic_bitset objects must be initialised");
+    BASIC_ASSERT(dest->bit_count == src->bit_count,
+            "bit counts differ (%d, %d)", dest->bit_count, src->bit_count);
+
+    basic_bits_xor(bitset_words(dest), bitset_words_c(src),
+            basic_bits_words_for(dest->bit_count));
+}
+
+void basic_bitset_andnot(basic_bitset *dest, basic_bitset const *src)
+{
+    BASIC_ASSERT_PTR_NONNULL(dest);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT(basic_bitset_isinit(dest) && basic_bitset_isinit(src),
+            "basic_bitset objects must be initialised");
+    BASIC_ASSERT(dest->bit_count == src->bit_count,
+            "bit counts differ (%d, %d)", dest->bit_count, src->bit_count);
+
+    basic_bits_andnot(bitset_words(dest), bitset_words_c(src),
+            basic_bits_words_for(dest->bit_count));
+}
+
+uint64_t *bitset_words(basic_bitset *bitset)
+{
+    return (uint64_t *)bitset->words.ptr;
+}
+
+uint64_t const *bitset_words_c(basic_bitset const *bitset)
+{
+    return (uint64_t const *)bitset->words.ptr;
+}
+
+void bitset_clear_tail(basic_bitset *bitset)
+{
+    int const tail_bits = bitset->bit_count % BASIC_BITS_PER_WORD;
+    if (tail_bits) {
+        int const last = basic_bits_words_for(bitset->bit_count) - 1;
+        bitset_words(bitset)[last] &= (UINT64_C(1) << tail_bits) - 1;
+    }
+}
@@ -0,0 +1,255 @@
+#include "bitvector.h"
+
+#include <limits.h>
+#include <string.h>
+
+enum {
+    bitvector_grow_factor = 2
+};
+
+static int bitvector_cap(basic_bitvector const *bitvector);
+static basic_bitvector *bitvector_grow(basic_bitvector *bitvector, int min_cap);
+static void bitvector_clear_range(basic_bitvector *bitvector, int from, int to);
+static int round_to_words(int bit_count);
+
+basic_bitvector basic_bitvector_move(basic_bitvector *bitvector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(basic_bitvector_isinit(bitvector),
+            "basic_bitvector object must be initialised");
+
+    basic_bitvector temp = *bitvector;
+    *bitvector = BASIC_BITVECTOR_NULL;
+    return temp;
+}
+
+basic_bitvector basic_bitvector_clone(basic_bitvector const *bitvector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(basic_bitvector_isnull(bitvector)
+            || basic_bitvector_isinit(bitvector),
+            "basic_bitvector object must be null or initialised");
+
+    if (basic_bitvector_isnull(bitvector)) {
+        return BASIC_BITVECTOR_NULL;
+    }
+
+    basic_bitset bits = basic_bitset_clone(&bitvector->bits);
+    if (basic_bitset_isnull(&bits)) {
+        return BASIC_BITVECTOR_NULL;
+    }
+
+    return (basic_bitvector) {
+        .bits = basic_bitset_move(&bits),
+        .bit_count = bitvector->bit_count
+    };
+}
+
+basic_bitvector basic_bitvector_new(int initial_cap)
+{
+    BASIC_ASSERT_POSITIVE(initial_cap);
+
+    basic_bitset bits = basic_bitset_new(round_to_words(initial_cap));
+    if (basic_bitset_isnull(&bits)) {
+        return BASIC_BITVECTOR_NULL;
+    }
+
+    return (basic_bitvector) {
+        .bits = basic_bitset_move(&bits),
+        .bit_count = 0
+    };
+}
+
+void basic_bitvector_destroy(basic_bitvector *bitvector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+
+    if (basic_bitvector_isinit(bitvector)) {
+        basic_bitset_destroy(&bitvector->bits);
+        *bitvector = BASIC_BITVECTOR_NULL;
+    }
+}
+
+bool basic_bitvector_pushback(basic_bitvector *bitvector, bool value)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(basic_bitvector_isinit(bitvector),
+            "basic_bitvector object must be initialised");
+
+    if (bitvector->bit_count == bitvector_cap(bitvector)
+            && !bitvector_grow(bitvector, bitvector->bit_count + 1)) {
+        return false;
+    }
+
+    // The new bit is already clear, so only a set needs a write
+    if (value) {
+        basic_bitset_set(&bitvector->bits, bitvector->bit_count);
+    }
+
+    ++bitvector->bit_count;
+    return true;
+}
+
+void basic_bitvector_popback(basic_bitvector *bitvector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(basic_bitvector_isinit(bitvector)
+            && !basic_bitvector_isempty(bitvector),
+            "basic_bitvector object must be initialised and non-empty");
+
+    --bitvector->bit_count;
+    basic_bitset_clear(&bitvector->bits, bitvector->bit_count);
+}
+
+bool basic_bitvector_resize(basic_bitvector *bitvector, int bit_count)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(basic_bitvector_isinit(bitvector),
+            "basic_bitvector object must be initialised");
+    BASIC_ASSERT(bit_count >= 0, "bit_count %d must be non-negative",
+            bit_count);
+
+    if (bit_count > bitvector_cap(bitvector)
+            && !bitvector_grow(bitvector, bit_count)) {
+        return false;
+    }
+
+    // Keep the bits past bit_count clear when shrinking; bits gained by
+    // growing are already clear
+    if (bit_count < bitvector->bit_count) {
+        bitvector_clear_range(bitvector, bit_count, bitvector->bit_count);
+    }
+
+    bitvector->bit_count = bit_count;
+    return true;
+}
+
+int basic_bitvector_count(basic_bitvector const *bitvector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(basic_bitvector_isinit(bitvector),
+            "basic_bitvector object must be initialised");
+
+    return basic_bits_popcount_words(bitvector->bits.words.ptr,
+            basic_bits_words_for(bitvector->bit_count));
+}
+
+int basic_bitvector_next(basic_bitvector const *bitvector, int from)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitvector);
+    BASIC_ASSERT(basic_bitvector_isinit(bitvector),
+            "basic_bitvector object must be initialised");
+    BASIC_ASSERT(from >= 0 && from <= bitvector->bit_count,
+            "index %d out of range", from);
+
+    return basic_bits_next(bitvector->bits.words.ptr,
+            bitvector->bit_count,
+            from);
+}
+
+void basic_bitvector_and(basic_bitvector *dest, basic_bitvector const *src)
+{
+    BASIC_ASSERT_PTR_NONNULL(dest);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT(basic_bitvector_isinit(dest) && basic_bitvector_isinit(src),
+            "basic_bitvector objects must be initialised");
+    BASIC_ASSERT(dest->bit_count == src->bit_count,
+            "bit counts differ (%d, %d)", dest->bit_count, src->bit_count);
+
+    basic_bits_and(dest->bits.words.ptr, src->bits.words.ptr,
+            basic_bits_words_for(dest->bit_count));
+}
+
+void basic_bitvector_or(basic_bitvector *dest, basic_bitvector const *src)
+{
+    BASIC_ASSERT_PTR_NONNULL(dest);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT(basic_bitvector_isinit(dest) && basic_bitvector_isinit(src),
+            "basic_bitvector objects must be initialised");
+    BASIC_ASSERT(dest->bit_count == src->bit_count,
+            "bit counts differ (%d, %d)", dest->bit_count, src->bit_count);
+
+    basic_bits_or(dest->bits.words.ptr, src->bits.words.ptr,
+            basic_bits_words_for(dest->bit_count));
+}
+
+void basic_bitvector_xor(basic_bitvector *dest, basic_bitvector const *src)
+{
+    BASIC_ASSERT_PTR_NONNULL(dest);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT(basic_bitvector_isinit(dest) && basic_bitvector_isinit(src),
+            "basic_bitvector objects must be initialised");
+    BASIC_ASSERT(dest->bit_count == src->bit_count,
+            "bit counts differ (%d, %d)", dest->bit_count, src->bit_count);
+
+    basic_bits_xor(dest->bits.words.ptr, src->bits.words.ptr,
+            basic_bits_words_for(dest->bit_count));
+}
+
+void basic_bitvector_andnot(
+        basic_bitvector *dest,
+        basic_bitvector const *src)
+{
+    BASIC_ASSERT_PTR_NONNULL(dest);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT(basic_bitvector_isinit(dest) && basic_bitvector_isinit(src),
+            "basic_bitvector objects must be initialised");
+    BASIC_ASSERT(dest->bit_count == src->bit_count,
+            "bit counts differ (%d, %d)", dest->bit_count, src->bit_count);
+
+    basic_bits_andnot(dest->bits.words.ptr, src->bits.words.ptr,
+            basic_bits_words_for(dest->bit_count));
+}
+
+int bitvector_cap(basic_bitvector const *bitvector)
+{
+    return bitvector->bits.bit_count;
+}
+
+basic_bitvector *bitvector_grow(basic_bitvector *bitvector, int min_cap)
+{
+    // A step that would pass INT_MAX goes straight to min_cap instead
+    int new_cap = bitvector_cap(bitvector);
+    while (new_cap < min_cap) {
+        new_cap = new_cap > INT_MAX / bitvector_grow_factor
+            ? min_cap
+            : new_cap * bitvector_grow_factor;
+    }
+
+    // basic_block_realloc zero-fills the new words, which keeps the bits
+    // past bit_count clear
+    size_t const size = (size_t)basic_bits_words_for(new_cap)
+        * sizeof(uint64_t);
+    if (!basic_block_realloc(&bitvector->bits.words, size)) {
+        return NULL;
+    }
+
+    bitvector->bits.bit_count = new_cap;
+    return bitvector;
+}
+
+void bitvector_clear_range(basic_bitvector *bitvector, int from, int to)
+{
+    uint64_t *const words = bitvector->bits.words.ptr;
+    int const first_whole = basic_bits_words_for(from);
+    int const end_word = basic_bits_words_for(to);
+
+    if (from % BASIC_BITS_PER_WORD) {
+        words[from / BASIC_BITS_PER_WORD]
+            &= (UINT64_C(1) << (from % BASIC_BITS_PER_WORD)) - 1;
+    }
+
+    if (end_word > first_whole) {
+        memset(words + first_whole,
+                0,
+                (size_t)(end_word - first_whole) * sizeof(uint64_t));
+    }
+}
+
+int round_to_words(int bit_count)
+{
+    // Counts in the last partial word below INT_MAX cannot be rounded up
+    return bit_count > INT_MAX - (BASIC_BITS_PER_WORD - 1)
+        ? bit_count
+        : basic_bits_words_for(bit_count) * BASIC_BITS_PER_WORD;
+}
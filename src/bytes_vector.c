@@ -0,0 +1,184 @@
+#include "bytes_vector.h"
+
+#include <stdint.h>
+
+static size_t *offsets_of(basic_bytes_vector const *bytes_vector);
+
+static void offset_strings_from(
+        basic_bytes_vector *bytes_vector,
+        size_t offset_index,
+        size_t add,
+        size_t subtract);
+
+basic_bytes_vector basic_bytes_vector_move(basic_bytes_vector *bytes_vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    BASIC_ASSERT(basic_bytes_vector_isinit(bytes_vector),
+            "basic_bytes_vector object must be initialised");
+
+    basic_bytes_vector temp = *bytes_vector;
+    *bytes_vector = BASIC_BYTES_VECTOR_NULL;
+    return temp;
+}
+
+basic_bytes_vector basic_bytes_vector_clone(
+        basic_bytes_vector const *bytes_vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    BASIC_ASSERT(basic_bytes_vector_isnull(bytes_vector)
+            || basic_bytes_vector_isinit(bytes_vector),
+            "basic_bytes_vector object must be null or initialised");
+
+    if (basic_bytes_vector_isnull(bytes_vector)) {
+        return BASIC_BYTES_VECTOR_NULL;
+    }
+
+    basic_vector bytes = basic_vector_clone(&bytes_vector->bytes);
+    basic_vector offsets = basic_vector_clone(&bytes_vector->offsets);
+    if (basic_vector_isnull(&bytes) || basic_vector_isnull(&offsets)) {
+        basic_vector_destroy(&bytes);
+        basic_vector_destroy(&offsets);
+        return BASIC_BYTES_VECTOR_NULL;
+    }
+
+    return (basic_bytes_vector) {
+        .bytes = basic_vector_move(&bytes),
+        .offsets = basic_vector_move(&offsets)
+    };
+}
+
+basic_bytes_vector basic_bytes_vector_new(size_t byte_cap, size_t string_cap)
+{
+    BASIC_ASSERT_POSITIVE(byte_cap);
+    BASIC_ASSERT_POSITIVE(string_cap);
+
+    basic_vector bytes = basic_vector_new(1, byte_cap);
+    basic_vector offsets = basic_vector_new(sizeof(size_t), string_cap + 1);
+    if (basic_vector_isnull(&bytes) || basic_vector_isnull(&offsets)) {
+        basic_vector_destroy(&bytes);
+        basic_vector_destroy(&offsets);
+        return BASIC_BYTES_VECTOR_NULL;
+    }
+
+    // The first string starts at zero. The capacity was just allocated, so
+    // this cannot fail.
+    size_t start = 0;
+    basic_vector_insertback(&offsets, &start);
+
+    return (basic_bytes_vector) {
+        .bytes = basic_vector_move(&bytes),
+        .offsets = basic_vector_move(&offsets)
+    };
+}
+
+void basic_bytes_vector_destroy(basic_bytes_vector *bytes_vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    BASIC_ASSERT(basic_bytes_vector_isnull(bytes_vector)
+            || basic_bytes_vector_isinit(bytes_vector),
+            "basic_bytes_vector object must be null or initialised");
+
+    basic_vector_destroy(&bytes_vector->bytes);
+    basic_vector_destroy(&bytes_vector->offsets);
+    *bytes_vector = BASIC_BYTES_VECTOR_NULL;
+}
+
+bool basic_bytes_vector_insert(
+        basic_bytes_vector *bytes_vector,
+        size_t index,
+        basic_span const *string)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    BASIC_ASSERT_PTR_NONNULL(string);
+    BASIC_ASSERT(basic_bytes_vector_isinit(bytes_vector),
+            "basic_bytes_vector object must be initialised");
+    BASIC_ASSERT(index <= basic_bytes_vector_count(bytes_vector),
+            "index %zu out of range", index);
+    BASIC_ASSERT(string->ptr || !string->size,
+            "a non-empty string must have data");
+
+    size_t const start = offsets_of(bytes_vector)[index];
+    if (string->size > SIZE_MAX - bytes_vector->bytes.elem_count) {
+        return false;
+    }
+
+    // The new string ends where the string it displaces used to start, plus
+    // its own size
+    size_t end = start + string->size;
+    if (!basic_vector_insert(&bytes_vector->offsets, index + 1, &end)) {
+        return false;
+    }
+
+    if (string->size && !basic_vector_insert_range(&bytes_vector->bytes,
+                start,
+                string->ptr,
+                string->size)) {
+        basic_vector_remove(&bytes_vector->offsets, index + 1);
+        return false;
+    }
+
+    offset_strings_from(bytes_vector, index + 2, string->size, 0);
+    return true;
+}
+
+void basic_bytes_vector_remove(basic_bytes_vector *bytes_vector, size_t index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    BASIC_ASSERT(index < basic_bytes_vector_count(bytes_vector),
+            "index %zu out of range", index);
+
+    size_t const *const offsets = offsets_of(bytes_vector);
+    size_t const start = offsets[index];
+    size_t const size = offsets[index + 1] - start;
+
+    basic_vector_remove_range(&bytes_vector->bytes, start, size);
+    basic_vector_remove(&bytes_vector->offsets, index + 1);
+    offset_strings_from(bytes_vector, index + 1, 0, size);
+}
+
+basic_span basic_bytes_vector_get(
+        basic_bytes_vector const *bytes_vector,
+        size_t index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    BASIC_ASSERT(index < basic_bytes_vector_count(bytes_vector),
+            "index %zu out of range", index);
+
+    size_t const *const offsets = offsets_of(bytes_vector);
+    return (basic_span) {
+        .ptr = (unsigned char *)bytes_vector->bytes.data.data.ptr
+            + offsets[index],
+        .size = offsets[index + 1] - offsets[index]
+    };
+}
+
+size_t basic_bytes_vector_size(
+        basic_bytes_vector const *bytes_vector,
+        size_t index)
+{
+    BASIC_ASSERT_PTR_NONNULL(bytes_vector);
+    BASIC_ASSERT(index < basic_bytes_vector_count(bytes_vector),
+            "index %zu out of range", index);
+
+    size_t const *const offsets = offsets_of(bytes_vector);
+    return offsets[index + 1] - offsets[index];
+}
+
+size_t *offsets_of(basic_bytes_vector const *bytes_vector)
+{
+    return bytes_vector->offsets.data.data.ptr;
+}
+
+void offset_strings_from(
+        basic_bytes_vector *bytes_vector,
+        size_t offset_index,
+        size_t add,
+        size_t subtract)
+{
+    size_t *const offsets = offsets_of(bytes_vector);
+    size_t const offset_count = bytes_vector->offsets.elem_count;
+
+    for (size_t i = offset_index; i < offset_count; ++i) {
+        offsets[i] = offsets[i] + add - subtract;
+    }
+}
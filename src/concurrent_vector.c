@@ -0,0 +1,277 @@
+#include "concurrent_vector.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bits.h"
+#include "block.h"
+
+static int segment_of(basic_concurrent_vector const *vector, int index);
+static int segment_start(basic_concurrent_vector const *vector, int segment);
+static int segment_cap(basic_concurrent_vector const *vector, int segment);
+static size_t segment_header(
+        basic_concurrent_vector const *vector,
+        int segment);
+static size_t segment_size(basic_concurrent_vector const *vector, int segment);
+static unsigned char *segment_get(
+        basic_concurrent_vector *vector,
+        int segment);
+static bool segments_get(basic_concurrent_vector *vector, int first, int n);
+static int reserve(basic_concurrent_vector *vector, int n);
+static void publish(unsigned char *base, int offset, int count);
+static void const *published_at(
+        basic_concurrent_vector const *vector,
+        int index);
+
+basic_concurrent_vector basic_concurrent_vector_new(
+        size_t elem_size,
+        int base_cap)
+{
+    BASIC_ASSERT_NONZERO(elem_size);
+    BASIC_ASSERT_POSITIVE(base_cap);
+
+    uint64_t const pow2 = basic_bits_ceil_pow2((uint64_t)base_cap);
+    if (pow2 > INT_MAX) {
+        return BASIC_CONCURRENT_VECTOR_NULL;
+    }
+
+    basic_concurrent_vector vector = BASIC_CONCURRENT_VECTOR_NULL;
+    vector.elem_size = elem_size;
+    vector.base_cap = (int)pow2;
+    atomic_init(&vector.elem_count, 0);
+
+    for (int i = 0; i < BASIC_CONCURRENT_VECTOR_SEGMENTS; ++i) {
+        atomic_init(&vector.segments[i], NULL);
+    }
+
+    if (!segment_get(&vector, 0)) {
+        return BASIC_CONCURRENT_VECTOR_NULL;
+    }
+
+    return vector;
+}
+
+void basic_concurrent_vector_destroy(basic_concurrent_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+
+    if (!basic_concurrent_vector_isinit(vector)) {
+        return;
+    }
+
+    for (int i = 0; i < BASIC_CONCURRENT_VECTOR_SEGMENTS; ++i) {
+        basic_block block = {
+            .ptr = atomic_load_explicit(&vector->segments[i],
+                    memory_order_relaxed),
+            .size = segment_size(vector, i)
+        };
+
+        if (block.ptr) {
+            basic_block_dealloc(&block);
+        }
+    }
+
+    *vector = BASIC_CONCURRENT_VECTOR_NULL;
+}
+
+int basic_concurrent_vector_append_n(
+        basic_concurrent_vector *vector,
+        void const *elems,
+        int n)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT_PTR_NONNULL(elems);
+    BASIC_ASSERT(basic_concurrent_vector_isinit(vector),
+            "basic_concurrent_vector object must be initialised");
+    BASIC_ASSERT_POSITIVE(n);
+
+    int const first = reserve(vector, n);
+    if (first < 0) {
+        return -1;
+    }
+
+    // Every segment the indices fall in exists already, so copy segment by
+    // segment, then publish the elements' ready bits
+    unsigned char const *src = elems;
+    int index = first;
+    while (index < first + n) {
+        int const segment = segment_of(vector, index);
+        unsigned char *const base = atomic_load_explicit(
+                &vector->segments[segment],
+                memory_order_acquire);
+
+        int const offset = index - segment_start(vector, segment);
+        int const room = segment_cap(vector, segment) - offset;
+        int const count = first + n - index < room ? first + n - index : room;
+
+        memcpy(base + segment_header(vector, segment)
+                    + (size_t)offset * vector->elem_size,
+                src,
+                (size_t)count * vector->elem_size);
+
+        publish(base, offset, count);
+        src += (size_t)count * vector->elem_size;
+        index += count;
+    }
+
+    return first;
+}
+
+void *basic_concurrent_vector_at(basic_concurrent_vector *vector, int index)
+{
+    return (void *)published_at(vector, index);
+}
+
+void const *basic_concurrent_vector_at_c(
+        basic_concurrent_vector const *vector,
+        int index)
+{
+    return published_at(vector, index);
+}
+
+bool segments_get(basic_concurrent_vector *vector, int first, int n)
+{
+    int const last = segment_of(vector, first + (n - 1));
+    for (int segment = segment_of(vector, first); segment <= last; ++segment) {
+        if (!segment_get(vector, segment)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int reserve(basic_concurrent_vector *vector, int n)
+{
+    // Indices are only reserved once the segments they fall in exist, so
+    // that a failed allocation cannot leave reserved indices that are never
+    // published. Segments allocated for a reservation that then loses the
+    // race are kept, since later indices will fall in them.
+    int first = atomic_load_explicit(&vector->elem_count,
+            memory_order_relaxed);
+
+    do {
+        if (first > INT_MAX - n || !segments_get(vector, first, n)) {
+            return -1;
+        }
+    } while (!atomic_compare_exchange_weak_explicit(&vector->elem_count,
+                &first,
+                first + n,
+                memory_order_relaxed,
+                memory_order_relaxed));
+
+    return first;
+}
+
+void publish(unsigned char *base, int offset, int count)
+{
+    // One fetch-or per word of the ready bitmap rather than per element
+    atomic_uint_least64_t *const ready = (atomic_uint_least64_t *)base;
+    for (int bit = offset; bit < offset + count;) {
+        int const shift = bit % BASIC_BITS_PER_WORD;
+        int const bits = offset + count - bit < BASIC_BITS_PER_WORD - shift
+            ? offset + count - bit
+            : BASIC_BITS_PER_WORD - shift;
+        uint64_t const mask = bits == BASIC_BITS_PER_WORD
+            ? UINT64_MAX
+            : ((UINT64_C(1) << bits) - 1) << shift;
+
+        atomic_fetch_or_explicit(&ready[bit / BASIC_BITS_PER_WORD],
+                mask,
+                memory_order_release);
+        bit += bits;
+    }
+}
+
+void const *published_at(basic_concurrent_vector const *vector, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_concurrent_vector_isinit(vector),
+            "basic_concurrent_vector object must be initialised");
+    BASIC_ASSERT(index >= 0, "index %d out of range", index);
+
+    int const segment = segment_of(vector, index);
+    unsigned char const *const base = atomic_load_explicit(
+            &vector->segments[segment],
+            memory_order_acquire);
+    if (!base) {
+        return NULL;
+    }
+
+    int const offset = index - segment_start(vector, segment);
+    atomic_uint_least64_t const *const ready =
+        (atomic_uint_least64_t const *)base;
+    uint64_t const word = atomic_load_explicit(
+            &ready[offset / BASIC_BITS_PER_WORD],
+            memory_order_acquire);
+    if (!(word >> (offset % BASIC_BITS_PER_WORD) & 1)) {
+        return NULL;
+    }
+
+    return base + segment_header(vector, segment)
+        + (size_t)offset * vector->elem_size;
+}
+
+int segment_of(basic_concurrent_vector const *vector, int index)
+{
+    // Segment k starts at base_cap * (2^k - 1), so k is the position of the
+    // highest set bit of index / base_cap + 1
+    return basic_bits_log2((uint64_t)index / (uint64_t)vector->base_cap + 1);
+}
+
+int segment_start(basic_concurrent_vector const *vector, int segment)
+{
+    return (int)((((size_t)1 << segment) - 1) * (size_t)vector->base_cap);
+}
+
+int segment_cap(basic_concurrent_vector const *vector, int segment)
+{
+    size_t const cap = (size_t)vector->base_cap << segment;
+    return cap > INT_MAX ? INT_MAX : (int)cap;
+}
+
+size_t segment_header(
+        basic_concurrent_vector const *vector,
+        int segment)
+{
+    return (size_t)basic_bits_words_for(segment_cap(vector, segment))
+        * sizeof(atomic_uint_least64_t);
+}
+
+size_t segment_size(basic_concurrent_vector const *vector, int segment)
+{
+    return segment_header(vector, segment)
+        + (size_t)segment_cap(vector, segment) * vector->elem_size;
+}
+
+unsigned char *segment_get(basic_concurrent_vector *vector, int segment)
+{
+    BASIC_ASSERT(segment < BASIC_CONCURRENT_VECTOR_SEGMENTS,
+            "segment %d out of range", segment);
+
+    unsigned char *base = atomic_load_explicit(&vector->segments[segment],
+            memory_order_acquire);
+    if (base) {
+        return base;
+    }
+
+    // Several appenders may race to allocate the same segment. The first to
+    // install its block wins and the others free theirs. The block comes
+    // zeroed, so every ready bit starts clear.
+    basic_block block = basic_block_alloc(segment_size(vector, segment));
+    if (basic_block_isnull(&block)) {
+        return NULL;
+    }
+
+    if (atomic_compare_exchange_strong_explicit(&vector->segments[segment],
+                &base,
+                block.ptr,
+                memory_order_acq_rel,
+                memory_order_acquire)) {
+        return block.ptr;
+    }
+
+    basic_block_dealloc(&block);
+    return base;
+}
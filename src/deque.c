@@ -0,0 +1,230 @@
+#include "deque.h"
+
+#include <limits.h>
+#include <string.h>
+
+#include "bits.h"
+
+static bool deque_isfull(basic_deque const *deque);
+static basic_deque *deque_grow(basic_deque *deque);
+static int deque_slot(basic_deque const *deque, int index);
+
+basic_deque basic_deque_move(basic_deque *deque)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    BASIC_ASSERT(basic_deque_isinit(deque),
+            "basic_deque object must be initialised");
+
+    basic_deque temp = *deque;
+    *deque = BASIC_DEQUE_NULL;
+    return temp;
+}
+
+basic_deque basic_deque_clone(basic_deque const *deque)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    BASIC_ASSERT(basic_deque_isnull(deque) || basic_deque_isinit(deque),
+            "basic_deque object must be null or initialised");
+
+    if (basic_deque_isnull(deque)) {
+        return BASIC_DEQUE_NULL;
+    }
+
+    basic_array data = basic_array_clone(&deque->data);
+    if (basic_array_isnull(&data)) {
+        return BASIC_DEQUE_NULL;
+    }
+
+    return (basic_deque) {
+        .data = basic_array_move(&data),
+        .head = deque->head,
+        .elem_count = deque->elem_count,
+        .elem_cap = deque->elem_cap
+    };
+}
+
+basic_deque basic_deque_new(size_t elem_size, int initial_cap)
+{
+    BASIC_ASSERT_NONZERO(elem_size);
+    BASIC_ASSERT_POSITIVE(initial_cap);
+
+    uint64_t const pow2 = basic_bits_ceil_pow2((uint64_t)initial_cap);
+    if (pow2 > INT_MAX) {
+        return BASIC_DEQUE_NULL;
+    }
+
+    int const elem_cap = (int)pow2;
+    basic_array data = basic_array_alloc(elem_size, elem_cap);
+    if (basic_array_isnull(&data)) {
+        return BASIC_DEQUE_NULL;
+    }
+
+    return (basic_deque) {
+        .data = basic_array_move(&data),
+        .head = 0,
+        .elem_count = 0,
+        .elem_cap = elem_cap
+    };
+}
+
+void basic_deque_destroy(basic_deque *deque)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+
+    if (basic_deque_isinit(deque)) {
+        basic_array_dealloc(&deque->data);
+        *deque = BASIC_DEQUE_NULL;
+    }
+}
+
+bool basic_deque_pushback(basic_deque *deque, void const *elem)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    BASIC_ASSERT_PTR_NONNULL(elem);
+    BASIC_ASSERT(basic_deque_isinit(deque),
+            "basic_deque object must be initialised");
+
+    if (deque_isfull(deque) && !deque_grow(deque)) {
+        return false;
+    }
+
+    memcpy(basic_array_at(&deque->data, deque_slot(deque, deque->elem_count)),
+            elem,
+            deque->data.elem_size);
+    ++deque->elem_count;
+    return true;
+}
+
+bool basic_deque_pushfront(basic_deque *deque, void const *elem)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    BASIC_ASSERT_PTR_NONNULL(elem);
+    BASIC_ASSERT(basic_deque_isinit(deque),
+            "basic_deque object must be initialised");
+
+    if (deque_isfull(deque) && !deque_grow(deque)) {
+        return false;
+    }
+
+    deque->head = (deque->head - 1) & (deque->elem_cap - 1);
+    memcpy(basic_array_at(&deque->data, deque->head),
+            elem,
+            deque->data.elem_size);
+    ++deque->elem_count;
+    return true;
+}
+
+void basic_deque_popback(basic_deque *deque)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    BASIC_ASSERT(basic_deque_isinit(deque) && !basic_deque_isempty(deque),
+            "basic_deque object must be initialised and non-empty");
+
+    --deque->elem_count;
+}
+
+void basic_deque_popfront(basic_deque *deque)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    BASIC_ASSERT(basic_deque_isinit(deque) && !basic_deque_isempty(deque),
+            "basic_deque object must be initialised and non-empty");
+
+    deque->head = (deque->head + 1) & (deque->elem_cap - 1);
+    --deque->elem_count;
+}
+
+void *basic_deque_at(basic_deque *deque, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    BASIC_ASSERT(basic_deque_isinit(deque),
+            "basic_deque object must be initialised");
+    BASIC_ASSERT(index >= 0 && index < deque->elem_count,
+            "index %d out of range", index);
+
+    return basic_array_at(&deque->data, deque_slot(deque, index));
+}
+
+void const *basic_deque_at_c(basic_deque const *deque, int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    BASIC_ASSERT(basic_deque_isinit(deque),
+            "basic_deque object must be initialised");
+    BASIC_ASSERT(index >= 0 && index < deque->elem_count,
+            "index %d out of range", index);
+
+    return basic_array_at_c(&deque->data, deque_slot(deque, index));
+}
+
+void basic_deque_spans(
+        basic_deque *deque,
+        basic_span *first,
+        basic_span *second)
+{
+    BASIC_ASSERT_PTR_NONNULL(deque);
+    BASIC_ASSERT_PTR_NONNULL(first);
+    BASIC_ASSERT_PTR_NONNULL(second);
+    BASIC_ASSERT(basic_deque_isinit(deque),
+            "basic_deque object must be initialised");
+
+    *first = BASIC_SPAN_NULL;
+    *second = BASIC_SPAN_NULL;
+
+    if (!deque->elem_count) {
+        return;
+    }
+
+    size_t const elem_size = deque->data.elem_size;
+    int const until_end = deque->elem_cap - deque->head;
+    int const first_count = deque->elem_count < until_end
+        ? deque->elem_count
+        : until_end;
+
+    *first = (basic_span) {
+        .ptr = basic_array_at(&deque->data, deque->head),
+        .size = (size_t)first_count * elem_size
+    };
+
+    if (first_count < deque->elem_count) {
+        *second = (basic_span) {
+            .ptr = basic_array_at(&deque->data, 0),
+            .size = (size_t)(deque->elem_count - first_count) * elem_size
+        };
+    }
+}
+
+bool deque_isfull(basic_deque const *deque)
+{
+    return deque->elem_count == deque->elem_cap;
+}
+
+basic_deque *deque_grow(basic_deque *deque)
+{
+    // The capacity stays a power of two, so it cannot double past 2^30
+    int const old_cap = deque->elem_cap;
+    if (old_cap > INT_MAX / 2) {
+        return NULL;
+    }
+
+    int const new_cap = old_cap * 2;
+    if (!basic_array_realloc(&deque->data, new_cap)) {
+        return NULL;
+    }
+
+    // If the contents wrapped around the old end, move the wrapped prefix
+    // to just past the old end. The new capacity is twice the old, so the
+    // prefix always fits and the contents become contiguous from head.
+    int const wrapped = deque->head + deque->elem_count - old_cap;
+    if (wrapped > 0) {
+        memcpy(basic_array_at(&deque->data, old_cap),
+                basic_array_at(&deque->data, 0),
+                (size_t)wrapped * deque->data.elem_size);
+    }
+
+    deque->elem_cap = new_cap;
+    return deque;
+}
+
+int deque_slot(basic_deque const *deque, int index)
+{
+    return (deque->head + index) & (deque->elem_cap - 1);
+}
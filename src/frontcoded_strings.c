@@ -0,0 +1,335 @@
+#include "frontcoded_strings.h"
+
+#include <stdint.h>
+#include <string.h>
+
+static size_t bucket_count(basic_frontcoded_strings const *strings);
+static unsigned char const *bucket_at(
+        basic_frontcoded_strings const *strings,
+        size_t bucket);
+static size_t common_prefix(char const *a, char const *b);
+static size_t varint_size(size_t value);
+static unsigned char *put_varint(unsigned char *dest, size_t value);
+static size_t get_varint(unsigned char const **src);
+static bool precedes(unsigned char c, unsigned char key_c, bool prefix);
+static size_t count_preceding(
+        basic_frontcoded_strings const *strings,
+        char const *key,
+        bool prefix,
+        bool *equal);
+
+basic_frontcoded_strings basic_frontcoded_strings_new(
+        basic_string_vector const *sorted,
+        size_t bucket_size)
+{
+    BASIC_ASSERT_PTR_NONNULL(sorted);
+    BASIC_ASSERT(basic_string_vector_isinit(sorted),
+            "basic_string_vector object must be initialised");
+    BASIC_ASSERT_NONZERO(bucket_size);
+
+    size_t const string_count = sorted->string_count;
+
+    // Size the encoding first, so that it is allocated once
+    size_t size = 0;
+    for (size_t i = 0; i < string_count; ++i) {
+        char const *const string = basic_string_vector_at(sorted, i);
+        size_t const len = strlen(string);
+
+        if (i % bucket_size == 0) {
+            size += len + 1;
+            continue;
+        }
+
+        char const *const prev = basic_string_vector_at(sorted, i - 1);
+        size_t const shared = common_prefix(prev, string);
+        BASIC_ASSERT(
+                (unsigned char)prev[shared] <= (unsigned char)string[shared],
+                "strings %zu and %zu are out of order", i - 1, i);
+        size += varint_size(shared) + len - shared + 1;
+    }
+
+    basic_frontcoded_strings strings = {
+        .data = basic_block_alloc(size ? size : 1),
+        .buckets = basic_array_alloc(sizeof(size_t),
+                string_count ? (string_count - 1) / bucket_size + 1 : 1),
+        .string_count = string_count,
+        .bucket_size = bucket_size
+    };
+
+    if (basic_block_isnull(&strings.data)
+            || basic_array_isnull(&strings.buckets)) {
+        basic_frontcoded_strings_destroy(&strings);
+        return BASIC_FRONTCODED_STRINGS_NULL;
+    }
+
+    unsigned char *const data = strings.data.ptr;
+    size_t *const buckets = strings.buckets.data.ptr;
+    unsigned char *dest = data;
+
+    for (size_t i = 0; i < string_count; ++i) {
+        char const *const string = basic_string_vector_at(sorted, i);
+        size_t shared = 0;
+
+        if (i % bucket_size == 0) {
+            buckets[i / bucket_size] = (size_t)(dest - data);
+        } else {
+            shared = common_prefix(basic_string_vector_at(sorted, i - 1),
+                    string);
+            dest = put_varint(dest, shared);
+        }
+
+        size_t const suffix_size = strlen(string + shared) + 1;
+        memcpy(dest, string + shared, suffix_size);
+        dest += suffix_size;
+    }
+
+    return strings;
+}
+
+void basic_frontcoded_strings_destroy(basic_frontcoded_strings *strings)
+{
+    BASIC_ASSERT_PTR_NONNULL(strings);
+
+    basic_block_dealloc(&strings->data);
+    basic_array_dealloc(&strings->buckets);
+    *strings = BASIC_FRONTCODED_STRINGS_NULL;
+}
+
+size_t basic_frontcoded_strings_get(
+        basic_frontcoded_strings const *strings,
+        size_t index,
+        char *buf,
+        size_t size)
+{
+    BASIC_ASSERT_PTR_NONNULL(strings);
+    BASIC_ASSERT(basic_frontcoded_strings_isinit(strings),
+            "basic_frontcoded_strings object must be initialised");
+    BASIC_ASSERT(index < strings->string_count,
+            "index %zu out of range", index);
+    BASIC_ASSERT(buf || !size, "a non-empty buffer must be non-NULL");
+
+    // Each string overwrites the one before it from the end of their shared
+    // prefix. Bytes past the end of buf never need to be read back, since
+    // every shared prefix that reaches them also covers those before them.
+    size_t const limit = size ? size - 1 : 0;
+    unsigned char const *src = bucket_at(strings, index / strings->bucket_size);
+    size_t len = 0;
+
+    for (size_t i = 0; i <= index % strings->bucket_size; ++i) {
+        size_t const shared = i ? get_varint(&src) : 0;
+        size_t const suffix_len = strlen((char const *)src);
+
+        if (shared < limit) {
+            size_t const n = suffix_len < limit - shared
+                ? suffix_len
+                : limit - shared;
+            memcpy(buf + shared, src, n);
+        }
+
+        len = shared + suffix_len;
+        src += suffix_len + 1;
+    }
+
+    if (size) {
+        buf[len < limit ? len : limit] = '\0';
+    }
+
+    return len;
+}
+
+size_t basic_frontcoded_strings_lower_bound(
+        basic_frontcoded_strings const *strings,
+        char const *string)
+{
+    BASIC_ASSERT_PTR_NONNULL(strings);
+    BASIC_ASSERT(basic_frontcoded_strings_isinit(strings),
+            "basic_frontcoded_strings object must be initialised");
+    BASIC_ASSERT_PTR_NONNULL(string);
+
+    bool equal;
+    return count_preceding(strings, string, false, &equal);
+}
+
+bool basic_frontcoded_strings_find(
+        basic_frontcoded_strings const *strings,
+        char const *string,
+        size_t *index)
+{
+    BASIC_ASSERT_PTR_NONNULL(strings);
+    BASIC_ASSERT(basic_frontcoded_strings_isinit(strings),
+            "basic_frontcoded_strings object must be initialised");
+    BASIC_ASSERT_PTR_NONNULL(string);
+    BASIC_ASSERT_PTR_NONNULL(index);
+
+    bool equal;
+    size_t const found = count_preceding(strings, string, false, &equal);
+    if (equal) {
+        *index = found;
+    }
+
+    return equal;
+}
+
+size_t basic_frontcoded_strings_prefix_range(
+        basic_frontcoded_strings const *strings,
+        char const *prefix,
+        size_t *first)
+{
+    BASIC_ASSERT_PTR_NONNULL(strings);
+    BASIC_ASSERT(basic_frontcoded_strings_isinit(strings),
+            "basic_frontcoded_strings object must be initialised");
+    BASIC_ASSERT_PTR_NONNULL(prefix);
+    BASIC_ASSERT_PTR_NONNULL(first);
+
+    bool equal;
+    *first = count_preceding(strings, prefix, false, &equal);
+    return count_preceding(strings, prefix, true, &equal) - *first;
+}
+
+size_t bucket_count(basic_frontcoded_strings const *strings)
+{
+    return strings->string_count
+        ? (strings->string_count - 1) / strings->bucket_size + 1
+        : 0;
+}
+
+unsigned char const *bucket_at(
+        basic_frontcoded_strings const *strings,
+        size_t bucket)
+{
+    size_t const *const buckets = strings->buckets.data.ptr;
+    return (unsigned char const *)strings->data.ptr + buckets[bucket];
+}
+
+size_t common_prefix(char const *a, char const *b)
+{
+    size_t i = 0;
+    while (a[i] && a[i] == b[i]) {
+        ++i;
+    }
+
+    return i;
+}
+
+size_t varint_size(size_t value)
+{
+    size_t size = 1;
+    while (value >= 0x80) {
+        value >>= 7;
+        ++size;
+    }
+
+    return size;
+}
+
+unsigned char *put_varint(unsigned char *dest, size_t value)
+{
+    // Seven bits at a time, least significant first, with the top bit set
+    // on every byte but the last
+    while (value >= 0x80) {
+        *dest++ = (unsigned char)(value | 0x80);
+        value >>= 7;
+    }
+
+    *dest++ = (unsigned char)value;
+    return dest;
+}
+
+size_t get_varint(unsigned char const **src)
+{
+    size_t value = 0;
+    unsigned shift = 0;
+    unsigned char byte;
+
+    do {
+        byte = *(*src)++;
+        value |= (size_t)(byte & 0x7f) << shift;
+        shift += 7;
+    } while (byte & 0x80);
+
+    return value;
+}
+
+bool precedes(unsigned char c, unsigned char key_c, bool prefix)
+{
+    // c and key_c are the first bytes at which a string and the key differ,
+    // or both NUL if they are equal. With prefix set, a string that runs
+    // through the whole key also counts.
+    return (prefix && !key_c) || c < key_c;
+}
+
+size_t count_preceding(
+        basic_frontcoded_strings const *strings,
+        char const *key,
+        bool prefix,
+        bool *equal)
+{
+    // Returns how many strings precede the key, which are the first ones
+    // since the strings are sorted, and whether the next one equals it
+    unsigned char const *const ukey = (unsigned char const *)key;
+    size_t const bucket_total = bucket_count(strings);
+
+    // Find the buckets whose first strings precede the key. Only the last of
+    // them can hold both strings that do and strings that do not.
+    size_t buckets = 0;
+    for (size_t count = bucket_total; count;) {
+        size_t const half = count / 2;
+        char const *const first = (char const *)bucket_at(strings,
+                buckets + half);
+        size_t const shared = common_prefix(first, key);
+
+        if (precedes((unsigned char)first[shared], ukey[shared], prefix)) {
+            buckets += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+
+    if (!buckets) {
+        *equal = bucket_total
+            && !strcmp((char const *)bucket_at(strings, 0), key);
+        return 0;
+    }
+
+    // Walk that bucket keeping the length of the prefix the current string
+    // shares with the key. A string sharing less with the one before it than
+    // that is greater than the key, and one sharing more compares as the one
+    // before did, so only the rest need their suffixes read.
+    size_t const bucket = buckets - 1;
+    size_t const end = bucket * strings->bucket_size + strings->bucket_size
+            < strings->string_count
+        ? bucket * strings->bucket_size + strings->bucket_size
+        : strings->string_count;
+
+    unsigned char const *src = bucket_at(strings, bucket);
+    size_t matched = common_prefix((char const *)src, key);
+    src += strlen((char const *)src) + 1;
+
+    size_t index = bucket * strings->bucket_size + 1;
+    for (; index < end; ++index) {
+        size_t const shared = get_varint(&src);
+        unsigned char const *const suffix = src;
+        src += strlen((char const *)suffix) + 1;
+
+        if (shared < matched) {
+            *equal = false;
+            return index;
+        }
+
+        if (shared > matched) {
+            continue;
+        }
+
+        size_t const more = common_prefix((char const *)suffix, key + matched);
+        matched += more;
+        if (!precedes(suffix[more], ukey[matched], prefix)) {
+            *equal = !suffix[more] && !ukey[matched];
+            return index;
+        }
+    }
+
+    *equal = index < strings->string_count
+        && !strcmp((char const *)bucket_at(strings, buckets), key);
+    return index;
+}
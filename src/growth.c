@@ -0,0 +1,89 @@
+#include "growth.h"
+
+#include <stdint.h>
+
+#include "assertion.h"
+
+enum {
+    page_size = 4096,
+    hugepage_size = 2 * 1024 * 1024
+};
+
+static size_t round_to_pages(
+        size_t cap,
+        size_t elem_size,
+        size_t granule,
+        size_t max);
+
+size_t basic_growth_next_cap(
+        basic_growth_policy const *policy,
+        size_t cap,
+        size_t min_cap,
+        size_t elem_size)
+{
+    BASIC_ASSERT_PTR_NONNULL(policy);
+    BASIC_ASSERT_POSITIVE(cap);
+    BASIC_ASSERT_NONZERO(elem_size);
+    BASIC_ASSERT(policy->kind != basic_growth_fixed || policy->increment > 0,
+            "fixed growth increment %zu must be positive", policy->increment);
+
+    // The largest capacity whose size in bytes fits in a size_t. Every step
+    // below is clamped to it, so no intermediate value can wrap.
+    size_t const max = SIZE_MAX / elem_size;
+    if (min_cap > max) {
+        return 0;
+    }
+
+    size_t next = cap;
+
+    switch (policy->kind) {
+    case basic_growth_one_and_half:
+        while (next < min_cap) {
+            size_t const step = next / 2 ? next / 2 : 1;
+            next = next > max - step ? max : next + step;
+        }
+        break;
+    case basic_growth_fixed:
+        if (next < min_cap) {
+            size_t const step = policy->increment;
+            size_t const steps = (min_cap - next) / step
+                + ((min_cap - next) % step != 0);
+            next = steps > (max - next) / step ? max : next + steps * step;
+        }
+        break;
+    case basic_growth_page:
+        next = round_to_pages(next < min_cap ? min_cap : next,
+                elem_size,
+                page_size,
+                max);
+        break;
+    case basic_growth_hugepage:
+        next = round_to_pages(next < min_cap ? min_cap : next,
+                elem_size,
+                hugepage_size,
+                max);
+        break;
+    default:
+        while (next < min_cap) {
+            next = next > max / 2 ? max : next * 2;
+        }
+        break;
+    }
+
+    return next;
+}
+
+size_t round_to_pages(
+        size_t cap,
+        size_t elem_size,
+        size_t granule,
+        size_t max)
+{
+    if (cap > (SIZE_MAX - granule + 1) / elem_size) {
+        return cap;
+    }
+
+    size_t const bytes = (cap * elem_size + granule - 1) / granule * granule;
+    size_t const rounded = bytes / elem_size;
+    return rounded < cap ? cap : rounded > max ? max : rounded;
+}
@@ -0,0 +1,42 @@
+#include "hash.h"
+
+#include <string.h>
+
+static uint64_t const murmur_m = UINT64_C(0xc6a4a7935bd1e995);
+enum { murmur_r = 47 };
+
+uint64_t basic_hash_bytes(void const *data, size_t size, uint64_t seed)
+{
+    BASIC_ASSERT(data || !size, "data must be non-NULL unless size is 0");
+
+    unsigned char const *bytes = data;
+    uint64_t hash = seed ^ (size * murmur_m);
+
+    for (size_t i = 0; i + 8 <= size; i += 8) {
+        uint64_t word;
+        memcpy(&word, bytes + i, sizeof word);
+
+        word *= murmur_m;
+        word ^= word >> murmur_r;
+        word *= murmur_m;
+
+        hash ^= word;
+        hash *= murmur_m;
+    }
+
+    size_t const tail = size & 7;
+    if (tail) {
+        uint64_t word = 0;
+        for (size_t i = 0; i < tail; ++i) {
+            word |= (uint64_t)bytes[size - tail + i] << (8 * i);
+        }
+
+        hash ^= word;
+        hash *= murmur_m;
+    }
+
+    hash ^= hash >> murmur_r;
+    hash *= murmur_m;
+    hash ^= hash >> murmur_r;
+    return hash;
+}
@@ -0,0 +1,491 @@
+#include "hashmap.h"
+
+#include <limits.h>
+#include <string.h>
+
+#include "bits.h"
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+enum {
+    group_width = 16,
+    ctrl_empty = 0x80,
+    h2_mask = 0x7f
+};
+
+static bool alloc_tables(basic_hashmap *map, size_t slot_size, int slot_cap);
+static int find_slot(basic_hashmap const *map, void const *key, uint64_t hash);
+static int find_empty(basic_hashmap const *map, uint64_t hash);
+static void set_ctrl(basic_hashmap *map, int slot, uint8_t value);
+static inline unsigned char *slot_at(basic_hashmap *map, int slot);
+static inline unsigned char const *slot_at_c(
+        basic_hashmap const *map,
+        int slot);
+static uint64_t hash_key(basic_hashmap const *map, void const *key);
+static int home_slot(basic_hashmap const *map, uint64_t hash);
+static int cap_for(int elem_count);
+static size_t natural_align(size_t size);
+static uint32_t group_match(uint8_t const *group, uint8_t h2);
+static uint32_t group_match_empty(uint8_t const *group);
+
+basic_hashmap basic_hashmap_move(basic_hashmap *map)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT(basic_hashmap_isinit(map),
+            "basic_hashmap object must be initialised");
+
+    basic_hashmap temp = *map;
+    *map = BASIC_HASHMAP_NULL;
+    return temp;
+}
+
+basic_hashmap basic_hashmap_clone(basic_hashmap const *map)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT(basic_hashmap_isnull(map) || basic_hashmap_isinit(map),
+            "basic_hashmap object must be null or initialised");
+
+    if (basic_hashmap_isnull(map)) {
+        return BASIC_HASHMAP_NULL;
+    }
+
+    basic_array ctrl = basic_array_clone(&map->ctrl);
+    if (basic_array_isnull(&ctrl)) {
+        return BASIC_HASHMAP_NULL;
+    }
+
+    basic_array slots = basic_array_clone(&map->slots);
+    if (basic_array_isnull(&slots)) {
+        basic_array_dealloc(&ctrl);
+        return BASIC_HASHMAP_NULL;
+    }
+
+    basic_hashmap clone = *map;
+    clone.ctrl = basic_array_move(&ctrl);
+    clone.slots = basic_array_move(&slots);
+    return clone;
+}
+
+basic_hashmap basic_hashmap_new(
+        size_t key_size,
+        size_t value_size,
+        basic_hash_fn hash,
+        int initial_cap)
+{
+    BASIC_ASSERT_NONZERO(key_size);
+    BASIC_ASSERT(initial_cap >= 0,
+            "initial capacity %d must be non-negative", initial_cap);
+
+    // Lay each slot out as the key, then the value at its natural alignment
+    size_t const value_align = natural_align(value_size);
+    size_t const slot_align = natural_align(key_size) > value_align
+        ? natural_align(key_size)
+        : value_align;
+    size_t const value_offset =
+        (key_size + value_align - 1) / value_align * value_align;
+    size_t const slot_size =
+        (value_offset + value_size + slot_align - 1) / slot_align * slot_align;
+
+    basic_hashmap map = {
+        .key_size = key_size,
+        .value_size = value_size,
+        .value_offset = value_offset,
+        .hash = hash ? hash : basic_hash_span,
+        .elem_count = 0
+    };
+
+    if (!alloc_tables(&map, slot_size, cap_for(initial_cap))) {
+        return BASIC_HASHMAP_NULL;
+    }
+
+    return map;
+}
+
+void basic_hashmap_destroy(basic_hashmap *map)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+
+    if (basic_hashmap_isinit(map)) {
+        basic_array_dealloc(&map->ctrl);
+        basic_array_dealloc(&map->slots);
+        *map = BASIC_HASHMAP_NULL;
+    }
+}
+
+void *basic_hashmap_find(basic_hashmap *map, void const *key)
+{
+    return (void *)basic_hashmap_find_c(map, key);
+}
+
+void const *basic_hashmap_find_c(basic_hashmap const *map, void const *key)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT_PTR_NONNULL(key);
+    BASIC_ASSERT(basic_hashmap_isinit(map),
+            "basic_hashmap object must be initialised");
+
+    int const slot = find_slot(map, key, hash_key(map, key));
+    return slot == -1 ? NULL : slot_at_c(map, slot) + map->value_offset;
+}
+
+void *basic_hashmap_emplace(
+        basic_hashmap *map,
+        void const *key,
+        bool *inserted)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT_PTR_NONNULL(key);
+    BASIC_ASSERT(basic_hashmap_isinit(map),
+            "basic_hashmap object must be initialised");
+
+    uint64_t const hash = hash_key(map, key);
+    int slot = find_slot(map, key, hash);
+
+    if (inserted) {
+        *inserted = slot == -1;
+    }
+
+    if (slot != -1) {
+        return slot_at(map, slot) + map->value_offset;
+    }
+
+    // Keep the load factor at or below 7/8
+    if (map->elem_count + 1 > map->slot_cap / 8 * 7
+            && !basic_hashmap_rehash(map, map->slot_cap * 2)) {
+        return NULL;
+    }
+
+    slot = find_empty(map, hash);
+    set_ctrl(map, slot, (uint8_t)(hash & h2_mask));
+    memcpy(slot_at(map, slot), key, map->key_size);
+    ++map->elem_count;
+
+    return slot_at(map, slot) + map->value_offset;
+}
+
+bool basic_hashmap_insert(
+        basic_hashmap *map,
+        void const *key,
+        void const *value)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT(value || !map->value_size,
+            "value must be non-NULL unless value_size is 0");
+
+    void *const slot = basic_hashmap_emplace(map, key, NULL);
+    if (!slot) {
+        return false;
+    }
+
+    if (map->value_size) {
+        memcpy(slot, value, map->value_size);
+    }
+
+    return true;
+}
+
+bool basic_hashmap_erase(basic_hashmap *map, void const *key)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT_PTR_NONNULL(key);
+    BASIC_ASSERT(basic_hashmap_isinit(map),
+            "basic_hashmap object must be initialised");
+
+    int gap = find_slot(map, key, hash_key(map, key));
+    if (gap == -1) {
+        return false;
+    }
+
+    // Walk the rest of the probe run. An entry can move back into the gap
+    // if the gap lies between its home slot and where it sits now.
+    uint8_t const *const ctrl = basic_array_at_c(&map->ctrl, 0);
+    int const mask = map->slot_cap - 1;
+    size_t const slot_size = map->slots.elem_size;
+
+    for (int next = (gap + 1) & mask; !(ctrl[next] & ctrl_empty);
+            next = (next + 1) & mask) {
+        int const home = home_slot(map, hash_key(map, slot_at_c(map, next)));
+        if (((next - home) & mask) >= ((next - gap) & mask)) {
+            memcpy(slot_at(map, gap), slot_at_c(map, next), slot_size);
+            set_ctrl(map, gap, ctrl[next]);
+            gap = next;
+        }
+    }
+
+    set_ctrl(map, gap, ctrl_empty);
+    --map->elem_count;
+    return true;
+}
+
+void basic_hashmap_clear(basic_hashmap *map)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT(basic_hashmap_isinit(map),
+            "basic_hashmap object must be initialised");
+
+    memset(basic_array_at(&map->ctrl, 0),
+            ctrl_empty,
+            (size_t)map->slot_cap + group_width);
+    map->elem_count = 0;
+}
+
+bool basic_hashmap_reserve(basic_hashmap *map, int elem_count)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT(basic_hashmap_isinit(map),
+            "basic_hashmap object must be initialised");
+    BASIC_ASSERT(elem_count >= 0,
+            "count %d must be non-negative", elem_count);
+
+    int const slot_cap = cap_for(elem_count);
+    return slot_cap <= map->slot_cap || basic_hashmap_rehash(map, slot_cap);
+}
+
+bool basic_hashmap_rehash(basic_hashmap *map, int slot_cap)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT(basic_hashmap_isinit(map),
+            "basic_hashmap object must be initialised");
+    BASIC_ASSERT(slot_cap >= 0,
+            "capacity %d must be non-negative", slot_cap);
+
+    // Never fewer slots than the current entries need
+    int new_cap = cap_for(map->elem_count);
+    while (new_cap < slot_cap) {
+        new_cap *= 2;
+    }
+
+    basic_hashmap rebuilt = *map;
+    if (!alloc_tables(&rebuilt, map->slots.elem_size, new_cap)) {
+        return false;
+    }
+
+    // Keys are known to be distinct, so each goes straight into the first
+    // empty slot of its probe run
+    for (int i = basic_hashmap_next(map, 0); i != -1;
+            i = basic_hashmap_next(map, i + 1)) {
+        uint64_t const hash = hash_key(map, slot_at_c(map, i));
+        int const slot = find_empty(&rebuilt, hash);
+
+        set_ctrl(&rebuilt, slot, (uint8_t)(hash & h2_mask));
+        memcpy(slot_at(&rebuilt, slot),
+                slot_at_c(map, i),
+                map->slots.elem_size);
+    }
+
+    basic_array_dealloc(&map->ctrl);
+    basic_array_dealloc(&map->slots);
+    *map = rebuilt;
+    return true;
+}
+
+int basic_hashmap_next(basic_hashmap const *map, int from)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT(basic_hashmap_isinit(map),
+            "basic_hashmap object must be initialised");
+    BASIC_ASSERT(from >= 0, "slot %d out of range", from);
+
+    uint8_t const *const ctrl = basic_array_at_c(&map->ctrl, 0);
+
+    for (int pos = from; pos < map->slot_cap; pos += group_width) {
+        uint32_t const full = ~group_match_empty(ctrl + pos) & 0xffff;
+        if (full) {
+            int const slot = pos + basic_bits_ctz(full);
+            return slot < map->slot_cap ? slot : -1;
+        }
+    }
+
+    return -1;
+}
+
+void const *basic_hashmap_key_at(basic_hashmap const *map, int slot)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT(basic_hashmap_isinit(map),
+            "basic_hashmap object must be initialised");
+    BASIC_ASSERT(slot >= 0 && slot < map->slot_cap
+            && !(*(uint8_t const *)basic_array_at_c(&map->ctrl, slot)
+                & ctrl_empty),
+            "slot %d is not occupied", slot);
+
+    return slot_at_c(map, slot);
+}
+
+void *basic_hashmap_value_at(basic_hashmap *map, int slot)
+{
+    BASIC_ASSERT_PTR_NONNULL(map);
+    BASIC_ASSERT(basic_hashmap_isinit(map),
+            "basic_hashmap object must be initialised");
+    BASIC_ASSERT(slot >= 0 && slot < map->slot_cap
+            && !(*(uint8_t const *)basic_array_at_c(&map->ctrl, slot)
+                & ctrl_empty),
+            "slot %d is not occupied", slot);
+
+    return slot_at(map, slot) + map->value_offset;
+}
+
+bool alloc_tables(basic_hashmap *map, size_t slot_size, int slot_cap)
+{
+    basic_array ctrl = basic_array_alloc(1, slot_cap + group_width);
+    if (basic_array_isnull(&ctrl)) {
+        return false;
+    }
+
+    basic_array slots = basic_array_alloc(slot_size, slot_cap);
+    if (basic_array_isnull(&slots)) {
+        basic_array_dealloc(&ctrl);
+        return false;
+    }
+
+    memset(basic_array_at(&ctrl, 0),
+            ctrl_empty,
+            (size_t)slot_cap + group_width);
+
+    map->ctrl = basic_array_move(&ctrl);
+    map->slots = basic_array_move(&slots);
+    map->slot_cap = slot_cap;
+    return true;
+}
+
+int find_slot(basic_hashmap const *map, void const *key, uint64_t hash)
+{
+    uint8_t const *const ctrl = basic_array_at_c(&map->ctrl, 0);
+    uint8_t const h2 = (uint8_t)(hash & h2_mask);
+    int const mask = map->slot_cap - 1;
+
+    // Every entry sits in the unbroken run of full slots that starts at its
+    // home slot, so the search can stop at the first group with an empty
+    for (int pos = home_slot(map, hash); ; pos = (pos + group_width) & mask) {
+        uint8_t const *const group = ctrl + pos;
+
+        for (uint32_t match = group_match(group, h2); match;
+                match &= match - 1) {
+            int const slot = (pos + basic_bits_ctz(match)) & mask;
+            if (!memcmp(slot_at_c(map, slot), key, map->key_size)) {
+                return slot;
+            }
+        }
+
+        if (group_match_empty(group)) {
+            return -1;
+        }
+    }
+}
+
+int find_empty(basic_hashmap const *map, uint64_t hash)
+{
+    uint8_t const *const ctrl = basic_array_at_c(&map->ctrl, 0);
+    int const mask = map->slot_cap - 1;
+
+    for (int pos = home_slot(map, hash); ; pos = (pos + group_width) & mask) {
+        uint32_t const empty = group_match_empty(ctrl + pos);
+        if (empty) {
+            return (pos + basic_bits_ctz(empty)) & mask;
+        }
+    }
+}
+
+void set_ctrl(basic_hashmap *map, int slot, uint8_t value)
+{
+    uint8_t *const ctrl = basic_array_at(&map->ctrl, 0);
+    ctrl[slot] = value;
+
+    // Keep the mirrored group in step with the first group
+    if (slot < group_width) {
+        ctrl[map->slot_cap + slot] = value;
+    }
+}
+
+// The probe loops address slots directly rather than through
+// basic_array_at, which is out of line and would be called per candidate
+unsigned char *slot_at(basic_hashmap *map, int slot)
+{
+    return (unsigned char *)map->slots.data.ptr
+        + (size_t)slot * map->slots.elem_size;
+}
+
+unsigned char const *slot_at_c(basic_hashmap const *map, int slot)
+{
+    return (unsigned char const *)map->slots.data.ptr
+        + (size_t)slot * map->slots.elem_size;
+}
+
+uint64_t hash_key(basic_hashmap const *map, void const *key)
+{
+    basic_span const span = {
+        .ptr = (void *)key,
+        .size = map->key_size
+    };
+
+    return map->hash(&span);
+}
+
+int home_slot(basic_hashmap const *map, uint64_t hash)
+{
+    return (int)((hash >> 7) & (uint64_t)(map->slot_cap - 1));
+}
+
+int cap_for(int elem_count)
+{
+    // The smallest power of two, no smaller than a group, that keeps
+    // elem_count entries at or below 7/8 full
+    size_t cap = group_width;
+    while (cap / 8 * 7 < (size_t)elem_count) {
+        cap *= 2;
+    }
+
+    BASIC_ASSERT(cap <= (size_t)INT_MAX / 2 + 1,
+            "capacity for %d entries is too large", elem_count);
+    return (int)cap;
+}
+
+size_t natural_align(size_t size)
+{
+    // The largest power of two dividing size, capped at the strictest
+    // fundamental alignment
+    size_t const align = size & -size;
+    if (!align) {
+        return 1;
+    }
+
+    if (align > _Alignof(max_align_t)) {
+        return _Alignof(max_align_t);
+    }
+
+    return align;
+}
+
+uint32_t group_match(uint8_t const *group, uint8_t h2)
+{
+#if defined(__SSE2__)
+    __m128i const ctrl = _mm_loadu_si128((__m128i const *)group);
+    return (uint32_t)_mm_movemask_epi8(
+            _mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)h2)));
+#else
+    uint32_t match = 0;
+    for (int i = 0; i < group_width; ++i) {
+        match |= (uint32_t)(group[i] == h2) << i;
+    }
+
+    return match;
+#endif
+}
+
+uint32_t group_match_empty(uint8_t const *group)
+{
+    // Empty is the only control value with the high bit set
+#if defined(__SSE2__)
+    return (uint32_t)_mm_movemask_epi8(
+            _mm_loadu_si128((__m128i const *)group));
+#else
+    uint32_t match = 0;
+    for (int i = 0; i < group_width; ++i) {
+        match |= (uint32_t)(group[i] >> 7) << i;
+    }
+
+    return match;
+#endif
+}
@@ -0,0 +1,436 @@
+#include "heap.h"
+
+#include <limits.h>
+#include <stdint.h>
+#include <string.h>
+
+static basic_heap heap_alloc(
+        size_t elem_size,
+        int elem_cap,
+        int handle_cap,
+        basic_heap_order order);
+static bool before(basic_heap const *heap, void const *lhs, void const *rhs);
+static void place(basic_heap *heap, int pos, void const *elem, int handle);
+static void sift_up(basic_heap *heap, int pos);
+static void sift_down(basic_heap *heap, int pos);
+static void restore(basic_heap *heap, int pos);
+static void remove_at(basic_heap *heap, int pos);
+static int alloc_handle(basic_heap *heap);
+static void free_handle(basic_heap *heap, int handle);
+static bool reserve_next(basic_vector *vector);
+static inline unsigned char *elem_at(basic_heap *heap, int pos);
+static inline unsigned char const *elem_at_c(basic_heap const *heap, int pos);
+static inline int *ints(basic_vector *vector);
+static inline int const *ints_c(basic_vector const *vector);
+
+basic_heap basic_heap_move(basic_heap *heap)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    BASIC_ASSERT(basic_heap_isinit(heap),
+            "basic_heap object must be initialised");
+
+    basic_heap temp = *heap;
+    *heap = BASIC_HEAP_NULL;
+    return temp;
+}
+
+basic_heap basic_heap_clone(basic_heap const *heap)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    BASIC_ASSERT(basic_heap_isnull(heap) || basic_heap_isinit(heap),
+            "basic_heap object must be null or initialised");
+
+    if (basic_heap_isnull(heap)) {
+        return BASIC_HEAP_NULL;
+    }
+
+    basic_heap clone = {
+        .elems = basic_vector_clone(&heap->elems),
+        .handle_of = basic_vector_clone(&heap->handle_of),
+        .index_of = basic_vector_clone(&heap->index_of),
+        .scratch = basic_block_clone(&heap->scratch),
+        .order = heap->order,
+        .free_handle = heap->free_handle
+    };
+
+    if (basic_vector_isnull(&clone.elems)
+            || basic_vector_isnull(&clone.handle_of)
+            || basic_vector_isnull(&clone.index_of)
+            || basic_block_isnull(&clone.scratch)) {
+        basic_vector_destroy(&clone.elems);
+        basic_vector_destroy(&clone.handle_of);
+        basic_vector_destroy(&clone.index_of);
+        basic_block_dealloc(&clone.scratch);
+        return BASIC_HEAP_NULL;
+    }
+
+    return clone;
+}
+
+basic_heap basic_heap_new(
+        size_t elem_size,
+        int initial_cap,
+        basic_heap_order order)
+{
+    BASIC_ASSERT_NONZERO(elem_size);
+    BASIC_ASSERT_POSITIVE(initial_cap);
+
+    return heap_alloc(elem_size, initial_cap, initial_cap, order);
+}
+
+basic_heap basic_heap_from_vector(
+        basic_vector *vector,
+        basic_heap_order order)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+    BASIC_ASSERT(vector->elem_count <= INT_MAX,
+            "basic_vector has too many elements (%zu) for int handles",
+            vector->elem_count);
+
+    int const elem_count = (int)vector->elem_count;
+    basic_heap heap = heap_alloc(vector->data.elem_size,
+            1,
+            elem_count ? elem_count : 1,
+            order);
+    if (basic_heap_isnull(&heap)) {
+        return BASIC_HEAP_NULL;
+    }
+
+    // Handles start out as the original indices
+    for (int i = 0; i < elem_count; ++i) {
+        ints(&heap.handle_of)[i] = i;
+        ints(&heap.index_of)[i] = i;
+    }
+
+    heap.handle_of.elem_count = elem_count;
+    heap.index_of.elem_count = elem_count;
+
+    basic_vector_destroy(&heap.elems);
+    heap.elems = basic_vector_move(vector);
+
+    // Floyd's heapify: sift down every internal node, last first
+    if (elem_count > 1) {
+        for (int i = (elem_count - 2) / heap.order.arity; i >= 0; --i) {
+            sift_down(&heap, i);
+        }
+    }
+
+    return heap;
+}
+
+void basic_heap_destroy(basic_heap *heap)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+
+    if (basic_heap_isinit(heap)) {
+        basic_vector_destroy(&heap->elems);
+        basic_vector_destroy(&heap->handle_of);
+        basic_vector_destroy(&heap->index_of);
+        basic_block_dealloc(&heap->scratch);
+        *heap = BASIC_HEAP_NULL;
+    }
+}
+
+int basic_heap_push(basic_heap *heap, void const *elem)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    BASIC_ASSERT_PTR_NONNULL(elem);
+    BASIC_ASSERT(basic_heap_isinit(heap),
+            "basic_heap object must be initialised");
+
+    // Make room in every vector first so that a failure changes nothing
+    int const elem_count = (int)heap->elems.elem_count;
+    if (!reserve_next(&heap->elems)
+            || !reserve_next(&heap->handle_of)
+            || (heap->free_handle == -1 && !reserve_next(&heap->index_of))) {
+        return -1;
+    }
+
+    int const handle = alloc_handle(heap);
+    basic_vector_emplace_back(&heap->elems);
+    basic_vector_emplace_back(&heap->handle_of);
+
+    place(heap, elem_count, elem, handle);
+    sift_up(heap, elem_count);
+    return handle;
+}
+
+void basic_heap_pop(basic_heap *heap, void *out)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    BASIC_ASSERT(basic_heap_isinit(heap) && !basic_heap_isempty(heap),
+            "basic_heap object must be initialised and non-empty");
+
+    if (out) {
+        memcpy(out, elem_at_c(heap, 0), heap->elems.data.elem_size);
+    }
+
+    remove_at(heap, 0);
+}
+
+void const *basic_heap_top(basic_heap const *heap)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    BASIC_ASSERT(basic_heap_isinit(heap) && !basic_heap_isempty(heap),
+            "basic_heap object must be initialised and non-empty");
+
+    return elem_at_c(heap, 0);
+}
+
+int basic_heap_top_handle(basic_heap const *heap)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    BASIC_ASSERT(basic_heap_isinit(heap) && !basic_heap_isempty(heap),
+            "basic_heap object must be initialised and non-empty");
+
+    return ints_c(&heap->handle_of)[0];
+}
+
+void basic_heap_replace_top(basic_heap *heap, void const *elem)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    BASIC_ASSERT_PTR_NONNULL(elem);
+    BASIC_ASSERT(basic_heap_isinit(heap) && !basic_heap_isempty(heap),
+            "basic_heap object must be initialised and non-empty");
+
+    memcpy(elem_at(heap, 0), elem, heap->elems.data.elem_size);
+    sift_down(heap, 0);
+}
+
+void basic_heap_update(basic_heap *heap, int handle, void const *elem)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    BASIC_ASSERT_PTR_NONNULL(elem);
+    BASIC_ASSERT(basic_heap_isinit(heap),
+            "basic_heap object must be initialised");
+    BASIC_ASSERT(handle >= 0 && (size_t)handle < heap->index_of.elem_count
+            && ints_c(&heap->index_of)[handle] >= 0,
+            "handle %d is not live", handle);
+
+    int const pos = ints(&heap->index_of)[handle];
+    memcpy(elem_at(heap, pos), elem, heap->elems.data.elem_size);
+    restore(heap, pos);
+}
+
+void basic_heap_erase(basic_heap *heap, int handle)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    BASIC_ASSERT(basic_heap_isinit(heap),
+            "basic_heap object must be initialised");
+    BASIC_ASSERT(handle >= 0 && (size_t)handle < heap->index_of.elem_count
+            && ints_c(&heap->index_of)[handle] >= 0,
+            "handle %d is not live", handle);
+
+    remove_at(heap, ints(&heap->index_of)[handle]);
+}
+
+void const *basic_heap_at_handle(basic_heap const *heap, int handle)
+{
+    BASIC_ASSERT_PTR_NONNULL(heap);
+    BASIC_ASSERT(basic_heap_isinit(heap),
+            "basic_heap object must be initialised");
+    BASIC_ASSERT(handle >= 0 && (size_t)handle < heap->index_of.elem_count
+            && ints_c(&heap->index_of)[handle] >= 0,
+            "handle %d is not live", handle);
+
+    return elem_at_c(heap, ints_c(&heap->index_of)[handle]);
+}
+
+basic_heap heap_alloc(
+        size_t elem_size,
+        int elem_cap,
+        int handle_cap,
+        basic_heap_order order)
+{
+    BASIC_ASSERT(order.arity >= 2, "arity %d must be at least 2", order.arity);
+
+    basic_heap heap = {
+        .elems = basic_vector_new(elem_size, elem_cap),
+        .handle_of = basic_vector_new(sizeof(int), handle_cap),
+        .index_of = basic_vector_new(sizeof(int), handle_cap),
+        .scratch = basic_block_alloc(elem_size),
+        .order = order,
+        .free_handle = -1
+    };
+
+    if (basic_vector_isnull(&heap.elems)
+            || basic_vector_isnull(&heap.handle_of)
+            || basic_vector_isnull(&heap.index_of)
+            || basic_block_isnull(&heap.scratch)) {
+        basic_vector_destroy(&heap.elems);
+        basic_vector_destroy(&heap.handle_of);
+        basic_vector_destroy(&heap.index_of);
+        basic_block_dealloc(&heap.scratch);
+        return BASIC_HEAP_NULL;
+    }
+
+    return heap;
+}
+
+bool before(basic_heap const *heap, void const *lhs, void const *rhs)
+{
+    if (heap->order.cmp) {
+        return heap->order.cmp(lhs, rhs, heap->order.ctx) < 0;
+    }
+
+    uint64_t lhs_key;
+    uint64_t rhs_key;
+    memcpy(&lhs_key,
+            (unsigned char const *)lhs + heap->order.key_offset,
+            sizeof lhs_key);
+    memcpy(&rhs_key,
+            (unsigned char const *)rhs + heap->order.key_offset,
+            sizeof rhs_key);
+    return lhs_key < rhs_key;
+}
+
+void place(basic_heap *heap, int pos, void const *elem, int handle)
+{
+    memcpy(elem_at(heap, pos), elem, heap->elems.data.elem_size);
+    ints(&heap->handle_of)[pos] = handle;
+    ints(&heap->index_of)[handle] = pos;
+}
+
+void sift_up(basic_heap *heap, int pos)
+{
+    // Lift the element into scratch and move parents down into the hole,
+    // so each level costs one copy rather than a swap
+    void *const elem = heap->scratch.ptr;
+    int const handle = ints(&heap->handle_of)[pos];
+    memcpy(elem, elem_at_c(heap, pos), heap->elems.data.elem_size);
+
+    while (pos > 0) {
+        int const parent = (pos - 1) / heap->order.arity;
+        if (!before(heap, elem, elem_at_c(heap, parent))) {
+            break;
+        }
+
+        place(heap, pos, elem_at_c(heap, parent),
+                ints(&heap->handle_of)[parent]);
+        pos = parent;
+    }
+
+    place(heap, pos, elem, handle);
+}
+
+void sift_down(basic_heap *heap, int pos)
+{
+    void *const elem = heap->scratch.ptr;
+    int const handle = ints(&heap->handle_of)[pos];
+    int const elem_count = (int)heap->elems.elem_count;
+    memcpy(elem, elem_at_c(heap, pos), heap->elems.data.elem_size);
+
+    for (;;) {
+        int const first = pos * heap->order.arity + 1;
+        if (first >= elem_count) {
+            break;
+        }
+
+        int const last = first + heap->order.arity < elem_count
+            ? first + heap->order.arity
+            : elem_count;
+
+        int best = first;
+        for (int child = first + 1; child < last; ++child) {
+            if (before(heap, elem_at_c(heap, child), elem_at_c(heap, best))) {
+                best = child;
+            }
+        }
+
+        if (!before(heap, elem_at_c(heap, best), elem)) {
+            break;
+        }
+
+        place(heap, pos, elem_at_c(heap, best), ints(&heap->handle_of)[best]);
+        pos = best;
+    }
+
+    place(heap, pos, elem, handle);
+}
+
+void restore(basic_heap *heap, int pos)
+{
+    int const parent = (pos - 1) / heap->order.arity;
+    if (pos > 0 && before(heap, elem_at_c(heap, pos), elem_at_c(heap, parent))) {
+        sift_up(heap, pos);
+    } else {
+        sift_down(heap, pos);
+    }
+}
+
+void remove_at(basic_heap *heap, int pos)
+{
+    int const last = (int)heap->elems.elem_count - 1;
+    free_handle(heap, ints(&heap->handle_of)[pos]);
+
+    // Move the last element into the hole, then put it in its place
+    if (pos != last) {
+        place(heap, pos, elem_at_c(heap, last), ints(&heap->handle_of)[last]);
+    }
+
+    basic_vector_removeback(&heap->elems);
+    basic_vector_removeback(&heap->handle_of);
+
+    if (pos != last) {
+        restore(heap, pos);
+    }
+}
+
+int alloc_handle(basic_heap *heap)
+{
+    if (heap->free_handle != -1) {
+        int const handle = heap->free_handle;
+        heap->free_handle = -2 - ints(&heap->index_of)[handle];
+        return handle;
+    }
+
+    basic_vector_emplace_back(&heap->index_of);
+    return (int)heap->index_of.elem_count - 1;
+}
+
+void free_handle(basic_heap *heap, int handle)
+{
+    ints(&heap->index_of)[handle] = -2 - heap->free_handle;
+    heap->free_handle = handle;
+}
+
+bool reserve_next(basic_vector *vector)
+{
+    // Room for one more element, grown by the vector's own policy so that
+    // a run of pushes reallocates only a logarithmic number of times
+    if (vector->elem_count < vector->elem_cap) {
+        return true;
+    }
+
+    size_t const elem_cap = basic_growth_next_cap(&vector->growth,
+            vector->elem_cap,
+            vector->elem_count + 1,
+            vector->data.elem_size);
+    return elem_cap && basic_vector_reserve(vector, elem_cap);
+}
+
+// Elements and positions are addressed directly rather than through
+// basic_vector_at, which is out of line and would be called per comparison
+unsigned char *elem_at(basic_heap *heap, int pos)
+{
+    return (unsigned char *)heap->elems.data.data.ptr
+        + (size_t)pos * heap->elems.data.elem_size;
+}
+
+unsigned char const *elem_at_c(basic_heap const *heap, int pos)
+{
+    return (unsigned char const *)heap->elems.data.data.ptr
+        + (size_t)pos * heap->elems.data.elem_size;
+}
+
+int *ints(basic_vector *vector)
+{
+    return vector->data.data.ptr;
+}
+
+int const *ints_c(basic_vector const *vector)
+{
+    return vector->data.data.ptr;
+}
@@ -0,0 +1,363 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "intern_table.h"
+
+#include <limits.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "block.h"
+#include "hash.h"
+
+enum {
+    min_index_cap = 16,
+    block_size = 64 * 1024,
+    // Strings larger than this get a block to themselves, so that they do
+    // not waste the rest of a shared one
+    max_shared_size = block_size / 4
+};
+
+struct basic_intern_index {
+    basic_intern_index *prev;
+    size_t mask;
+    atomic_uint_least64_t slots[];
+};
+
+struct basic_intern_block {
+    basic_intern_block *prev;
+    size_t size;
+    size_t used;
+    max_align_t data[];
+};
+
+static basic_intern_index *index_alloc(size_t cap);
+static void index_free(basic_intern_index *index);
+static uint_least64_t slot_for(uint64_t hash, int id);
+static void index_insert(basic_intern_index *index, uint64_t hash, int id);
+static bool index_grow(basic_intern_table *table);
+static int index_find(
+        basic_intern_table const *table,
+        basic_span const *string,
+        uint64_t hash);
+static char *store_bytes(basic_intern_table *table, basic_span const *string);
+static void lock_writers(basic_intern_table *table);
+static void unlock_writers(basic_intern_table *table);
+
+basic_intern_table basic_intern_table_new(int initial_cap)
+{
+    BASIC_ASSERT_POSITIVE(initial_cap);
+
+    // Keep the index at most half full
+    size_t index_cap = min_index_cap;
+    while (index_cap < 2 * (size_t)initial_cap) {
+        index_cap *= 2;
+    }
+
+    basic_concurrent_vector strings = basic_concurrent_vector_new(
+            sizeof(basic_span),
+            initial_cap);
+    basic_intern_index *const index = index_alloc(index_cap);
+    if (basic_concurrent_vector_isnull(&strings) || !index) {
+        basic_concurrent_vector_destroy(&strings);
+        index_free(index);
+        return BASIC_INTERN_TABLE_NULL;
+    }
+
+    basic_intern_table table = {
+        .strings = strings,
+        .write_lock = ATOMIC_FLAG_INIT
+    };
+
+    atomic_init(&table.index, index);
+    return table;
+}
+
+void basic_intern_table_destroy(basic_intern_table *table)
+{
+    BASIC_ASSERT_PTR_NONNULL(table);
+
+    if (!basic_intern_table_isinit(table)) {
+        return;
+    }
+
+    for (basic_intern_index *index = atomic_load_explicit(&table->index,
+                memory_order_relaxed);
+            index;) {
+        basic_intern_index *const prev = index->prev;
+        index_free(index);
+        index = prev;
+    }
+
+    while (table->blocks) {
+        basic_intern_block *const prev = table->blocks->prev;
+        basic_block block = {
+            .ptr = table->blocks,
+            .size = sizeof(basic_intern_block) + table->blocks->size
+        };
+
+        basic_block_dealloc(&block);
+        table->blocks = prev;
+    }
+
+    basic_concurrent_vector_destroy(&table->strings);
+    *table = BASIC_INTERN_TABLE_NULL;
+}
+
+int basic_intern_table_intern(
+        basic_intern_table *table,
+        basic_span const *string)
+{
+    BASIC_ASSERT_PTR_NONNULL(table);
+    BASIC_ASSERT_PTR_NONNULL(string);
+    BASIC_ASSERT(basic_intern_table_isinit(table),
+            "basic_intern_table object must be initialised");
+    BASIC_ASSERT(string->ptr || !string->size,
+            "a non-empty string must have data");
+
+    uint64_t const hash = basic_hash_bytes(string->ptr, string->size, 0);
+
+    // Strings already present are found without taking the lock
+    int id = index_find(table, string, hash);
+    if (id >= 0) {
+        return id;
+    }
+
+    lock_writers(table);
+
+    // Another writer may have added it in the meantime
+    id = index_find(table, string, hash);
+    if (id >= 0) {
+        unlock_writers(table);
+        return id;
+    }
+
+    char *bytes = NULL;
+    if (table->index_count == INT_MAX
+            || (2 * ((size_t)table->index_count + 1)
+                    > atomic_load_explicit(&table->index,
+                        memory_order_relaxed)->mask + 1
+                && !index_grow(table))
+            || !(bytes = store_bytes(table, string))) {
+        unlock_writers(table);
+        return -1;
+    }
+
+    // Publish the string before the index slot that leads to it
+    basic_span const stored = {bytes, string->size};
+    id = basic_concurrent_vector_append(&table->strings, &stored);
+    if (id >= 0) {
+        index_insert(atomic_load_explicit(&table->index, memory_order_relaxed),
+                hash,
+                id);
+        ++table->index_count;
+    }
+
+    unlock_writers(table);
+    return id;
+}
+
+int basic_intern_table_find(
+        basic_intern_table const *table,
+        basic_span const *string)
+{
+    BASIC_ASSERT_PTR_NONNULL(table);
+    BASIC_ASSERT_PTR_NONNULL(string);
+    BASIC_ASSERT(basic_intern_table_isinit(table),
+            "basic_intern_table object must be initialised");
+    BASIC_ASSERT(string->ptr || !string->size,
+            "a non-empty string must have data");
+
+    return index_find(table,
+            string,
+            basic_hash_bytes(string->ptr, string->size, 0));
+}
+
+basic_span basic_intern_table_get(basic_intern_table const *table, int id)
+{
+    BASIC_ASSERT_PTR_NONNULL(table);
+    BASIC_ASSERT(basic_intern_table_isinit(table),
+            "basic_intern_table object must be initialised");
+    BASIC_ASSERT(id >= 0 && id < basic_intern_table_count(table),
+            "id %d out of range", id);
+
+    basic_span const *const string =
+        basic_concurrent_vector_at_c(&table->strings, id);
+    BASIC_ASSERT(string, "id %d has not been published", id);
+    return *string;
+}
+
+basic_intern_index *index_alloc(size_t cap)
+{
+    basic_block block = basic_block_alloc(sizeof(basic_intern_index)
+            + cap * sizeof(atomic_uint_least64_t));
+    if (basic_block_isnull(&block)) {
+        return NULL;
+    }
+
+    basic_intern_index *const index = block.ptr;
+    index->prev = NULL;
+    index->mask = cap - 1;
+    for (size_t i = 0; i < cap; ++i) {
+        atomic_init(&index->slots[i], 0);
+    }
+
+    return index;
+}
+
+void index_free(basic_intern_index *index)
+{
+    if (!index) {
+        return;
+    }
+
+    basic_block block = {
+        .ptr = index,
+        .size = sizeof(basic_intern_index)
+            + (index->mask + 1) * sizeof(atomic_uint_least64_t)
+    };
+
+    basic_block_dealloc(&block);
+}
+
+uint_least64_t slot_for(uint64_t hash, int id)
+{
+    // The top half of the hash screens out most mismatches without touching
+    // the string. Zero marks an empty slot, so ids are stored off by one.
+    return (hash & UINT64_C(0xffffffff00000000)) | ((uint64_t)id + 1);
+}
+
+void index_insert(basic_intern_index *index, uint64_t hash, int id)
+{
+    size_t i = hash & index->mask;
+    while (atomic_load_explicit(&index->slots[i], memory_order_relaxed)) {
+        i = (i + 1) & index->mask;
+    }
+
+    atomic_store_explicit(&index->slots[i],
+            slot_for(hash, id),
+            memory_order_release);
+}
+
+bool index_grow(basic_intern_table *table)
+{
+    basic_intern_index *const old = atomic_load_explicit(&table->index,
+            memory_order_relaxed);
+    size_t const cap = 2 * (old->mask + 1);
+    basic_intern_index *const index = index_alloc(cap);
+    if (!index) {
+        return false;
+    }
+
+    // The new table is private until it is published, so it can be filled
+    // with plain stores. Ids come from the strings, which every old slot
+    // leads to.
+    for (size_t i = 0; i <= old->mask; ++i) {
+        uint_least64_t const slot = atomic_load_explicit(&old->slots[i],
+                memory_order_relaxed);
+        if (!slot) {
+            continue;
+        }
+
+        int const id = (int)(slot & UINT64_C(0xffffffff)) - 1;
+        basic_span const *const string =
+            basic_concurrent_vector_at_c(&table->strings, id);
+        index_insert(index,
+                basic_hash_bytes(string->ptr, string->size, 0),
+                id);
+    }
+
+    // Readers may still be probing the old table, so it is kept rather than
+    // freed
+    index->prev = old;
+    atomic_store_explicit(&table->index, index, memory_order_release);
+    return true;
+}
+
+int index_find(
+        basic_intern_table const *table,
+        basic_span const *string,
+        uint64_t hash)
+{
+    basic_intern_index const *const index = atomic_load_explicit(
+            &table->index,
+            memory_order_acquire);
+    uint64_t const tag = hash & UINT64_C(0xffffffff00000000);
+
+    for (size_t i = hash & index->mask;; i = (i + 1) & index->mask) {
+        uint_least64_t const slot = atomic_load_explicit(&index->slots[i],
+                memory_order_acquire);
+        if (!slot) {
+            return -1;
+        }
+
+        if ((slot & UINT64_C(0xffffffff00000000)) != tag) {
+            continue;
+        }
+
+        int const id = (int)(slot & UINT64_C(0xffffffff)) - 1;
+        basic_span const *const stored =
+            basic_concurrent_vector_at_c(&table->strings, id);
+        if (stored->size == string->size
+                && !memcmp(stored->ptr, string->ptr, string->size)) {
+            return id;
+        }
+    }
+}
+
+char *store_bytes(basic_intern_table *table, basic_span const *string)
+{
+    if (string->size > SIZE_MAX - sizeof(basic_intern_block) - 1) {
+        return NULL;
+    }
+
+    size_t const size = string->size + 1;
+    basic_intern_block *block = table->blocks;
+
+    if (!block || block->size - block->used < size) {
+        size_t const data_size = size > max_shared_size ? size : block_size;
+        basic_block alloc = basic_block_alloc(sizeof(basic_intern_block)
+                + data_size);
+        if (basic_block_isnull(&alloc)) {
+            return NULL;
+        }
+
+        basic_intern_block *const fresh = alloc.ptr;
+        fresh->size = data_size;
+        fresh->used = 0;
+
+        // A string with its own block goes behind the shared one, so that
+        // the space left there can still be used
+        if (block && size > max_shared_size) {
+            fresh->prev = block->prev;
+            block->prev = fresh;
+        } else {
+            fresh->prev = block;
+            table->blocks = fresh;
+        }
+
+        block = fresh;
+    }
+
+    char *const bytes = (char *)block->data + block->used;
+    if (string->size) {
+        memcpy(bytes, string->ptr, string->size);
+    }
+
+    bytes[string->size] = '\0';
+    block->used += size;
+    return bytes;
+}
+
+void lock_writers(basic_intern_table *table)
+{
+    while (atomic_flag_test_and_set_explicit(&table->write_lock,
+                memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+void unlock_writers(basic_intern_table *table)
+{
+    atomic_flag_clear_explicit(&table->write_lock, memory_order_release);
+}
@@ -0,0 +1,272 @@
+#define _GNU_SOURCE
+
+#include "mapped_vector.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "hash.h"
+
+static_assert(sizeof(basic_mapped_vector_header)
+        <= BASIC_MAPPED_VECTOR_DATA_OFFSET,
+        "basic_mapped_vector_header must fit before the elements");
+
+static bool map_size_for(size_t elem_size, size_t elem_cap, size_t *size);
+static void init_header(basic_mapped_vector *vector, size_t elem_size);
+static bool check_header(basic_mapped_vector const *vector, size_t elem_size);
+static uint64_t header_checksum(basic_mapped_vector_header const *header);
+static bool remap(basic_mapped_vector *vector, size_t map_size);
+
+basic_mapped_vector basic_mapped_vector_open(
+        char const *path,
+        size_t elem_size,
+        size_t initial_cap)
+{
+    BASIC_ASSERT_PTR_NONNULL(path);
+    BASIC_ASSERT_NONZERO(elem_size);
+    BASIC_ASSERT_NONZERO(initial_cap);
+
+    basic_mapped_vector vector = BASIC_MAPPED_VECTOR_NULL;
+    vector.fd = open(path, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (vector.fd < 0) {
+        return BASIC_MAPPED_VECTOR_NULL;
+    }
+
+    struct stat st;
+    if (fstat(vector.fd, &st)) {
+        goto fail;
+    }
+
+    bool const created = !st.st_size;
+    size_t map_size = (size_t)st.st_size;
+    if (created) {
+        if (!map_size_for(elem_size, initial_cap, &map_size)
+                || ftruncate(vector.fd, (off_t)map_size)) {
+            goto fail;
+        }
+    } else if ((uintmax_t)st.st_size > SIZE_MAX
+            || map_size < BASIC_MAPPED_VECTOR_DATA_OFFSET + elem_size) {
+        goto fail;
+    }
+
+    void *const map = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED, vector.fd, 0);
+    if (map == MAP_FAILED) {
+        goto fail;
+    }
+
+    vector.header = map;
+    vector.map_size = map_size;
+    vector.elem_cap = (map_size - BASIC_MAPPED_VECTOR_DATA_OFFSET) / elem_size;
+
+    if (created) {
+        init_header(&vector, elem_size);
+        return vector;
+    }
+
+    if (check_header(&vector, elem_size)) {
+        return vector;
+    }
+
+    munmap(map, map_size);
+
+fail:
+    close(vector.fd);
+    return BASIC_MAPPED_VECTOR_NULL;
+}
+
+void basic_mapped_vector_close(basic_mapped_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+
+    if (!basic_mapped_vector_isinit(vector)) {
+        return;
+    }
+
+    // The kernel writes the pages back after the unmap; only the checksum
+    // has to be brought up to date
+    vector->header->checksum = header_checksum(vector->header);
+    munmap(vector->header, vector->map_size);
+    close(vector->fd);
+    *vector = BASIC_MAPPED_VECTOR_NULL;
+}
+
+bool basic_mapped_vector_flush(basic_mapped_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_mapped_vector_isinit(vector),
+            "basic_mapped_vector object must be initialised");
+
+    vector->header->checksum = header_checksum(vector->header);
+    return !msync(vector->header, vector->map_size, MS_SYNC);
+}
+
+void basic_mapped_vector_set_growth(
+        basic_mapped_vector *vector,
+        basic_growth_policy growth)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_mapped_vector_isinit(vector),
+            "basic_mapped_vector object must be initialised");
+    BASIC_ASSERT(growth.kind != basic_growth_fixed || growth.increment > 0,
+            "fixed growth must have a positive increment");
+
+    vector->growth = growth;
+}
+
+bool basic_mapped_vector_reserve(basic_mapped_vector *vector, size_t elem_cap)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_mapped_vector_isinit(vector),
+            "basic_mapped_vector object must be initialised");
+
+    if (elem_cap <= vector->elem_cap) {
+        return true;
+    }
+
+    size_t map_size;
+    return map_size_for(vector->header->elem_size, elem_cap, &map_size)
+        && remap(vector, map_size);
+}
+
+bool basic_mapped_vector_append(
+        basic_mapped_vector *vector,
+        void const *src,
+        size_t count)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT(basic_mapped_vector_isinit(vector),
+            "basic_mapped_vector object must be initialised");
+
+    size_t const elem_size = vector->header->elem_size;
+    size_t const elem_count = vector->header->elem_count;
+
+    if (count > SIZE_MAX - elem_count) {
+        return false;
+    }
+
+    if (elem_count + count > vector->elem_cap) {
+        size_t const new_elem_cap = basic_growth_next_cap(
+                &vector->growth,
+                vector->elem_cap,
+                elem_count + count,
+                elem_size);
+        if (!new_elem_cap
+                || !basic_mapped_vector_reserve(vector, new_elem_cap)) {
+            return false;
+        }
+    }
+
+    memcpy((unsigned char *)basic_mapped_vector_data(vector)
+            + elem_count * elem_size,
+            src,
+            count * elem_size);
+    vector->header->elem_count += count;
+    return true;
+}
+
+void basic_mapped_vector_removeback(basic_mapped_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(!basic_mapped_vector_isempty(vector),
+            "basic_mapped_vector object must be non-empty");
+
+    --vector->header->elem_count;
+}
+
+void *basic_mapped_vector_at(basic_mapped_vector *vector, size_t index)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_mapped_vector_isinit(vector),
+            "basic_mapped_vector object must be initialised");
+    BASIC_ASSERT(index < vector->header->elem_count,
+            "index %zu out of range",
+            index);
+
+    return (unsigned char *)basic_mapped_vector_data(vector)
+        + index * vector->header->elem_size;
+}
+
+bool map_size_for(size_t elem_size, size_t elem_cap, size_t *size)
+{
+    if (elem_cap > (SIZE_MAX - BASIC_MAPPED_VECTOR_DATA_OFFSET) / elem_size
+            || BASIC_MAPPED_VECTOR_DATA_OFFSET + elem_cap * elem_size
+                > (uintmax_t)INTMAX_MAX) {
+        return false;
+    }
+
+    *size = BASIC_MAPPED_VECTOR_DATA_OFFSET + elem_cap * elem_size;
+    return true;
+}
+
+void init_header(basic_mapped_vector *vector, size_t elem_size)
+{
+    *vector->header = (basic_mapped_vector_header) {
+        .magic = BASIC_MAPPED_VECTOR_MAGIC,
+        .version = BASIC_MAPPED_VECTOR_VERSION,
+        .data_offset = BASIC_MAPPED_VECTOR_DATA_OFFSET,
+        .elem_size = elem_size,
+        .elem_count = 0
+    };
+
+    vector->header->checksum = header_checksum(vector->header);
+}
+
+bool check_header(basic_mapped_vector const *vector, size_t elem_size)
+{
+    basic_mapped_vector_header const *const header = vector->header;
+
+    return header->magic == BASIC_MAPPED_VECTOR_MAGIC
+        && header->version == BASIC_MAPPED_VECTOR_VERSION
+        && header->data_offset == BASIC_MAPPED_VECTOR_DATA_OFFSET
+        && header->elem_size == elem_size
+        && header->elem_count <= vector->elem_cap
+        && header->checksum == header_checksum(header);
+}
+
+uint64_t header_checksum(basic_mapped_vector_header const *header)
+{
+    return basic_hash_bytes(header,
+            offsetof(basic_mapped_vector_header, checksum),
+            BASIC_MAPPED_VECTOR_MAGIC);
+}
+
+bool remap(basic_mapped_vector *vector, size_t map_size)
+{
+    size_t const elem_size = vector->header->elem_size;
+
+    if (ftruncate(vector->fd, (off_t)map_size)) {
+        return false;
+    }
+
+#ifdef MREMAP_MAYMOVE
+    void *const map = mremap(vector->header, vector->map_size, map_size,
+            MREMAP_MAYMOVE);
+#else
+    void *const map = mmap(NULL, map_size, PROT_READ | PROT_WRITE,
+            MAP_SHARED, vector->fd, 0);
+#endif
+
+    if (map == MAP_FAILED) {
+        // Give the file back its old size so that it still matches the
+        // mapping, which is unchanged. If that fails too, the extra space
+        // is simply unused.
+        bool const restored = !ftruncate(vector->fd, (off_t)vector->map_size);
+        (void) restored;
+        return false;
+    }
+
+#ifndef MREMAP_MAYMOVE
+    munmap(vector->header, vector->map_size);
+#endif
+
+    vector->header = map;
+    vector->map_size = map_size;
+    vector->elem_cap = (map_size - BASIC_MAPPED_VECTOR_DATA_OFFSET) / elem_size;
+    return true;
+}
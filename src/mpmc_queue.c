@@ -0,0 +1,232 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "mpmc_queue.h"
+
+#include <limits.h>
+#include <sched.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "bits.h"
+
+enum { spin_limit = 64 };
+
+static int claim(
+        basic_mpmc_queue *queue,
+        atomic_size_t *counter,
+        size_t ready_offset,
+        int n,
+        size_t *pos);
+static atomic_size_t *slot_seq(basic_mpmc_queue *queue, size_t pos);
+static void *slot_elem(basic_mpmc_queue *queue, size_t pos);
+static void backoff(int *spins);
+
+basic_mpmc_queue basic_mpmc_queue_new(size_t elem_size, int cap)
+{
+    BASIC_ASSERT_NONZERO(elem_size);
+    BASIC_ASSERT_POSITIVE(cap);
+
+    // Each slot is a sequence number followed by the element, padded so
+    // that the next slot's sequence number is aligned
+    size_t const align = alignof(atomic_size_t);
+    size_t const slot_size =
+        (sizeof(atomic_size_t) + elem_size + align - 1) / align * align;
+
+    uint64_t const pow2 = basic_bits_ceil_pow2(cap < 2 ? 2 : (uint64_t)cap);
+    if (pow2 > INT_MAX) {
+        return BASIC_MPMC_QUEUE_NULL;
+    }
+
+    int const elem_cap = (int)pow2;
+    basic_array slots = basic_array_alloc(slot_size, elem_cap);
+    if (basic_array_isnull(&slots)) {
+        return BASIC_MPMC_QUEUE_NULL;
+    }
+
+    basic_mpmc_queue queue = BASIC_MPMC_QUEUE_NULL;
+    queue.slots = basic_array_move(&slots);
+    queue.elem_size = elem_size;
+    queue.elem_cap = elem_cap;
+    atomic_init(&queue.enqueue_pos, 0);
+    atomic_init(&queue.dequeue_pos, 0);
+
+    // Slot i starts out free for the producer at position i
+    for (int i = 0; i < elem_cap; ++i) {
+        atomic_init(slot_seq(&queue, (size_t)i), (size_t)i);
+    }
+
+    return queue;
+}
+
+void basic_mpmc_queue_destroy(basic_mpmc_queue *queue)
+{
+    BASIC_ASSERT_PTR_NONNULL(queue);
+
+    if (basic_mpmc_queue_isinit(queue)) {
+        basic_array_dealloc(&queue->slots);
+        *queue = BASIC_MPMC_QUEUE_NULL;
+    }
+}
+
+int basic_mpmc_queue_try_push_n(
+        basic_mpmc_queue *queue,
+        void const *elems,
+        int n)
+{
+    BASIC_ASSERT_PTR_NONNULL(queue);
+    BASIC_ASSERT_PTR_NONNULL(elems);
+    BASIC_ASSERT(basic_mpmc_queue_isinit(queue),
+            "basic_mpmc_queue object must be initialised");
+    BASIC_ASSERT(n >= 0, "count %d must be non-negative", n);
+
+    size_t pos;
+    int const count = claim(queue, &queue->enqueue_pos, 0, n, &pos);
+
+    for (int i = 0; i < count; ++i, ++pos) {
+        memcpy(slot_elem(queue, pos),
+                (char const *)elems + (size_t)i * queue->elem_size,
+                queue->elem_size);
+        atomic_store_explicit(slot_seq(queue, pos),
+                pos + 1,
+                memory_order_release);
+    }
+
+    return count;
+}
+
+int basic_mpmc_queue_try_pop_n(basic_mpmc_queue *queue, void *elems, int n)
+{
+    BASIC_ASSERT_PTR_NONNULL(queue);
+    BASIC_ASSERT_PTR_NONNULL(elems);
+    BASIC_ASSERT(basic_mpmc_queue_isinit(queue),
+            "basic_mpmc_queue object must be initialised");
+    BASIC_ASSERT(n >= 0, "count %d must be non-negative", n);
+
+    size_t pos;
+    int const count = claim(queue, &queue->dequeue_pos, 1, n, &pos);
+
+    for (int i = 0; i < count; ++i, ++pos) {
+        memcpy((char *)elems + (size_t)i * queue->elem_size,
+                slot_elem(queue, pos),
+                queue->elem_size);
+
+        // Free the slot for the producer one lap ahead
+        atomic_store_explicit(slot_seq(queue, pos),
+                pos + (size_t)queue->elem_cap,
+                memory_order_release);
+    }
+
+    return count;
+}
+
+void basic_mpmc_queue_push_n(
+        basic_mpmc_queue *queue,
+        void const *elems,
+        int n)
+{
+    int pushed = 0;
+    int spins = 0;
+
+    while (pushed < n) {
+        int const count = basic_mpmc_queue_try_push_n(queue,
+                (char const *)elems + (size_t)pushed * queue->elem_size,
+                n - pushed);
+        if (count) {
+            pushed += count;
+            spins = 0;
+        } else {
+            backoff(&spins);
+        }
+    }
+}
+
+void basic_mpmc_queue_pop_n(basic_mpmc_queue *queue, void *elems, int n)
+{
+    int popped = 0;
+    int spins = 0;
+
+    while (popped < n) {
+        int const count = basic_mpmc_queue_try_pop_n(queue,
+                (char *)elems + (size_t)popped * queue->elem_size,
+                n - popped);
+        if (count) {
+            popped += count;
+            spins = 0;
+        } else {
+            backoff(&spins);
+        }
+    }
+}
+
+int claim(
+        basic_mpmc_queue *queue,
+        atomic_size_t *counter,
+        size_t ready_offset,
+        int n,
+        size_t *pos)
+{
+    // With nothing to claim, the loop below would never see a slot that
+    // tells it to stop
+    if (!n) {
+        return 0;
+    }
+
+    size_t start = atomic_load_explicit(counter, memory_order_relaxed);
+
+    for (;;) {
+        // Count the consecutive slots from start that are ready for us. A
+        // ready slot cannot change until its position is claimed, so if the
+        // counter still holds start they are all ours after the swap.
+        int count = 0;
+        intptr_t diff = 0;
+        while (count < n) {
+            size_t const at = start + (size_t)count;
+            size_t const seq = atomic_load_explicit(slot_seq(queue, at),
+                    memory_order_acquire);
+
+            diff = (intptr_t)(seq - (at + ready_offset));
+            if (diff) {
+                break;
+            }
+
+            ++count;
+        }
+
+        if (!count && diff < 0) {
+            // The slot at start is still a lap behind: full or empty
+            return 0;
+        }
+
+        if (!count) {
+            // Another thread claimed start already
+            start = atomic_load_explicit(counter, memory_order_relaxed);
+        } else if (atomic_compare_exchange_weak_explicit(counter,
+                    &start,
+                    start + (size_t)count,
+                    memory_order_relaxed,
+                    memory_order_relaxed)) {
+            *pos = start;
+            return count;
+        }
+    }
+}
+
+atomic_size_t *slot_seq(basic_mpmc_queue *queue, size_t pos)
+{
+    int const slot = (int)(pos & (size_t)(queue->elem_cap - 1));
+    return basic_array_at(&queue->slots, slot);
+}
+
+void *slot_elem(basic_mpmc_queue *queue, size_t pos)
+{
+    return slot_seq(queue, pos) + 1;
+}
+
+void backoff(int *spins)
+{
+    if (*spins < spin_limit) {
+        ++*spins;
+    } else {
+        sched_yield();
+    }
+}
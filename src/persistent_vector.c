@@ -0,0 +1,468 @@
+#include "persistent_vector.h"
+
+#include <stdatomic.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "block.h"
+
+enum {
+    bits = BASIC_PERSISTENT_VECTOR_BITS,
+    branch = BASIC_PERSISTENT_VECTOR_BRANCH,
+    mask = BASIC_PERSISTENT_VECTOR_BRANCH - 1
+};
+
+// Interior nodes hold branch child pointers and leaves hold branch
+// elements. Which one a node is follows from its level, so it is not
+// stored.
+struct basic_persistent_vector_node {
+    atomic_size_t refs;
+    max_align_t slots[];
+};
+
+typedef basic_persistent_vector_node node;
+
+static size_t node_size(size_t elem_size, int level);
+static node *node_alloc(size_t elem_size, int level);
+static node *node_copy(node const *n, size_t elem_size, int level);
+static void retain(node *n);
+static void release(node *n, size_t elem_size, int level);
+static bool make_unique(node **slot, size_t elem_size, int level);
+static node *new_path(node *leaf, size_t elem_size, int level);
+static bool push_tail(
+        basic_persistent_vector *vector,
+        node **slot,
+        int level,
+        node *tail);
+static bool pop_tail(basic_persistent_vector *vector, node **slot, int level);
+static node *leaf_for(basic_persistent_vector const *vector, size_t index);
+static size_t tail_offset(size_t elem_count);
+static inline node **children(node *n);
+static inline unsigned char *elems(node *n);
+
+basic_persistent_vector basic_persistent_vector_move(
+        basic_persistent_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_persistent_vector_isinit(vector),
+            "basic_persistent_vector object must be initialised");
+
+    basic_persistent_vector temp = *vector;
+    *vector = BASIC_PERSISTENT_VECTOR_NULL;
+    return temp;
+}
+
+basic_persistent_vector basic_persistent_vector_clone(
+        basic_persistent_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_persistent_vector_isnull(vector)
+            || basic_persistent_vector_isinit(vector),
+            "basic_persistent_vector object must be null or initialised");
+
+    retain(vector->root);
+    retain(vector->tail);
+    return *vector;
+}
+
+basic_persistent_vector basic_persistent_vector_new(size_t elem_size)
+{
+    BASIC_ASSERT_NONZERO(elem_size);
+
+    return (basic_persistent_vector) {
+        .root = NULL,
+        .tail = NULL,
+        .elem_size = elem_size,
+        .elem_count = 0,
+        .shift = bits
+    };
+}
+
+void basic_persistent_vector_destroy(basic_persistent_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+
+    if (basic_persistent_vector_isinit(vector)) {
+        release(vector->root, vector->elem_size, vector->shift);
+        release(vector->tail, vector->elem_size, 0);
+        *vector = BASIC_PERSISTENT_VECTOR_NULL;
+    }
+}
+
+bool basic_persistent_vector_set(
+        basic_persistent_vector *vector,
+        size_t index,
+        void const *elem)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT_PTR_NONNULL(elem);
+    BASIC_ASSERT(basic_persistent_vector_isinit(vector),
+            "basic_persistent_vector object must be initialised");
+    BASIC_ASSERT(index < vector->elem_count, "index %zu out of range", index);
+
+    size_t const elem_size = vector->elem_size;
+    node **slot = &vector->tail;
+
+    // Copy whichever nodes on the path are shared, top down, so that the
+    // reference counts seen further down reflect the copies above
+    if (index < tail_offset(vector->elem_count)) {
+        slot = &vector->root;
+        for (int level = vector->shift; level > 0; level -= bits) {
+            if (!make_unique(slot, elem_size, level)) {
+                return false;
+            }
+
+            slot = &children(*slot)[(index >> level) & mask];
+        }
+    }
+
+    if (!make_unique(slot, elem_size, 0)) {
+        return false;
+    }
+
+    memcpy(elems(*slot) + (index & mask) * elem_size, elem, elem_size);
+    return true;
+}
+
+bool basic_persistent_vector_pushback(
+        basic_persistent_vector *vector,
+        void const *elem)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT_PTR_NONNULL(elem);
+    BASIC_ASSERT(basic_persistent_vector_isinit(vector),
+            "basic_persistent_vector object must be initialised");
+
+    size_t const elem_size = vector->elem_size;
+    size_t const count = vector->elem_count;
+
+    if (!vector->tail) {
+        vector->tail = node_alloc(elem_size, 0);
+        if (!vector->tail) {
+            return false;
+        }
+    } else if (count - tail_offset(count) < branch) {
+        if (!make_unique(&vector->tail, elem_size, 0)) {
+            return false;
+        }
+    } else {
+        // The tail is full: move it into the tree and start a new one
+        node *const new_tail = node_alloc(elem_size, 0);
+        if (!new_tail) {
+            return false;
+        }
+
+        if ((count >> bits) > ((size_t)1 << vector->shift)) {
+            // The tree is full at this height, so it gains a level
+            node *const new_root = node_alloc(elem_size, vector->shift + bits);
+            node *const path = new_root
+                ? new_path(vector->tail, elem_size, vector->shift)
+                : NULL;
+            if (!path) {
+                release(new_root, elem_size, vector->shift + bits);
+                release(new_tail, elem_size, 0);
+                return false;
+            }
+
+            children(new_root)[0] = vector->root;
+            children(new_root)[1] = path;
+            vector->root = new_root;
+            vector->shift += bits;
+        } else if (!push_tail(vector, &vector->root, vector->shift,
+                    vector->tail)) {
+            release(new_tail, elem_size, 0);
+            return false;
+        }
+
+        vector->tail = new_tail;
+    }
+
+    memcpy(elems(vector->tail) + (count & mask) * elem_size, elem, elem_size);
+    ++vector->elem_count;
+    return true;
+}
+
+bool basic_persistent_vector_popback(basic_persistent_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_persistent_vector_isinit(vector)
+            && !basic_persistent_vector_isempty(vector),
+            "basic_persistent_vector object must be initialised and "
+            "non-empty");
+
+    size_t const elem_size = vector->elem_size;
+    size_t const count = vector->elem_count;
+
+    if (count == 1) {
+        release(vector->root, elem_size, vector->shift);
+        release(vector->tail, elem_size, 0);
+        vector->root = NULL;
+        vector->tail = NULL;
+        vector->shift = bits;
+        vector->elem_count = 0;
+        return true;
+    }
+
+    // Slots past the count are never read, so dropping an element from a
+    // tail that keeps others writes nothing
+    if (count - tail_offset(count) > 1) {
+        --vector->elem_count;
+        return true;
+    }
+
+    // The tail is emptied, so the tree's last leaf becomes the tail
+    node *const new_tail = leaf_for(vector, count - 2);
+    retain(new_tail);
+
+    if (!pop_tail(vector, &vector->root, vector->shift)) {
+        release(new_tail, elem_size, 0);
+        return false;
+    }
+
+    release(vector->tail, elem_size, 0);
+    vector->tail = new_tail;
+    --vector->elem_count;
+
+    // Drop root levels that have a single child
+    while (vector->root && vector->shift > bits
+            && !children(vector->root)[1]) {
+        node *const child = children(vector->root)[0];
+        retain(child);
+        release(vector->root, elem_size, vector->shift);
+        vector->root = child;
+        vector->shift -= bits;
+    }
+
+    if (!vector->root) {
+        vector->shift = bits;
+    }
+
+    return true;
+}
+
+basic_persistent_vector basic_persistent_vector_with(
+        basic_persistent_vector const *vector,
+        size_t index,
+        void const *elem)
+{
+    basic_persistent_vector version = basic_persistent_vector_clone(vector);
+    if (!basic_persistent_vector_set(&version, index, elem)) {
+        basic_persistent_vector_destroy(&version);
+        return BASIC_PERSISTENT_VECTOR_NULL;
+    }
+
+    return version;
+}
+
+basic_persistent_vector basic_persistent_vector_with_pushback(
+        basic_persistent_vector const *vector,
+        void const *elem)
+{
+    basic_persistent_vector version = basic_persistent_vector_clone(vector);
+    if (!basic_persistent_vector_pushback(&version, elem)) {
+        basic_persistent_vector_destroy(&version);
+        return BASIC_PERSISTENT_VECTOR_NULL;
+    }
+
+    return version;
+}
+
+void const *basic_persistent_vector_at(
+        basic_persistent_vector const *vector,
+        size_t index)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_persistent_vector_isinit(vector),
+            "basic_persistent_vector object must be initialised");
+    BASIC_ASSERT(index < vector->elem_count, "index %zu out of range", index);
+
+    return elems(leaf_for(vector, index)) + (index & mask) * vector->elem_size;
+}
+
+size_t node_size(size_t elem_size, int level)
+{
+    return sizeof(node)
+        + branch * (level ? sizeof(node *) : elem_size);
+}
+
+node *node_alloc(size_t elem_size, int level)
+{
+    basic_block block = basic_block_alloc(node_size(elem_size, level));
+    if (basic_block_isnull(&block)) {
+        return NULL;
+    }
+
+    node *const n = block.ptr;
+    atomic_init(&n->refs, 1);
+    return n;
+}
+
+node *node_copy(node const *n, size_t elem_size, int level)
+{
+    node *const copy = node_alloc(elem_size, level);
+    if (!copy) {
+        return NULL;
+    }
+
+    memcpy(copy->slots, n->slots, node_size(elem_size, level) - sizeof(node));
+    if (level) {
+        for (int i = 0; i < branch; ++i) {
+            retain(children(copy)[i]);
+        }
+    }
+
+    return copy;
+}
+
+void retain(node *n)
+{
+    if (n) {
+        atomic_fetch_add_explicit(&n->refs, 1, memory_order_relaxed);
+    }
+}
+
+void release(node *n, size_t elem_size, int level)
+{
+    if (!n || atomic_fetch_sub_explicit(&n->refs, 1,
+                memory_order_acq_rel) != 1) {
+        return;
+    }
+
+    if (level) {
+        for (int i = 0; i < branch; ++i) {
+            release(children(n)[i], elem_size, level - bits);
+        }
+    }
+
+    basic_block block = {.ptr = n, .size = node_size(elem_size, level)};
+    basic_block_dealloc(&block);
+}
+
+bool make_unique(node **slot, size_t elem_size, int level)
+{
+    // A node only this path references can be changed in place; holding
+    // the only reference also means no other thread can take a new one
+    if (atomic_load_explicit(&(*slot)->refs, memory_order_acquire) == 1) {
+        return true;
+    }
+
+    node *const copy = node_copy(*slot, elem_size, level);
+    if (!copy) {
+        return false;
+    }
+
+    release(*slot, elem_size, level);
+    *slot = copy;
+    return true;
+}
+
+node *new_path(node *leaf, size_t elem_size, int level)
+{
+    // Build a chain of single-child nodes from leaf up to level. The chain
+    // takes over the caller's reference to leaf only on success.
+    node *top = leaf;
+    for (int l = bits; l <= level; l += bits) {
+        node *const parent = node_alloc(elem_size, l);
+        if (!parent) {
+            if (top != leaf) {
+                retain(leaf);
+                release(top, elem_size, l - bits);
+            }
+
+            return NULL;
+        }
+
+        children(parent)[0] = top;
+        top = parent;
+    }
+
+    return top;
+}
+
+bool push_tail(
+        basic_persistent_vector *vector,
+        node **slot,
+        int level,
+        node *tail)
+{
+    size_t const elem_size = vector->elem_size;
+
+    // A missing subtree is created holding just the new leaf
+    if (!*slot) {
+        *slot = new_path(tail, elem_size, level);
+        return *slot != NULL;
+    }
+
+    if (!make_unique(slot, elem_size, level)) {
+        return false;
+    }
+
+    node **const child =
+        &children(*slot)[((vector->elem_count - 1) >> level) & mask];
+    if (level == bits) {
+        *child = tail;
+        return true;
+    }
+
+    return push_tail(vector, child, level - bits, tail);
+}
+
+bool pop_tail(basic_persistent_vector *vector, node **slot, int level)
+{
+    size_t const elem_size = vector->elem_size;
+
+    // Every node on the path is made unique before anything is removed,
+    // so a failed copy leaves the tree as it was
+    if (!make_unique(slot, elem_size, level)) {
+        return false;
+    }
+
+    size_t const sub = ((vector->elem_count - 2) >> level) & mask;
+    node **const child = &children(*slot)[sub];
+
+    if (level > bits) {
+        if (!pop_tail(vector, child, level - bits)) {
+            return false;
+        }
+    } else {
+        release(*child, elem_size, 0);
+        *child = NULL;
+    }
+
+    // A node whose only child was removed goes too
+    if (!*child && !sub) {
+        release(*slot, elem_size, level);
+        *slot = NULL;
+    }
+
+    return true;
+}
+
+node *leaf_for(basic_persistent_vector const *vector, size_t index)
+{
+    if (index >= tail_offset(vector->elem_count)) {
+        return vector->tail;
+    }
+
+    node *n = vector->root;
+    for (int level = vector->shift; level > 0; level -= bits) {
+        n = children(n)[(index >> level) & mask];
+    }
+
+    return n;
+}
+
+size_t tail_offset(size_t elem_count)
+{
+    return elem_count < branch ? 0 : ((elem_count - 1) >> bits) << bits;
+}
+
+node **children(node *n)
+{
+    return (node **)(void *)n->slots;
+}
+
+unsigned char *elems(node *n)
+{
+    return (unsigned char *)n->slots;
+}
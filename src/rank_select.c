@@ -0,0 +1,156 @@
+#include "rank_select.h"
+
+enum {
+    words_per_superblock = 8,
+    bits_per_superblock = words_per_superblock * BASIC_BITS_PER_WORD
+};
+
+static int superblock_count(int bit_count);
+static int superblock_rank(basic_rank_select const *rank_select, int superblock);
+static int select_in_word(uint64_t word, int rank);
+
+basic_rank_select basic_rank_select_new(basic_bitset const *bitset)
+{
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(basic_bitset_isinit(bitset),
+            "basic_bitset object must be initialised");
+
+    int const superblocks = superblock_count(bitset->bit_count);
+    basic_array ranks = basic_array_alloc(sizeof(int), superblocks + 1);
+    if (basic_array_isnull(&ranks)) {
+        return BASIC_RANK_SELECT_NULL;
+    }
+
+    uint64_t const *const words = bitset->words.ptr;
+    int const word_count = basic_bits_words_for(bitset->bit_count);
+    int *const rank = basic_array_at(&ranks, 0);
+    int total = 0;
+
+    for (int superblock = 0; superblock < superblocks; ++superblock) {
+        int const begin = superblock * words_per_superblock;
+        int const end = begin + words_per_superblock < word_count
+            ? begin + words_per_superblock
+            : word_count;
+
+        rank[superblock] = total;
+        total += basic_bits_popcount_words(words + begin, end - begin);
+    }
+
+    rank[superblocks] = total;
+
+    return (basic_rank_select) {
+        .ranks = basic_array_move(&ranks),
+        .bit_count = bitset->bit_count
+    };
+}
+
+void basic_rank_select_destroy(basic_rank_select *rank_select)
+{
+    BASIC_ASSERT_PTR_NONNULL(rank_select);
+
+    if (basic_rank_select_isinit(rank_select)) {
+        basic_array_dealloc(&rank_select->ranks);
+        *rank_select = BASIC_RANK_SELECT_NULL;
+    }
+}
+
+int basic_rank_select_rank(
+        basic_rank_select const *rank_select,
+        basic_bitset const *bitset,
+        int index)
+{
+    BASIC_ASSERT_PTR_NONNULL(rank_select);
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(basic_rank_select_isinit(rank_select),
+            "basic_rank_select object must be initialised");
+    BASIC_ASSERT(rank_select->bit_count == bitset->bit_count,
+            "basic_rank_select was built from a different basic_bitset");
+    BASIC_ASSERT(index >= 0 && index <= bitset->bit_count,
+            "index %d out of range", index);
+
+    uint64_t const *const words = bitset->words.ptr;
+    int const superblock = index / bits_per_superblock;
+    int const word_index = index / BASIC_BITS_PER_WORD;
+    int const bit_index = index % BASIC_BITS_PER_WORD;
+
+    int rank = superblock_rank(rank_select, superblock);
+    for (int i = superblock * words_per_superblock; i < word_index; ++i) {
+        rank += basic_bits_popcount(words[i]);
+    }
+
+    if (bit_index) {
+        rank += basic_bits_popcount(
+                words[word_index] & ((UINT64_C(1) << bit_index) - 1));
+    }
+
+    return rank;
+}
+
+int basic_rank_select_select(
+        basic_rank_select const *rank_select,
+        basic_bitset const *bitset,
+        int rank)
+{
+    BASIC_ASSERT_PTR_NONNULL(rank_select);
+    BASIC_ASSERT_PTR_NONNULL(bitset);
+    BASIC_ASSERT(basic_rank_select_isinit(rank_select),
+            "basic_rank_select object must be initialised");
+    BASIC_ASSERT(rank_select->bit_count == bitset->bit_count,
+            "basic_rank_select was built from a different basic_bitset");
+    BASIC_ASSERT(rank >= 0, "rank %d must be non-negative", rank);
+
+    int const superblocks = superblock_count(bitset->bit_count);
+    if (rank >= superblock_rank(rank_select, superblocks)) {
+        return -1;
+    }
+
+    // Find the last superblock whose preceding count is <= rank
+    int lo = 0;
+    int hi = superblocks - 1;
+    while (lo < hi) {
+        int const mid = lo + (hi - lo + 1) / 2;
+        if (superblock_rank(rank_select, mid) <= rank) {
+            lo = mid;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    uint64_t const *const words = bitset->words.ptr;
+    int remaining = rank - superblock_rank(rank_select, lo);
+    int word_index = lo * words_per_superblock;
+
+    for (;; ++word_index) {
+        int const count = basic_bits_popcount(words[word_index]);
+        if (remaining < count) {
+            break;
+        }
+
+        remaining -= count;
+    }
+
+    return word_index * BASIC_BITS_PER_WORD
+        + select_in_word(words[word_index], remaining);
+}
+
+int superblock_count(int bit_count)
+{
+    return bit_count / bits_per_superblock
+        + (bit_count % bits_per_superblock != 0);
+}
+
+int superblock_rank(basic_rank_select const *rank_select, int superblock)
+{
+    return *(int const *)basic_array_at_c(&rank_select->ranks, superblock);
+}
+
+int select_in_word(uint64_t word, int rank)
+{
+    // Clear the lowest `rank` set bits; the answer is then the lowest
+    // remaining set bit
+    while (rank--) {
+        word &= word - 1;
+    }
+
+    return basic_bits_ctz(word);
+}
@@ -0,0 +1,325 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include "rcu_vector.h"
+
+#include <assert.h>
+#include <sched.h>
+
+#include "block.h"
+
+enum { retired_initial_cap = 4 };
+
+typedef struct {
+    basic_vector *vector;
+    uint_least64_t epoch;
+} retired_version;
+
+typedef struct {
+    atomic_uint_least64_t epoch;
+    atomic_bool claimed;
+} reader_slot_state;
+
+static_assert(sizeof(reader_slot_state) <= BASIC_CACHE_LINE_SIZE,
+        "a reader slot must fit in a cache line");
+
+#ifdef BASIC_DEBUG
+static bool is_registered(basic_rcu_vector *rcu, int reader);
+#endif
+
+static reader_slot_state *reader_slot(basic_rcu_vector *rcu, int reader);
+static uint_least64_t oldest_reader(basic_rcu_vector *rcu);
+static void wait_for_readers(basic_rcu_vector *rcu, uint_least64_t epoch);
+static int reclaim_before(basic_rcu_vector *rcu, uint_least64_t epoch);
+static void free_version(basic_vector *version);
+static void lock_writers(basic_rcu_vector *rcu);
+static void unlock_writers(basic_rcu_vector *rcu);
+
+basic_rcu_vector basic_rcu_vector_new(basic_vector *initial, int reader_cap)
+{
+    BASIC_ASSERT_PTR_NONNULL(initial);
+    BASIC_ASSERT(basic_vector_isinit(initial),
+            "basic_vector object must be initialised");
+    BASIC_ASSERT_POSITIVE(reader_cap);
+
+    basic_array readers = basic_array_alloc(BASIC_CACHE_LINE_SIZE,
+            (size_t)reader_cap + 1);
+    basic_vector retired = basic_vector_new(sizeof(retired_version),
+            retired_initial_cap);
+    basic_block boxed = basic_block_alloc(sizeof(basic_vector));
+
+    if (basic_array_isnull(&readers)
+            || basic_vector_isnull(&retired)
+            || basic_block_isnull(&boxed)) {
+        basic_array_dealloc(&readers);
+        basic_vector_destroy(&retired);
+        basic_block_dealloc(&boxed);
+        return BASIC_RCU_VECTOR_NULL;
+    }
+
+    basic_rcu_vector rcu = {
+        .readers = basic_array_move(&readers),
+        .retired = basic_vector_move(&retired),
+        .reader_cap = reader_cap,
+        .write_lock = ATOMIC_FLAG_INIT
+    };
+
+    atomic_init(&rcu.epoch, 1);
+    for (int i = 0; i < reader_cap; ++i) {
+        atomic_init(&reader_slot(&rcu, i)->epoch, 0);
+        atomic_init(&reader_slot(&rcu, i)->claimed, false);
+    }
+
+    *(basic_vector *)boxed.ptr = basic_vector_move(initial);
+    atomic_init(&rcu.current, boxed.ptr);
+    return rcu;
+}
+
+void basic_rcu_vector_destroy(basic_rcu_vector *rcu)
+{
+    BASIC_ASSERT_PTR_NONNULL(rcu);
+
+    if (!basic_rcu_vector_isinit(rcu)) {
+        return;
+    }
+
+    free_version(atomic_load_explicit(&rcu->current, memory_order_relaxed));
+    reclaim_before(rcu, UINT_LEAST64_MAX);
+    basic_vector_destroy(&rcu->retired);
+    basic_array_dealloc(&rcu->readers);
+    *rcu = BASIC_RCU_VECTOR_NULL;
+}
+
+int basic_rcu_vector_register(basic_rcu_vector *rcu)
+{
+    BASIC_ASSERT_PTR_NONNULL(rcu);
+    BASIC_ASSERT(basic_rcu_vector_isinit(rcu),
+            "basic_rcu_vector object must be initialised");
+
+    for (int i = 0; i < rcu->reader_cap; ++i) {
+        bool expected = false;
+        if (atomic_compare_exchange_strong_explicit(
+                    &reader_slot(rcu, i)->claimed,
+                    &expected,
+                    true,
+                    memory_order_acquire,
+                    memory_order_relaxed)) {
+            return i;
+        }
+    }
+
+    return -1;
+}
+
+void basic_rcu_vector_unregister(basic_rcu_vector *rcu, int reader)
+{
+    BASIC_ASSERT_PTR_NONNULL(rcu);
+    BASIC_ASSERT(basic_rcu_vector_isinit(rcu),
+            "basic_rcu_vector object must be initialised");
+    BASIC_ASSERT(is_registered(rcu, reader),
+            "reader %d is not registered", reader);
+    BASIC_ASSERT(!atomic_load_explicit(&reader_slot(rcu, reader)->epoch,
+                memory_order_relaxed),
+            "reader %d must leave its read section first", reader);
+
+    atomic_store_explicit(&reader_slot(rcu, reader)->claimed, false,
+            memory_order_release);
+}
+
+basic_vector const *basic_rcu_vector_read_lock(
+        basic_rcu_vector *rcu,
+        int reader)
+{
+    BASIC_ASSERT_PTR_NONNULL(rcu);
+    BASIC_ASSERT(basic_rcu_vector_isinit(rcu),
+            "basic_rcu_vector object must be initialised");
+    BASIC_ASSERT(is_registered(rcu, reader),
+            "reader %d is not registered", reader);
+
+    atomic_uint_least64_t *const slot = &reader_slot(rcu, reader)->epoch;
+    BASIC_ASSERT(!atomic_load_explicit(slot, memory_order_relaxed),
+            "read sections on reader %d must not nest", reader);
+
+    // Announce the epoch before loading the version. Both are sequentially
+    // consistent, so a writer that scans the slots after replacing the
+    // version either sees this announcement or this load sees its
+    // replacement.
+    atomic_store_explicit(slot,
+            atomic_load_explicit(&rcu->epoch, memory_order_acquire),
+            memory_order_seq_cst);
+    return atomic_load_explicit(&rcu->current, memory_order_seq_cst);
+}
+
+void basic_rcu_vector_read_unlock(basic_rcu_vector *rcu, int reader)
+{
+    BASIC_ASSERT_PTR_NONNULL(rcu);
+    BASIC_ASSERT(basic_rcu_vector_isinit(rcu),
+            "basic_rcu_vector object must be initialised");
+    BASIC_ASSERT(is_registered(rcu, reader),
+            "reader %d is not registered", reader);
+
+    atomic_store_explicit(&reader_slot(rcu, reader)->epoch, 0,
+            memory_order_release);
+}
+
+bool basic_rcu_vector_publish(basic_rcu_vector *rcu, basic_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(rcu);
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_rcu_vector_isinit(rcu),
+            "basic_rcu_vector object must be initialised");
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+
+    basic_block boxed = basic_block_alloc(sizeof(basic_vector));
+    if (basic_block_isnull(&boxed)) {
+        return false;
+    }
+
+    *(basic_vector *)boxed.ptr = basic_vector_move(vector);
+
+    lock_writers(rcu);
+
+    // Readers that announce a later epoch than the one returned here load
+    // the version only after the exchange, so they never see the old one
+    basic_vector *const old = atomic_exchange_explicit(&rcu->current,
+            boxed.ptr, memory_order_seq_cst);
+    retired_version const entry = {
+        .vector = old,
+        .epoch = atomic_fetch_add_explicit(&rcu->epoch, 1,
+                memory_order_seq_cst)
+    };
+
+    if (!basic_vector_insertback(&rcu->retired, (void *)&entry)) {
+        wait_for_readers(rcu, entry.epoch);
+        free_version(old);
+    }
+
+    reclaim_before(rcu, oldest_reader(rcu));
+    unlock_writers(rcu);
+    return true;
+}
+
+int basic_rcu_vector_reclaim(basic_rcu_vector *rcu)
+{
+    BASIC_ASSERT_PTR_NONNULL(rcu);
+    BASIC_ASSERT(basic_rcu_vector_isinit(rcu),
+            "basic_rcu_vector object must be initialised");
+
+    lock_writers(rcu);
+    int const pending = reclaim_before(rcu, oldest_reader(rcu));
+    unlock_writers(rcu);
+    return pending;
+}
+
+void basic_rcu_vector_synchronize(basic_rcu_vector *rcu)
+{
+    BASIC_ASSERT_PTR_NONNULL(rcu);
+    BASIC_ASSERT(basic_rcu_vector_isinit(rcu),
+            "basic_rcu_vector object must be initialised");
+
+    lock_writers(rcu);
+
+    // Every retired version was tagged with an earlier epoch than this
+    uint_least64_t const epoch = atomic_fetch_add_explicit(&rcu->epoch, 1,
+            memory_order_seq_cst);
+    wait_for_readers(rcu, epoch);
+    reclaim_before(rcu, UINT_LEAST64_MAX);
+
+    unlock_writers(rcu);
+}
+
+reader_slot_state *reader_slot(basic_rcu_vector *rcu, int reader)
+{
+    // The slots start at the first cache line boundary in the array, so
+    // that no two readers share a line
+    uintptr_t const base = ((uintptr_t)rcu->readers.data.ptr
+            + BASIC_CACHE_LINE_SIZE - 1)
+        & ~(uintptr_t)(BASIC_CACHE_LINE_SIZE - 1);
+    return (reader_slot_state *)(base
+            + (size_t)reader * BASIC_CACHE_LINE_SIZE);
+}
+
+#ifdef BASIC_DEBUG
+bool is_registered(basic_rcu_vector *rcu, int reader)
+{
+    return reader >= 0
+        && reader < rcu->reader_cap
+        && atomic_load_explicit(&reader_slot(rcu, reader)->claimed,
+                memory_order_relaxed);
+}
+#endif
+
+uint_least64_t oldest_reader(basic_rcu_vector *rcu)
+{
+    // Every slot is scanned whether or not it is claimed, since idle ones
+    // hold zero. Going by which slots are claimed could miss a reader that
+    // registered after the writer looked.
+    uint_least64_t oldest = UINT_LEAST64_MAX;
+
+    for (int i = 0; i < rcu->reader_cap; ++i) {
+        uint_least64_t const epoch = atomic_load_explicit(
+                &reader_slot(rcu, i)->epoch,
+                memory_order_seq_cst);
+        if (epoch && epoch < oldest) {
+            oldest = epoch;
+        }
+    }
+
+    return oldest;
+}
+
+void wait_for_readers(basic_rcu_vector *rcu, uint_least64_t epoch)
+{
+    for (int i = 0; i < rcu->reader_cap; ++i) {
+        atomic_uint_least64_t *const slot = &reader_slot(rcu, i)->epoch;
+        for (;;) {
+            uint_least64_t const seen = atomic_load_explicit(slot,
+                    memory_order_seq_cst);
+            if (!seen || seen > epoch) {
+                break;
+            }
+
+            sched_yield();
+        }
+    }
+}
+
+int reclaim_before(basic_rcu_vector *rcu, uint_least64_t epoch)
+{
+    retired_version *const entries = rcu->retired.data.data.ptr;
+    size_t kept = 0;
+
+    // A version retired at epoch e may be held by readers that announced e
+    // or earlier, so only versions retired before the oldest reader go
+    for (size_t i = 0; i < rcu->retired.elem_count; ++i) {
+        if (entries[i].epoch < epoch) {
+            free_version(entries[i].vector);
+        } else {
+            entries[kept++] = entries[i];
+        }
+    }
+
+    rcu->retired.elem_count = kept;
+    return (int)kept;
+}
+
+void free_version(basic_vector *version)
+{
+    basic_vector_destroy(version);
+
+    basic_block boxed = {.ptr = version, .size = sizeof(basic_vector)};
+    basic_block_dealloc(&boxed);
+}
+
+void lock_writers(basic_rcu_vector *rcu)
+{
+    while (atomic_flag_test_and_set_explicit(&rcu->write_lock,
+                memory_order_acquire)) {
+        sched_yield();
+    }
+}
+
+void unlock_writers(basic_rcu_vector *rcu)
+{
+    atomic_flag_clear_explicit(&rcu->write_lock, memory_order_release);
+}
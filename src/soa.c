@@ -0,0 +1,307 @@
+#include "soa.h"
+
+#include <string.h>
+
+static basic_array *soa_column(basic_soa *soa, size_t field);
+static basic_array const *soa_column_c(basic_soa const *soa, size_t field);
+static void soa_dealloc_columns(basic_soa *soa, size_t field_count);
+static bool soa_isfull(basic_soa const *soa);
+static basic_soa *soa_grow(basic_soa *soa);
+
+basic_soa basic_soa_move(basic_soa *soa)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    BASIC_ASSERT(basic_soa_isinit(soa),
+            "basic_soa object must be initialised");
+
+    basic_soa temp = *soa;
+    *soa = BASIC_SOA_NULL;
+    return temp;
+}
+
+basic_soa basic_soa_clone(basic_soa const *soa)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    BASIC_ASSERT(basic_soa_isnull(soa) || basic_soa_isinit(soa),
+            "basic_soa object must be null or initialised");
+
+    if (basic_soa_isnull(soa)) {
+        return BASIC_SOA_NULL;
+    }
+
+    basic_soa clone = {
+        .columns = basic_array_alloc(sizeof(basic_array), soa->field_count),
+        .field_count = soa->field_count,
+        .elem_count = soa->elem_count,
+        .elem_cap = soa->elem_cap,
+        .growth = soa->growth
+    };
+
+    if (basic_array_isnull(&clone.columns)) {
+        return BASIC_SOA_NULL;
+    }
+
+    for (size_t field = 0; field < soa->field_count; ++field) {
+        basic_array column = basic_array_clone(soa_column_c(soa, field));
+        if (basic_array_isnull(&column)) {
+            soa_dealloc_columns(&clone, field);
+            return BASIC_SOA_NULL;
+        }
+
+        *soa_column(&clone, field) = basic_array_move(&column);
+    }
+
+    return clone;
+}
+
+basic_soa basic_soa_new(
+        size_t const *field_sizes,
+        size_t field_count,
+        size_t initial_cap)
+{
+    BASIC_ASSERT_PTR_NONNULL(field_sizes);
+    BASIC_ASSERT_POSITIVE(field_count);
+    BASIC_ASSERT_POSITIVE(initial_cap);
+
+    // Check every size up front, so that a bad one is caught before
+    // anything is allocated
+    for (size_t field = 0; field < field_count; ++field) {
+        BASIC_ASSERT(field_sizes[field] != 0,
+                "size of field %zu must be nonzero", field);
+    }
+
+    basic_soa soa = {
+        .columns = basic_array_alloc(sizeof(basic_array), field_count),
+        .field_count = field_count,
+        .elem_count = 0,
+        .elem_cap = initial_cap,
+        .growth = BASIC_GROWTH_DOUBLE
+    };
+
+    if (basic_array_isnull(&soa.columns)) {
+        return BASIC_SOA_NULL;
+    }
+
+    for (size_t field = 0; field < field_count; ++field) {
+        basic_array column = basic_array_alloc(field_sizes[field], initial_cap);
+        if (basic_array_isnull(&column)) {
+            soa_dealloc_columns(&soa, field);
+            return BASIC_SOA_NULL;
+        }
+
+        *soa_column(&soa, field) = basic_array_move(&column);
+    }
+
+    return soa;
+}
+
+void basic_soa_destroy(basic_soa *soa)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+
+    if (basic_soa_isinit(soa)) {
+        soa_dealloc_columns(soa, soa->field_count);
+    }
+}
+
+void basic_soa_set_growth(basic_soa *soa, basic_growth_policy growth)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    BASIC_ASSERT(basic_soa_isinit(soa),
+            "basic_soa object must be initialised");
+    BASIC_ASSERT(growth.kind != basic_growth_fixed || growth.increment > 0,
+            "fixed growth increment %zu must be positive", growth.increment);
+
+    soa->growth = growth;
+}
+
+bool basic_soa_insert(
+        basic_soa *soa,
+        size_t index,
+        void const *const *fields)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    BASIC_ASSERT_PTR_NONNULL(fields);
+    BASIC_ASSERT(basic_soa_isinit(soa),
+            "basic_soa object must be initialised");
+    BASIC_ASSERT(index <= soa->elem_count,
+            "insert index %zu out of range", index);
+
+    if (soa_isfull(soa) && !soa_grow(soa)) {
+        return false;
+    }
+
+    // Every column is shifted and written at the same index, which keeps
+    // the columns in lockstep
+    for (size_t field = 0; field < soa->field_count; ++field) {
+        BASIC_ASSERT_PTR_NONNULL(fields[field]);
+
+        basic_array *const column = soa_column(soa, field);
+        size_t const elem_size = column->elem_size;
+        char *const slot = basic_array_at(column, index);
+
+        if (index != soa->elem_count) {
+            memmove(slot + elem_size,
+                    slot,
+                    (soa->elem_count - index) * elem_size);
+        }
+
+        memcpy(slot, fields[field], elem_size);
+    }
+
+    ++soa->elem_count;
+    return true;
+}
+
+void basic_soa_remove(basic_soa *soa, size_t index)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    BASIC_ASSERT(basic_soa_isinit(soa),
+            "basic_soa object must be initialised");
+    BASIC_ASSERT(index < soa->elem_count,
+            "index %zu out of range", index);
+
+    if (index != soa->elem_count - 1) {
+        for (size_t field = 0; field < soa->field_count; ++field) {
+            basic_array *const column = soa_column(soa, field);
+            size_t const elem_size = column->elem_size;
+            char *const slot = basic_array_at(column, index);
+
+            memmove(slot,
+                    slot + elem_size,
+                    (soa->elem_count - index - 1) * elem_size);
+        }
+    }
+
+    --soa->elem_count;
+}
+
+void *basic_soa_at(basic_soa *soa, size_t index, size_t field)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    BASIC_ASSERT(basic_soa_isinit(soa),
+            "basic_soa object must be initialised");
+    BASIC_ASSERT(index < soa->elem_count,
+            "index %zu out of range", index);
+    BASIC_ASSERT(field < soa->field_count,
+            "field %zu out of range", field);
+
+    return basic_array_at(soa_column(soa, field), index);
+}
+
+void const *basic_soa_at_c(
+        basic_soa const *soa,
+        size_t index,
+        size_t field)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    BASIC_ASSERT(basic_soa_isinit(soa),
+            "basic_soa object must be initialised");
+    BASIC_ASSERT(index < soa->elem_count,
+            "index %zu out of range", index);
+    BASIC_ASSERT(field < soa->field_count,
+            "field %zu out of range", field);
+
+    return basic_array_at_c(soa_column_c(soa, field), index);
+}
+
+basic_span basic_soa_get(basic_soa *soa, size_t index, size_t field)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    BASIC_ASSERT(basic_soa_isinit(soa),
+            "basic_soa object must be initialised");
+    BASIC_ASSERT(index < soa->elem_count,
+            "index %zu out of range", index);
+    BASIC_ASSERT(field < soa->field_count,
+            "field %zu out of range", field);
+
+    return basic_array_get(soa_column(soa, field), index);
+}
+
+basic_span basic_soa_column(basic_soa *soa, size_t field)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    BASIC_ASSERT(basic_soa_isinit(soa),
+            "basic_soa object must be initialised");
+    BASIC_ASSERT(field < soa->field_count,
+            "field %zu out of range", field);
+
+    if (!soa->elem_count) {
+        return BASIC_SPAN_NULL;
+    }
+
+    basic_array *const column = soa_column(soa, field);
+    return (basic_span) {
+        .ptr = column->data.ptr,
+        .size = soa->elem_count * column->elem_size
+    };
+}
+
+size_t basic_soa_field_size(basic_soa const *soa, size_t field)
+{
+    BASIC_ASSERT_PTR_NONNULL(soa);
+    BASIC_ASSERT(basic_soa_isinit(soa),
+            "basic_soa object must be initialised");
+    BASIC_ASSERT(field < soa->field_count,
+            "field %zu out of range", field);
+
+    return soa_column_c(soa, field)->elem_size;
+}
+
+basic_array *soa_column(basic_soa *soa, size_t field)
+{
+    return basic_array_at(&soa->columns, field);
+}
+
+basic_array const *soa_column_c(basic_soa const *soa, size_t field)
+{
+    return basic_array_at_c(&soa->columns, field);
+}
+
+void soa_dealloc_columns(basic_soa *soa, size_t field_count)
+{
+    for (size_t field = 0; field < field_count; ++field) {
+        basic_array_dealloc(soa_column(soa, field));
+    }
+
+    basic_array_dealloc(&soa->columns);
+    *soa = BASIC_SOA_NULL;
+}
+
+bool soa_isfull(basic_soa const *soa)
+{
+    return soa->elem_count == soa->elem_cap;
+}
+
+basic_soa *soa_grow(basic_soa *soa)
+{
+    // Sizing for the widest column keeps every column's byte size within
+    // a size_t
+    size_t widest = 0;
+    for (size_t field = 0; field < soa->field_count; ++field) {
+        size_t const elem_size = soa_column_c(soa, field)->elem_size;
+        widest = elem_size > widest ? elem_size : widest;
+    }
+
+    size_t const new_elem_cap = basic_growth_next_cap(
+            &soa->growth,
+            soa->elem_cap,
+            soa->elem_count + 1,
+            widest);
+
+    if (!new_elem_cap) {
+        return NULL;
+    }
+
+    // If a column fails to grow, the columns before it keep their larger
+    // allocation; elem_cap only advances once every column has grown, so
+    // the basic_soa remains consistent and a later grow simply retries
+    for (size_t field = 0; field < soa->field_count; ++field) {
+        if (!basic_array_realloc(soa_column(soa, field), new_elem_cap)) {
+            return NULL;
+        }
+    }
+
+    soa->elem_cap = new_elem_cap;
+    return soa;
+}
@@ -0,0 +1,153 @@
+#include "spsc_queue.h"
+
+#include <limits.h>
+#include <string.h>
+
+#include "bits.h"
+
+static void copy_in(
+        basic_spsc_queue *queue,
+        size_t pos,
+        void const *src,
+        int n);
+static void copy_out(basic_spsc_queue *queue, size_t pos, void *dest, int n);
+
+basic_spsc_queue basic_spsc_queue_new(size_t elem_size, int cap)
+{
+    BASIC_ASSERT_NONZERO(elem_size);
+    BASIC_ASSERT_POSITIVE(cap);
+
+    uint64_t const pow2 = basic_bits_ceil_pow2((uint64_t)cap);
+    if (pow2 > INT_MAX) {
+        return BASIC_SPSC_QUEUE_NULL;
+    }
+
+    int const elem_cap = (int)pow2;
+    basic_array data = basic_array_alloc(elem_size, elem_cap);
+    if (basic_array_isnull(&data)) {
+        return BASIC_SPSC_QUEUE_NULL;
+    }
+
+    basic_spsc_queue queue = BASIC_SPSC_QUEUE_NULL;
+    queue.data = basic_array_move(&data);
+    queue.elem_cap = elem_cap;
+    atomic_init(&queue.head, 0);
+    atomic_init(&queue.tail, 0);
+    return queue;
+}
+
+void basic_spsc_queue_destroy(basic_spsc_queue *queue)
+{
+    BASIC_ASSERT_PTR_NONNULL(queue);
+
+    if (basic_spsc_queue_isinit(queue)) {
+        basic_array_dealloc(&queue->data);
+        *queue = BASIC_SPSC_QUEUE_NULL;
+    }
+}
+
+int basic_spsc_queue_push_n(
+        basic_spsc_queue *queue,
+        void const *elems,
+        int n)
+{
+    BASIC_ASSERT_PTR_NONNULL(queue);
+    BASIC_ASSERT_PTR_NONNULL(elems);
+    BASIC_ASSERT(basic_spsc_queue_isinit(queue),
+            "basic_spsc_queue object must be initialised");
+    BASIC_ASSERT(n >= 0, "count %d must be non-negative", n);
+
+    size_t const cap = (size_t)queue->elem_cap;
+    size_t const tail = atomic_load_explicit(&queue->tail,
+            memory_order_relaxed);
+
+    // Only reload the consumer's counter when the cached copy says there is
+    // not enough room
+    size_t space = cap - (tail - queue->cached_head);
+    if (space < (size_t)n) {
+        queue->cached_head = atomic_load_explicit(&queue->head,
+                memory_order_acquire);
+        space = cap - (tail - queue->cached_head);
+    }
+
+    int const count = space < (size_t)n ? (int)space : n;
+    if (!count) {
+        return 0;
+    }
+
+    copy_in(queue, tail, elems, count);
+    atomic_store_explicit(&queue->tail,
+            tail + (size_t)count,
+            memory_order_release);
+    return count;
+}
+
+int basic_spsc_queue_pop_n(basic_spsc_queue *queue, void *elems, int n)
+{
+    BASIC_ASSERT_PTR_NONNULL(queue);
+    BASIC_ASSERT_PTR_NONNULL(elems);
+    BASIC_ASSERT(basic_spsc_queue_isinit(queue),
+            "basic_spsc_queue object must be initialised");
+    BASIC_ASSERT(n >= 0, "count %d must be non-negative", n);
+
+    size_t const head = atomic_load_explicit(&queue->head,
+            memory_order_relaxed);
+
+    // Only reload the producer's counter when the cached copy says there
+    // are not enough elements
+    size_t avail = queue->cached_tail - head;
+    if (avail < (size_t)n) {
+        queue->cached_tail = atomic_load_explicit(&queue->tail,
+                memory_order_acquire);
+        avail = queue->cached_tail - head;
+    }
+
+    int const count = avail < (size_t)n ? (int)avail : n;
+    if (!count) {
+        return 0;
+    }
+
+    copy_out(queue, head, elems, count);
+    atomic_store_explicit(&queue->head,
+            head + (size_t)count,
+            memory_order_release);
+    return count;
+}
+
+void copy_in(
+        basic_spsc_queue *queue,
+        size_t pos,
+        void const *src,
+        int n)
+{
+    size_t const elem_size = queue->data.elem_size;
+    int const slot = (int)(pos & (size_t)(queue->elem_cap - 1));
+    int const first = queue->elem_cap - slot < n ? queue->elem_cap - slot : n;
+
+    // At most two copies, one up to the end of the ring and one from its
+    // start
+    memcpy(basic_array_at(&queue->data, slot),
+            src,
+            (size_t)first * elem_size);
+    if (first < n) {
+        memcpy(basic_array_at(&queue->data, 0),
+                (char const *)src + (size_t)first * elem_size,
+                (size_t)(n - first) * elem_size);
+    }
+}
+
+void copy_out(basic_spsc_queue *queue, size_t pos, void *dest, int n)
+{
+    size_t const elem_size = queue->data.elem_size;
+    int const slot = (int)(pos & (size_t)(queue->elem_cap - 1));
+    int const first = queue->elem_cap - slot < n ? queue->elem_cap - slot : n;
+
+    memcpy(dest,
+            basic_array_at_c(&queue->data, slot),
+            (size_t)first * elem_size);
+    if (first < n) {
+        memcpy((char *)dest + (size_t)first * elem_size,
+                basic_array_at_c(&queue->data, 0),
+                (size_t)(n - first) * elem_size);
+    }
+}
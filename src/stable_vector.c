@@ -0,0 +1,255 @@
+#include "stable_vector.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "bits.h"
+
+enum { initial_directory_cap = 8 };
+
+static size_t chunk_cap_of(basic_stable_vector const *vector);
+static void release_chunks(basic_stable_vector *vector, size_t keep);
+static basic_array *chunk_at(basic_stable_vector *vector, size_t chunk);
+static basic_array const *chunk_at_c(
+        basic_stable_vector const *vector,
+        size_t chunk);
+
+basic_stable_vector basic_stable_vector_move(basic_stable_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_stable_vector_isinit(vector),
+            "basic_stable_vector object must be initialised");
+
+    basic_stable_vector temp = *vector;
+    *vector = BASIC_STABLE_VECTOR_NULL;
+    return temp;
+}
+
+basic_stable_vector basic_stable_vector_clone(
+        basic_stable_vector const *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_stable_vector_isnull(vector)
+            || basic_stable_vector_isinit(vector),
+            "basic_stable_vector object must be null or initialised");
+
+    if (basic_stable_vector_isnull(vector)) {
+        return BASIC_STABLE_VECTOR_NULL;
+    }
+
+    basic_stable_vector clone = basic_stable_vector_new(vector->elem_size,
+            chunk_cap_of(vector));
+    if (basic_stable_vector_isnull(&clone)) {
+        return BASIC_STABLE_VECTOR_NULL;
+    }
+
+    // Only the chunks holding elements are cloned, not the spare
+    size_t const chunk_count = basic_stable_vector_chunk_count(vector);
+    for (size_t i = 0; i < chunk_count; ++i) {
+        basic_array chunk = basic_array_clone(chunk_at_c(vector, i));
+        if (basic_array_isnull(&chunk)) {
+            basic_stable_vector_destroy(&clone);
+            return BASIC_STABLE_VECTOR_NULL;
+        }
+
+        basic_array *const slot = basic_vector_emplace_back(&clone.chunks);
+        if (!slot) {
+            basic_array_dealloc(&chunk);
+            basic_stable_vector_destroy(&clone);
+            return BASIC_STABLE_VECTOR_NULL;
+        }
+
+        *slot = basic_array_move(&chunk);
+    }
+
+    clone.elem_count = vector->elem_count;
+    return clone;
+}
+
+basic_stable_vector basic_stable_vector_new(
+        size_t elem_size,
+        size_t chunk_cap)
+{
+    BASIC_ASSERT_NONZERO(elem_size);
+    BASIC_ASSERT_POSITIVE(chunk_cap);
+
+    uint64_t const pow2 = basic_bits_ceil_pow2(chunk_cap);
+    if (!pow2 || pow2 > SIZE_MAX / elem_size) {
+        return BASIC_STABLE_VECTOR_NULL;
+    }
+
+    basic_vector chunks = basic_vector_new(sizeof(basic_array),
+            initial_directory_cap);
+    if (basic_vector_isnull(&chunks)) {
+        return BASIC_STABLE_VECTOR_NULL;
+    }
+
+    return (basic_stable_vector) {
+        .chunks = basic_vector_move(&chunks),
+        .elem_size = elem_size,
+        .chunk_shift = basic_bits_log2(pow2),
+        .elem_count = 0
+    };
+}
+
+void basic_stable_vector_destroy(basic_stable_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+
+    if (basic_stable_vector_isinit(vector)) {
+        release_chunks(vector, 0);
+        basic_vector_destroy(&vector->chunks);
+        *vector = BASIC_STABLE_VECTOR_NULL;
+    }
+}
+
+void *basic_stable_vector_emplace_back(basic_stable_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_stable_vector_isinit(vector),
+            "basic_stable_vector object must be initialised");
+
+    size_t const chunk = vector->elem_count >> vector->chunk_shift;
+    size_t const offset = vector->elem_count & (chunk_cap_of(vector) - 1);
+
+    // Growing adds a chunk to the directory. Only the directory's chunk
+    // headers are ever copied, never the elements.
+    if (chunk == vector->chunks.elem_count) {
+        basic_array new_chunk = basic_array_alloc(vector->elem_size,
+                chunk_cap_of(vector));
+        if (basic_array_isnull(&new_chunk)) {
+            return NULL;
+        }
+
+        basic_array *const slot = basic_vector_emplace_back(&vector->chunks);
+        if (!slot) {
+            basic_array_dealloc(&new_chunk);
+            return NULL;
+        }
+
+        *slot = basic_array_move(&new_chunk);
+    }
+
+    ++vector->elem_count;
+    return basic_array_at(chunk_at(vector, chunk), offset);
+}
+
+bool basic_stable_vector_pushback(
+        basic_stable_vector *vector,
+        void const *elem)
+{
+    BASIC_ASSERT_PTR_NONNULL(elem);
+
+    void *const slot = basic_stable_vector_emplace_back(vector);
+    if (!slot) {
+        return false;
+    }
+
+    memcpy(slot, elem, vector->elem_size);
+    return true;
+}
+
+void basic_stable_vector_truncate(
+        basic_stable_vector *vector,
+        size_t elem_count)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_stable_vector_isinit(vector),
+            "basic_stable_vector object must be initialised");
+    BASIC_ASSERT(elem_count <= vector->elem_count,
+            "count %zu out of range",
+            elem_count);
+
+    vector->elem_count = elem_count;
+    release_chunks(vector, basic_stable_vector_chunk_count(vector) + 1);
+}
+
+bool basic_stable_vector_shrink_to_fit(basic_stable_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_stable_vector_isinit(vector),
+            "basic_stable_vector object must be initialised");
+
+    release_chunks(vector, basic_stable_vector_chunk_count(vector));
+    return basic_vector_shrink_to_fit(&vector->chunks);
+}
+
+void *basic_stable_vector_at(basic_stable_vector *vector, size_t index)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_stable_vector_isinit(vector),
+            "basic_stable_vector object must be initialised");
+    BASIC_ASSERT(index < vector->elem_count,
+            "index %zu out of range",
+            index);
+
+    return basic_array_at(chunk_at(vector, index >> vector->chunk_shift),
+            index & (chunk_cap_of(vector) - 1));
+}
+
+void const *basic_stable_vector_at_c(
+        basic_stable_vector const *vector,
+        size_t index)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_stable_vector_isinit(vector),
+            "basic_stable_vector object must be initialised");
+    BASIC_ASSERT(index < vector->elem_count,
+            "index %zu out of range",
+            index);
+
+    return basic_array_at_c(chunk_at_c(vector, index >> vector->chunk_shift),
+            index & (chunk_cap_of(vector) - 1));
+}
+
+basic_span basic_stable_vector_chunk(
+        basic_stable_vector *vector,
+        size_t chunk)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_stable_vector_isinit(vector),
+            "basic_stable_vector object must be initialised");
+    BASIC_ASSERT(chunk < basic_stable_vector_chunk_count(vector),
+            "chunk %zu out of range",
+            chunk);
+
+    size_t const chunk_cap = chunk_cap_of(vector);
+    size_t const remaining = vector->elem_count - chunk * chunk_cap;
+
+    return (basic_span) {
+        .ptr = basic_array_at(chunk_at(vector, chunk), 0),
+        .size = (remaining < chunk_cap ? remaining : chunk_cap)
+            * vector->elem_size
+    };
+}
+
+size_t chunk_cap_of(basic_stable_vector const *vector)
+{
+    return (size_t)1 << vector->chunk_shift;
+}
+
+void release_chunks(basic_stable_vector *vector, size_t keep)
+{
+    size_t const chunk_count = vector->chunks.elem_count;
+    if (keep >= chunk_count) {
+        return;
+    }
+
+    for (size_t i = keep; i < chunk_count; ++i) {
+        basic_array_dealloc(chunk_at(vector, i));
+    }
+
+    basic_vector_remove_range(&vector->chunks, keep, chunk_count - keep);
+}
+
+basic_array *chunk_at(basic_stable_vector *vector, size_t chunk)
+{
+    return basic_vector_at(&vector->chunks, chunk);
+}
+
+basic_array const *chunk_at_c(
+        basic_stable_vector const *vector,
+        size_t chunk)
+{
+    return basic_vector_at_c(&vector->chunks, chunk);
+}
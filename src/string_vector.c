@@ -1,36 +1,78 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include "string_vector.h"
 
+#include <fcntl.h>
+#include <stdint.h>
 #include <string.h>
-
-enum {
-    grow_factor = 2
-};
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "bits.h"
+#include "block.h"
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+#elif defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+enum { scan_width = 64, insertion_sort_limit = 16 };
+
+// A string being sorted, by where it is, how many chunks it occupies and
+// the eight bytes from the current sort depth, most significant first and
+// zero past the end of the string
+typedef struct {
+    unsigned char const *string;
+    size_t chunks;
+    uint64_t prefix;
+} sort_key;
 
 static bool string_vector_grow(
         basic_string_vector *string_vector,
-        int n_chunks);
+        size_t n_chunks);
 
-static int chunks_required_for(
+static size_t chunks_required_for(
         basic_string_vector const *string_vector,
         char const *string);
 
-static bool chunk_is_terminal(
+static size_t string_index_to_chunk_index(
         basic_string_vector const *string_vector,
-        int chunk_index);
+        size_t string_index);
 
-static int string_index_to_chunk_index(
-        basic_string_vector const *string_vector,
-        int string_index);
+static void offset_strings_from(
+        basic_string_vector *string_vector,
+        size_t string_index,
+        size_t add,
+        size_t subtract);
 
 static void shift_chunks_left(
         basic_string_vector *string_vector,
-        int chunk_index,
-        int shift_by);
+        size_t chunk_index,
+        size_t shift_by);
 
 static void shift_chunks_right(
         basic_string_vector *string_vector,
-        int chunk_index,
-        int shift_by);
+        size_t chunk_index,
+        size_t shift_by);
+
+static uint64_t delim_mask(char const *block, char delim);
+static size_t count_delims(char const *data, size_t size, char delim);
+static void find_delims(
+        char const *data,
+        size_t size,
+        char delim,
+        size_t *ends);
+
+static bool read_file(int fd, basic_block *contents, size_t *size);
+
+static void multikey_sort(sort_key *keys, size_t count, size_t depth);
+static void insertion_sort(sort_key *keys, size_t count, size_t depth);
+static int compare_keys(sort_key const *a, sort_key const *b, size_t depth);
+static void load_prefixes(sort_key *keys, size_t count, size_t depth);
+static size_t median_of_three(sort_key const *keys, size_t count);
+static void swap_keys(sort_key *keys, size_t i, size_t j);
 
 basic_string_vector basic_string_vector_move(
         basic_string_vector *string_vector)
@@ -57,30 +99,45 @@ basic_string_vector basic_string_vector_clone(
     }
 
     basic_array chunk_data = basic_array_clone(&string_vector->chunk_data);
-    if (basic_array_isnull(&chunk_data)) {
+    basic_vector string_offsets =
+        basic_vector_clone(&string_vector->string_offsets);
+    if (basic_array_isnull(&chunk_data)
+            || basic_vector_isnull(&string_offsets)) {
+        basic_array_dealloc(&chunk_data);
+        basic_vector_destroy(&string_offsets);
         return BASIC_STRING_VECTOR_NULL;
     }
 
     return (basic_string_vector) {
         .chunk_data = basic_array_move(&chunk_data),
+        .string_offsets = basic_vector_move(&string_offsets),
         .chunk_count = string_vector->chunk_count,
-        .string_count = string_vector->string_count
+        .string_count = string_vector->string_count,
+        .growth = string_vector->growth
     };
 }
 
-basic_string_vector basic_string_vector_new(size_t chunk_size, int chunk_cap)
+basic_string_vector basic_string_vector_new(size_t chunk_size, size_t chunk_cap)
 {
     BASIC_ASSERT_NONZERO(chunk_size);
 
+    // No string takes up less than a chunk, so there are never more offsets
+    // than chunks
     basic_array chunk_data = basic_array_alloc(chunk_size, chunk_cap);
-    if (basic_array_isnull(&chunk_data)) {
+    basic_vector string_offsets = basic_vector_new(sizeof(size_t), chunk_cap);
+    if (basic_array_isnull(&chunk_data)
+            || basic_vector_isnull(&string_offsets)) {
+        basic_array_dealloc(&chunk_data);
+        basic_vector_destroy(&string_offsets);
         return BASIC_STRING_VECTOR_NULL;
     }
 
     return (basic_string_vector) {
         .chunk_data = basic_array_move(&chunk_data),
+        .string_offsets = basic_vector_move(&string_offsets),
         .chunk_count = 0,
-        .string_count = 0
+        .string_count = 0,
+        .growth = BASIC_GROWTH_DOUBLE
     };
 }
 
@@ -93,25 +150,207 @@ void basic_string_vector_destroy(basic_string_vector *string_vector)
     
     if (basic_string_vector_isinit(string_vector)) {
         basic_array_dealloc(&string_vector->chunk_data);
+        basic_vector_destroy(&string_vector->string_offsets);
         *string_vector = BASIC_STRING_VECTOR_NULL;
     }
 }
 
+void basic_string_vector_set_growth(
+        basic_string_vector *string_vector,
+        basic_growth_policy growth)
+{
+    BASIC_ASSERT_PTR_NONNULL(string_vector);
+    BASIC_ASSERT(basic_string_vector_isinit(string_vector),
+            "basic_string_vector object must be initialised");
+    BASIC_ASSERT(growth.kind != basic_growth_fixed || growth.increment > 0,
+            "fixed growth increment %zu must be positive", growth.increment);
+
+    string_vector->growth = growth;
+}
+
+bool basic_string_vector_reserve(
+        basic_string_vector *string_vector,
+        size_t chunk_cap,
+        size_t string_cap)
+{
+    BASIC_ASSERT_PTR_NONNULL(string_vector);
+    BASIC_ASSERT(basic_string_vector_isinit(string_vector),
+            "basic_string_vector object must be initialised");
+
+    // If the chunks fail to grow the offsets keep their larger capacity,
+    // which leaves the strings unchanged
+    if (!basic_vector_reserve(&string_vector->string_offsets, string_cap)) {
+        return false;
+    }
+
+    if (chunk_cap <= basic_array_cap(&string_vector->chunk_data)) {
+        return true;
+    }
+
+    return basic_array_realloc(&string_vector->chunk_data, chunk_cap);
+}
+
+bool basic_string_vector_shrink_to_fit(basic_string_vector *string_vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(string_vector);
+    BASIC_ASSERT(basic_string_vector_isinit(string_vector),
+            "basic_string_vector object must be initialised");
+
+    size_t const chunk_cap = string_vector->chunk_count
+        ? string_vector->chunk_count
+        : 1;
+
+    if (!basic_vector_shrink_to_fit(&string_vector->string_offsets)) {
+        return false;
+    }
+
+    if (chunk_cap == basic_array_cap(&string_vector->chunk_data)) {
+        return true;
+    }
+
+    return basic_array_realloc(&string_vector->chunk_data, chunk_cap);
+}
+
+basic_string_vector basic_string_vector_from_buffer(
+        basic_span const *buffer,
+        char delim,
+        size_t chunk_size)
+{
+    BASIC_ASSERT_PTR_NONNULL(buffer);
+    BASIC_ASSERT(buffer->ptr || !buffer->size,
+            "a non-empty buffer must have data");
+    BASIC_ASSERT_NONZERO(chunk_size);
+
+    char const *const data = buffer->ptr;
+    size_t const size = buffer->size;
+
+    // First find where every string ends, keeping the positions in what
+    // will become the offset index
+    size_t const string_count = count_delims(data, size, delim)
+        + (size && data[size - 1] != delim);
+    basic_vector string_offsets = basic_vector_new(sizeof(size_t),
+            string_count ? string_count : 1);
+    if (basic_vector_isnull(&string_offsets)) {
+        return BASIC_STRING_VECTOR_NULL;
+    }
+
+    size_t *const offsets = string_offsets.data.data.ptr;
+    find_delims(data, size, delim, offsets);
+    if (string_count && data[size - 1] != delim) {
+        offsets[string_count - 1] = size;
+    }
+
+    // Then size the chunks exactly
+    size_t chunk_count = 0;
+    for (size_t i = 0, start = 0; i < string_count; start = offsets[i++] + 1) {
+        size_t const chunks = (offsets[i] - start) / chunk_size + 1;
+        if (chunks > SIZE_MAX - chunk_count) {
+            basic_vector_destroy(&string_offsets);
+            return BASIC_STRING_VECTOR_NULL;
+        }
+
+        chunk_count += chunks;
+    }
+
+    basic_array chunk_data = basic_array_alloc(chunk_size,
+            chunk_count ? chunk_count : 1);
+    if (basic_array_isnull(&chunk_data)) {
+        basic_vector_destroy(&string_offsets);
+        return BASIC_STRING_VECTOR_NULL;
+    }
+
+    // And copy each string into place, turning its end position into the
+    // index of its first chunk
+    char *const chunks = chunk_data.data.ptr;
+    size_t chunk_index = 0;
+    for (size_t i = 0, start = 0; i < string_count; ++i) {
+        size_t const end = offsets[i];
+        size_t const len = end - start;
+        char *const dest = chunks + chunk_index * chunk_size;
+
+        memcpy(dest, data + start, len);
+        dest[len] = '\0';
+
+        offsets[i] = chunk_index;
+        chunk_index += len / chunk_size + 1;
+        start = end + 1;
+    }
+
+    string_offsets.elem_count = string_count;
+    return (basic_string_vector) {
+        .chunk_data = basic_array_move(&chunk_data),
+        .string_offsets = basic_vector_move(&string_offsets),
+        .chunk_count = chunk_count,
+        .string_count = string_count,
+        .growth = BASIC_GROWTH_DOUBLE
+    };
+}
+
+basic_string_vector basic_string_vector_from_file(
+        char const *path,
+        char delim,
+        size_t chunk_size,
+        bool map_file)
+{
+    BASIC_ASSERT_PTR_NONNULL(path);
+    BASIC_ASSERT_NONZERO(chunk_size);
+
+    int const fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return BASIC_STRING_VECTOR_NULL;
+    }
+
+    basic_string_vector string_vector = BASIC_STRING_VECTOR_NULL;
+    void *map = MAP_FAILED;
+    size_t size = 0;
+
+    // Empty files and files that cannot be mapped are read instead
+    struct stat st;
+    if (map_file && !fstat(fd, &st) && st.st_size > 0
+            && (uintmax_t)st.st_size <= SIZE_MAX) {
+        size = (size_t)st.st_size;
+        map = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+
+    if (map != MAP_FAILED) {
+        posix_madvise(map, size, POSIX_MADV_SEQUENTIAL);
+
+        basic_span const buffer = {map, size};
+        string_vector = basic_string_vector_from_buffer(&buffer,
+                delim,
+                chunk_size);
+        munmap(map, size);
+    } else {
+        basic_block contents = BASIC_BLOCK_NULL;
+        if (read_file(fd, &contents, &size)) {
+            basic_span const buffer = {contents.ptr, size};
+            string_vector = basic_string_vector_from_buffer(&buffer,
+                    delim,
+                    chunk_size);
+        }
+
+        basic_block_dealloc(&contents);
+    }
+
+    close(fd);
+    return string_vector;
+}
+
 bool basic_string_vector_insert(
         basic_string_vector *string_vector,
-        int index,
+        size_t index,
         char const *string)
 {
     BASIC_ASSERT_PTR_NONNULL(string_vector);
     BASIC_ASSERT(basic_string_vector_isinit(string_vector),
             "basic_string_vector object must be initialised");
-    BASIC_ASSERT(index >= 0 && index <= string_vector->string_count,
-            "index %d out of range", index);
+    BASIC_ASSERT(index <= string_vector->string_count,
+            "index %zu out of range", index);
     BASIC_ASSERT_PTR_NONNULL(string);
 
     // Determine how many blocks we need and how many we have available
-    int const string_chunks = chunks_required_for(string_vector, string);
-    int const chunks_required = string_chunks + string_vector->chunk_count;
+    size_t const string_chunks = chunks_required_for(string_vector, string);
+    size_t const chunks_required = string_chunks + string_vector->chunk_count;
 
     // Grow the string_vector if needed
     if (basic_array_cap(&string_vector->chunk_data) < chunks_required) {
@@ -122,158 +361,529 @@ bool basic_string_vector_insert(
 
     BASIC_ASSERT(basic_array_cap(&string_vector->chunk_data)
             >= chunks_required,
-            "Insufficient chunks (%d), need %d",
+            "Insufficient chunks (%zu), need %zu",
             basic_array_cap(&string_vector->chunk_data),
             chunks_required);
 
-    if (index == string_vector->string_count) {
-        // At this point we definitely have enough space to write the string.
-        // If the index is at the end of the string_vector (ie. index ==
-        // string_vector->string_count) then we do not need to shift blocks.
-        strcpy(basic_array_at(&string_vector->chunk_data,
-                    string_vector->chunk_count),
-                string);
-    } else {
-        // Otherwise, we need to shift some chunks rightward `string_chunks` units
-        int const chunk_index = string_index_to_chunk_index(string_vector, index);
-        shift_chunks_right(string_vector, chunk_index, string_chunks);
+    // Record where the new string starts. This is the last allocation, so
+    // nothing needs undoing if it fails.
+    size_t chunk_index = string_index_to_chunk_index(string_vector, index);
+    if (!basic_vector_insert(&string_vector->string_offsets,
+                index,
+                &chunk_index)) {
+        return false;
+    }
 
-        // At which point we can write the string in
-        strcpy(basic_array_at(&string_vector->chunk_data, chunk_index),
-                string);
+    if (index != string_vector->string_count) {
+        // If the index is not at the end of the string_vector, we need to
+        // shift the later strings rightward `string_chunks` units
+        shift_chunks_right(string_vector, chunk_index, string_chunks);
+        offset_strings_from(string_vector, index + 1, string_chunks, 0);
     }
 
+    strcpy(basic_array_at(&string_vector->chunk_data, chunk_index), string);
     ++string_vector->string_count;
     string_vector->chunk_count += string_chunks;
     return true;
 }
 
+bool basic_string_vector_insert_many(
+        basic_string_vector *string_vector,
+        size_t index,
+        char const *const *strings,
+        size_t count)
+{
+    BASIC_ASSERT_PTR_NONNULL(string_vector);
+    BASIC_ASSERT(basic_string_vector_isinit(string_vector),
+            "basic_string_vector object must be initialised");
+    BASIC_ASSERT(index <= string_vector->string_count,
+            "index %zu out of range", index);
+    BASIC_ASSERT(strings || !count, "strings must be non-NULL");
+
+    if (!count) {
+        return true;
+    }
+
+    size_t chunk_index = string_index_to_chunk_index(string_vector, index);
+
+    // Open a gap in the offset index, in which each new string's size is
+    // kept until its chunks are placed, so that it is measured only once
+    basic_vector *const string_offsets = &string_vector->string_offsets;
+    if (!basic_vector_emplace_back_n(string_offsets, count).ptr) {
+        return false;
+    }
+
+    size_t *const offsets = string_offsets->data.data.ptr;
+    memmove(offsets + index + count,
+            offsets + index,
+            (string_vector->string_count - index) * sizeof(size_t));
+
+    size_t const chunk_size = string_vector->chunk_data.elem_size;
+    size_t string_chunks = 0;
+    for (size_t i = 0; i < count; ++i) {
+        BASIC_ASSERT_PTR_NONNULL(strings[i]);
+        size_t const size = strlen(strings[i]) + 1;
+        size_t const chunks = size / chunk_size + (size % chunk_size != 0);
+
+        if (chunks > SIZE_MAX - string_vector->chunk_count - string_chunks) {
+            basic_vector_remove_range(string_offsets, index, count);
+            return false;
+        }
+
+        offsets[index + i] = size;
+        string_chunks += chunks;
+    }
+
+    size_t const chunks_required = string_vector->chunk_count + string_chunks;
+    if (basic_array_cap(&string_vector->chunk_data) < chunks_required
+            && !string_vector_grow(string_vector, chunks_required)) {
+        basic_vector_remove_range(string_offsets, index, count);
+        return false;
+    }
+
+    // Make room for all the strings with one shift of the chunks after them
+    if (index != string_vector->string_count) {
+        shift_chunks_right(string_vector, chunk_index, string_chunks);
+        offset_strings_from(string_vector, index + count, string_chunks, 0);
+    }
+
+    char *const chunks = string_vector->chunk_data.data.ptr;
+    for (size_t i = 0; i < count; ++i) {
+        size_t const size = offsets[index + i];
+        memcpy(chunks + chunk_index * chunk_size, strings[i], size);
+
+        offsets[index + i] = chunk_index;
+        chunk_index += size / chunk_size + (size % chunk_size != 0);
+    }
+
+    string_vector->string_count += count;
+    string_vector->chunk_count = chunks_required;
+    return true;
+}
+
 void basic_string_vector_remove(
         basic_string_vector *string_vector,
-        int index)
+        size_t index)
 {
     BASIC_ASSERT_PTR_NONNULL(string_vector);
     BASIC_ASSERT(basic_string_vector_isinit(string_vector) &&
             !basic_string_vector_isempty(string_vector),
             "basic_string_vector object must be initialised and "
             "non-empty");
-    BASIC_ASSERT(index >= 0 && index < string_vector->string_count,
-            "index %d out of range", index);
+    BASIC_ASSERT(index < string_vector->string_count,
+            "index %zu out of range", index);
 
-    int const chunk_index = string_index_to_chunk_index(
+    size_t const chunk_index = string_index_to_chunk_index(
             string_vector,
             index + 1);
-    int const chunks_occupied = chunks_required_for(
-            string_vector,
-            basic_string_vector_at(string_vector, index));
+    size_t const chunks_occupied = chunk_index
+        - string_index_to_chunk_index(string_vector, index);
 
     shift_chunks_left(string_vector, chunk_index, chunks_occupied);
+    basic_vector_remove(&string_vector->string_offsets, index);
+    offset_strings_from(string_vector, index, 0, chunks_occupied);
     --string_vector->string_count;
     string_vector->chunk_count -= chunks_occupied;
 }
 
 char const *basic_string_vector_at(
         basic_string_vector const *string_vector,
-        int index)
+        size_t index)
 {
     BASIC_ASSERT_PTR_NONNULL(string_vector);
-    BASIC_ASSERT(index >= 0 && index < string_vector->string_count,
-            "index %d out of range", index);
+    BASIC_ASSERT(index < string_vector->string_count,
+            "index %zu out of range", index);
 
     return basic_array_at_c(&string_vector->chunk_data,
             string_index_to_chunk_index(string_vector, index));
 }
 
-bool string_vector_grow(
-        basic_string_vector *string_vector,
-        int n_chunks)
+bool basic_string_vector_sort(basic_string_vector *string_vector)
 {
-    int chunks_total = basic_array_cap(&string_vector->chunk_data);
+    BASIC_ASSERT_PTR_NONNULL(string_vector);
+    BASIC_ASSERT(basic_string_vector_isinit(string_vector),
+            "basic_string_vector object must be initialised");
+
+    size_t const string_count = string_vector->string_count;
+    if (string_count < 2) {
+        return true;
+    }
+
+    if (string_count > SIZE_MAX / sizeof(sort_key)) {
+        return false;
+    }
+
+    basic_block key_block = basic_block_alloc(string_count * sizeof(sort_key));
+    if (basic_block_isnull(&key_block)) {
+        return false;
+    }
+
+    basic_array chunk_data = basic_array_alloc(
+            string_vector->chunk_data.elem_size,
+            basic_array_cap(&string_vector->chunk_data));
+    if (basic_array_isnull(&chunk_data)) {
+        basic_block_dealloc(&key_block);
+        return false;
+    }
+
+    size_t const chunk_size = string_vector->chunk_data.elem_size;
+    unsigned char const *const chunks = string_vector->chunk_data.data.ptr;
+    size_t *const offsets = string_vector->string_offsets.data.data.ptr;
+    sort_key *const keys = key_block.ptr;
+
+    for (size_t i = 0; i < string_count; ++i) {
+        keys[i] = (sort_key){
+            .string = chunks + offsets[i] * chunk_size,
+            .chunks = string_index_to_chunk_index(string_vector, i + 1)
+                - offsets[i]
+        };
+    }
 
-    while (chunks_total < n_chunks) {
-        chunks_total *= grow_factor;
+    load_prefixes(keys, string_count, 0);
+    multikey_sort(keys, string_count, 0);
+
+    // Lay the strings out again in their new order, whole chunks at a time
+    unsigned char *const sorted = chunk_data.data.ptr;
+    for (size_t i = 0, chunk_index = 0; i < string_count; ++i) {
+        memcpy(sorted + chunk_index * chunk_size,
+                keys[i].string,
+                keys[i].chunks * chunk_size);
+        offsets[i] = chunk_index;
+        chunk_index += keys[i].chunks;
     }
 
-    return basic_array_realloc(&string_vector->chunk_data, chunks_total);
+    basic_block_dealloc(&key_block);
+    basic_array_dealloc(&string_vector->chunk_data);
+    string_vector->chunk_data = basic_array_move(&chunk_data);
+    return true;
 }
 
-int chunks_required_for(
+size_t basic_string_vector_lower_bound(
         basic_string_vector const *string_vector,
         char const *string)
 {
-    size_t const size = strlen(string) + 1;
-    return (size / string_vector->chunk_data.elem_size)
-        + (size % string_vector->chunk_data.elem_size != 0);
+    BASIC_ASSERT_PTR_NONNULL(string_vector);
+    BASIC_ASSERT(basic_string_vector_isinit(string_vector),
+            "basic_string_vector object must be initialised");
+    BASIC_ASSERT_PTR_NONNULL(string);
+
+    size_t first = 0;
+    size_t count = string_vector->string_count;
+    while (count) {
+        size_t const half = count / 2;
+        if (strcmp(basic_string_vector_at(string_vector, first + half),
+                    string) < 0) {
+            first += half + 1;
+            count -= half + 1;
+        } else {
+            count = half;
+        }
+    }
+
+    return first;
 }
 
-bool chunk_is_terminal(
+bool string_vector_grow(
+        basic_string_vector *string_vector,
+        size_t n_chunks)
+{
+    size_t const chunks_total = basic_growth_next_cap(
+            &string_vector->growth,
+            basic_array_cap(&string_vector->chunk_data),
+            n_chunks,
+            string_vector->chunk_data.elem_size);
+
+    return chunks_total
+        && basic_array_realloc(&string_vector->chunk_data, chunks_total);
+}
+
+size_t chunks_required_for(
         basic_string_vector const *string_vector,
-        int chunk_index)
+        char const *string)
 {
-    char const *const chunk_begin = basic_array_at_c(&string_vector->chunk_data,
-            chunk_index);
-    return !chunk_begin[string_vector->chunk_data.elem_size - 1];
+    size_t const size = strlen(string) + 1;
+    return (size / string_vector->chunk_data.elem_size)
+        + (size % string_vector->chunk_data.elem_size != 0);
 }
 
-int string_index_to_chunk_index(
+size_t string_index_to_chunk_index(
         basic_string_vector const *string_vector,
-        int string_index)
+        size_t string_index)
 {
-    // If the string index is zero, then so is the chunk index
-    if (string_index == 0) {
-        return 0;
+    // One past the last string is where the next one would start
+    if (string_index == string_vector->string_count) {
+        return string_vector->chunk_count;
     }
 
-    // If the string_vector has equal number of chunks and strings,
-    // then the string->chunk index transform is a bijection
-    if (string_vector->string_count == string_vector->chunk_count) {
-        return string_index;
-    }
+    size_t const *const offsets = string_vector->string_offsets.data.data.ptr;
+    return offsets[string_index];
+}
 
-    // Otherwise, the index transform requires a linear search
-    // (linear in the number of chunks)
-    int chunk_index = 0;
-    for (; chunk_index < string_vector->chunk_count; ++chunk_index) {
-        if (!string_index) {
-            break;
-        }
+void offset_strings_from(
+        basic_string_vector *string_vector,
+        size_t string_index,
+        size_t add,
+        size_t subtract)
+{
+    size_t *const offsets = string_vector->string_offsets.data.data.ptr;
+    size_t const offset_count = string_vector->string_offsets.elem_count;
 
-        if (chunk_is_terminal(string_vector, chunk_index)) {
-            --string_index;
-        }
+    for (size_t i = string_index; i < offset_count; ++i) {
+        offsets[i] = offsets[i] + add - subtract;
     }
-
-    return chunk_index;
 }
 
 void shift_chunks_left(
         basic_string_vector *string_vector,
-        int chunk_index,
-        int shift_by)
+        size_t chunk_index,
+        size_t shift_by)
 {
+    // Nothing follows the last string, and its end may be the end of the
+    // array, which basic_array_at would reject
+    if (chunk_index == string_vector->chunk_count) {
+        return;
+    }
+
     void *const dest = basic_array_at(&string_vector->chunk_data,
             chunk_index - shift_by);
     void const *const src = basic_array_at(&string_vector->chunk_data,
             chunk_index);
-    size_t const n = (basic_array_cap(&string_vector->chunk_data) - chunk_index)
+    size_t const n = (string_vector->chunk_count - chunk_index)
             * string_vector->chunk_data.elem_size;
 
     memmove(dest, src, n);
-    memset(basic_array_at(&string_vector->chunk_data,
-                basic_array_cap(&string_vector->chunk_data) - shift_by),
-            0,
-            shift_by * string_vector->chunk_data.elem_size);
 }
 
 void shift_chunks_right(
         basic_string_vector *string_vector,
-        int chunk_index,
-        int shift_by)
+        size_t chunk_index,
+        size_t shift_by)
 {
     void *const dest = basic_array_at(&string_vector->chunk_data,
             chunk_index + shift_by);
     void const *const src = basic_array_at(&string_vector->chunk_data,
             chunk_index);
-    size_t const n = basic_array_cap(&string_vector->chunk_data) - chunk_index;
+    size_t const n = (string_vector->chunk_count - chunk_index)
+            * string_vector->chunk_data.elem_size;
+
     memmove(dest, src, n);
 }
+
+uint64_t delim_mask(char const *block, char delim)
+{
+    // Bit i of the result is set if block[i] is a delimiter
+#if defined(__AVX2__)
+    __m256i const needle = _mm256_set1_epi8(delim);
+    uint32_t const lo = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256((__m256i const *)block), needle));
+    uint32_t const hi = (uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(
+                _mm256_loadu_si256((__m256i const *)(block + 32)), needle));
+    return (uint64_t)hi << 32 | lo;
+#elif defined(__SSE2__)
+    __m128i const needle = _mm_set1_epi8(delim);
+    uint64_t mask = 0;
+    for (int i = 0; i < scan_width; i += 16) {
+        uint64_t const match = (uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(
+                    _mm_loadu_si128((__m128i const *)(block + i)), needle));
+        mask |= match << i;
+    }
+
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (int i = 0; i < scan_width; ++i) {
+        mask |= (uint64_t)(block[i] == delim) << i;
+    }
+
+    return mask;
+#endif
+}
+
+size_t count_delims(char const *data, size_t size, char delim)
+{
+    size_t count = 0;
+    size_t i = 0;
+
+    for (; i + scan_width <= size; i += scan_width) {
+        count += (size_t)basic_bits_popcount(delim_mask(data + i, delim));
+    }
+
+    for (; i < size; ++i) {
+        count += data[i] == delim;
+    }
+
+    return count;
+}
+
+void find_delims(char const *data, size_t size, char delim, size_t *ends)
+{
+    size_t i = 0;
+
+    for (; i + scan_width <= size; i += scan_width) {
+        for (uint64_t mask = delim_mask(data + i, delim);
+                mask;
+                mask &= mask - 1) {
+            *ends++ = i + (size_t)basic_bits_ctz(mask);
+        }
+    }
+
+    for (; i < size; ++i) {
+        if (data[i] == delim) {
+            *ends++ = i;
+        }
+    }
+}
+
+bool read_file(int fd, basic_block *contents, size_t *size)
+{
+    // Read into a doubling block, since the size of e.g. a pipe is not
+    // known up front
+    *size = 0;
+    *contents = basic_block_alloc(1 << 16);
+    if (basic_block_isnull(contents)) {
+        return false;
+    }
+
+    for (;;) {
+        if (*size == contents->size
+                && (contents->size > SIZE_MAX / 2
+                    || !basic_block_realloc(contents, 2 * contents->size))) {
+            return false;
+        }
+
+        ssize_t const n = read(fd,
+                (char *)contents->ptr + *size,
+                contents->size - *size);
+        if (n < 0) {
+            return false;
+        }
+
+        if (!n) {
+            return true;
+        }
+
+        *size += (size_t)n;
+    }
+}
+
+void multikey_sort(sort_key *keys, size_t count, size_t depth)
+{
+    // Every key here shares its first depth bytes, and holds the next eight
+    // as its prefix. Each pass splits the keys three ways on the prefix, so
+    // partitioning never touches the strings themselves; only the keys whose
+    // prefixes are equal go on to the next eight bytes. The two smaller parts
+    // are sorted by recursion and the largest by the next pass, so the stack
+    // stays logarithmic in the key count.
+    while (count > insertion_sort_limit) {
+        swap_keys(keys, 0, median_of_three(keys, count));
+        uint64_t const pivot = keys[0].prefix;
+
+        size_t less = 0;
+        size_t greater = count;
+        for (size_t i = 1; i < greater;) {
+            uint64_t const prefix = keys[i].prefix;
+            if (prefix < pivot) {
+                swap_keys(keys, less++, i++);
+            } else if (prefix > pivot) {
+                swap_keys(keys, i, --greater);
+            } else {
+                ++i;
+            }
+        }
+
+        // Strings that end within an equal prefix are equal and done with
+        size_t const equal = pivot & 0xff ? greater - less : 0;
+        size_t const above = count - greater;
+        if (equal) {
+            load_prefixes(keys + less, equal, depth + sizeof(pivot));
+        }
+
+        if (less >= equal && less >= above) {
+            multikey_sort(keys + less, equal, depth + sizeof(pivot));
+            multikey_sort(keys + greater, above, depth);
+            count = less;
+        } else if (equal >= above) {
+            multikey_sort(keys, less, depth);
+            multikey_sort(keys + greater, above, depth);
+            keys += less;
+            count = equal;
+            depth += sizeof(pivot);
+        } else {
+            multikey_sort(keys, less, depth);
+            multikey_sort(keys + less, equal, depth + sizeof(pivot));
+            keys += greater;
+            count = above;
+        }
+    }
+
+    insertion_sort(keys, count, depth);
+}
+
+void insertion_sort(sort_key *keys, size_t count, size_t depth)
+{
+    for (size_t i = 1; i < count; ++i) {
+        sort_key const key = keys[i];
+
+        size_t j = i;
+        for (; j && compare_keys(&keys[j - 1], &key, depth) > 0; --j) {
+            keys[j] = keys[j - 1];
+        }
+
+        keys[j] = key;
+    }
+}
+
+int compare_keys(sort_key const *a, sort_key const *b, size_t depth)
+{
+    if (a->prefix != b->prefix) {
+        return a->prefix < b->prefix ? -1 : 1;
+    }
+
+    if (!(a->prefix & 0xff)) {
+        return 0;
+    }
+
+    size_t const skip = depth + sizeof(a->prefix);
+    return strcmp((char const *)a->string + skip,
+            (char const *)b->string + skip);
+}
+
+void load_prefixes(sort_key *keys, size_t count, size_t depth)
+{
+    // Only strings at least depth bytes long get here, so reading up to the
+    // terminator stays within each one
+    for (size_t i = 0; i < count; ++i) {
+        unsigned char const *const string = keys[i].string + depth;
+        uint64_t prefix = 0;
+        bool ended = false;
+
+        for (size_t j = 0; j < sizeof(prefix); ++j) {
+            ended = ended || !string[j];
+            prefix = prefix << 8 | (ended ? 0 : string[j]);
+        }
+
+        keys[i].prefix = prefix;
+    }
+}
+
+size_t median_of_three(sort_key const *keys, size_t count)
+{
+    size_t const mid = count / 2;
+    size_t const last = count - 1;
+    uint64_t const a = keys[0].prefix;
+    uint64_t const b = keys[mid].prefix;
+    uint64_t const c = keys[last].prefix;
+
+    if (a < b) {
+        return b < c ? mid : a < c ? last : 0;
+    }
+
+    return a < c ? 0 : b < c ? last : mid;
+}
+
+void swap_keys(sort_key *keys, size_t i, size_t j)
+{
+    sort_key const key = keys[i];
+    keys[i] = keys[j];
+    keys[j] = key;
+}
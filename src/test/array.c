@@ -2,6 +2,7 @@
 #include <stddef.h>
 #include <setjmp.h>
 #include <cmocka.h>
+#include <stdint.h>
 #include <string.h>
 
 #include "array.h"
@@ -125,11 +126,14 @@ static void test_array_alloc(void **state)
 {
     (void) state;
 
-    // Passing 0 as the elem_size parameter or a
-    // non-positive elem_count parameter should assert
+    // Passing 0 as the elem_size or elem_count parameter should assert
     expect_assert_failure(basic_array_alloc(0, dummy_size));
     expect_assert_failure(basic_array_alloc(sizeof(int), 0));
-    expect_assert_failure(basic_array_alloc(sizeof(int), -1));
+
+    // An elem_count whose size in bytes would overflow should fail
+    basic_array too_big = basic_array_alloc(sizeof(int),
+            SIZE_MAX / sizeof(int) + 1);
+    assert_true(basic_array_isnull(&too_big));
 
     basic_array array = basic_array_alloc(sizeof(int), dummy_size);
     if (basic_array_isnull(&array)) {
@@ -381,6 +385,113 @@ static void test_array_at_c(void **state)
     }
 }
 
+static void test_array_gather(void **state)
+{
+    (void) state;
+
+    enum { n = 67 };
+
+    basic_array src32 = basic_array_alloc(sizeof(int), n);
+    basic_array dest32 = basic_array_alloc(sizeof(int), n);
+    basic_array src64 = basic_array_alloc(sizeof(long long), n);
+    basic_array dest64 = basic_array_alloc(sizeof(long long), n);
+    basic_array src3 = basic_array_alloc(3, n);
+    basic_array dest3 = basic_array_alloc(3, n);
+    size_t indices[n];
+
+    for (int i = 0; i < n; ++i) {
+        *(int *)basic_array_at(&src32, i) = i * 10;
+        *(long long *)basic_array_at(&src64, i) = -i * 100LL;
+        memset(basic_array_at(&src3, i), i, 3);
+        indices[i] = (size_t)(i * 31) % n;
+    }
+
+    // Mismatched element sizes, too many indices, or an invalid index
+    // should assert
+    expect_assert_failure(basic_array_gather(&dest32, &src64, indices, n));
+    expect_assert_failure(basic_array_gather(&dest32, &src32, indices, n + 1));
+    indices[n - 1] = n;
+    expect_assert_failure(basic_array_gather(&dest32, &src32, indices, n));
+    indices[n - 1] = (size_t)((n - 1) * 31) % n;
+
+    // Each destination element i should equal src[indices[i]] for every
+    // element size, including sizes without a vector fast path
+    basic_array_gather(&dest32, &src32, indices, n);
+    basic_array_gather(&dest64, &src64, indices, n);
+    basic_array_gather(&dest3, &src3, indices, n);
+
+    for (int i = 0; i < n; ++i) {
+        assert_true(*(int *)basic_array_at(&dest32, i)
+                == (int)indices[i] * 10);
+        assert_true(*(long long *)basic_array_at(&dest64, i)
+                == -(long long)indices[i] * 100);
+        assert_memory_equal(basic_array_at(&dest3, i),
+                basic_array_at(&src3, indices[i]), 3);
+    }
+
+    basic_array_dealloc(&dest3);
+    basic_array_dealloc(&src3);
+    basic_array_dealloc(&dest64);
+    basic_array_dealloc(&src64);
+    basic_array_dealloc(&dest32);
+    basic_array_dealloc(&src32);
+}
+
+static void test_array_scatter(void **state)
+{
+    (void) state;
+
+    enum { n = 40 };
+
+    basic_array src = basic_array_alloc(sizeof(int), n);
+    basic_array dest = basic_array_alloc(sizeof(int), n);
+    size_t indices[n];
+
+    for (int i = 0; i < n; ++i) {
+        *(int *)basic_array_at(&src, i) = i;
+        indices[i] = (size_t)(n - 1 - i);
+    }
+
+    expect_assert_failure(basic_array_scatter(&dest, &src, indices, n + 1));
+
+    // Each src element i should be written to dest[indices[i]]
+    basic_array_scatter(&dest, &src, indices, n);
+    for (int i = 0; i < n; ++i) {
+        assert_true(*(int *)basic_array_at(&dest, indices[i]) == i);
+    }
+
+    basic_array_dealloc(&dest);
+    basic_array_dealloc(&src);
+}
+
+static void test_array_permute(void **state)
+{
+    (void) state;
+
+    enum { n = 50 };
+
+    basic_array array = basic_array_alloc(sizeof(int), n);
+    size_t perm[n];
+
+    for (int i = 0; i < n; ++i) {
+        *(int *)basic_array_at(&array, i) = i * 2;
+        perm[i] = (size_t)(i * 7 + 3) % n;
+    }
+
+    expect_assert_failure(basic_array_permute(&array, perm, n + 1));
+
+    // After permuting, element i should hold the old element perm[i]
+    assert_true(basic_array_permute(&array, perm, n));
+    for (int i = 0; i < n; ++i) {
+        assert_true(*(int *)basic_array_at(&array, i) == (int)perm[i] * 2);
+    }
+
+    // Permuting zero elements is a no-op
+    assert_true(basic_array_permute(&array, perm, 0));
+
+    basic_array_dealloc(&array);
+}
+
 int main(int argc, char **argv)
 {
     (void) argc;
@@ -399,6 +510,9 @@ int main(int argc, char **argv)
         cmocka_unit_test(test_array_cap),
         cmocka_unit_test(test_array_at),
         cmocka_unit_test(test_array_at_c),
+        cmocka_unit_test(test_array_gather),
+        cmocka_unit_test(test_array_scatter),
+        cmocka_unit_test(test_array_permute),
     };
 
     return cmocka_run_group_tests(tests, NULL, NULL);
@@ -0,0 +1,404 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+
+#include "bits.h"
+#include "bitset.h"
+#include "bitvector.h"
+#include "rank_select.h"
+
+enum { bit_count = 1000 };
+
+static basic_bitset make_bitset(void)
+{
+    basic_bitset bitset = basic_bitset_new(bit_count);
+    if (basic_bitset_isnull(&bitset)) {
+        fail_msg("Failed to allocate basic_bitset for testing");
+    }
+
+    return bitset;
+}
+
+static void test_bitset_new(void **state)
+{
+    (void) state;
+
+    // A non-positive bit count should assert
+    expect_assert_failure(basic_bitset_new(0));
+    expect_assert_failure(basic_bitset_new(-1));
+
+    // A new bitset should be initialised with every bit clear
+    basic_bitset bitset = make_bitset();
+    assert_true(basic_bitset_isinit(&bitset));
+    assert_true(bitset.bit_count == bit_count);
+    assert_true(basic_bitset_count(&bitset) == 0);
+
+    basic_bitset_destroy(&bitset);
+    assert_true(basic_bitset_isnull(&bitset));
+}
+
+static void test_bitset_set_clear_test(void **state)
+{
+    (void) state;
+
+    basic_bitset bitset = make_bitset();
+
+    // Out of range indices should assert
+    expect_assert_failure(basic_bitset_set(&bitset, -1));
+    expect_assert_failure(basic_bitset_set(&bitset, bit_count));
+    expect_assert_failure(basic_bitset_test(&bitset, bit_count));
+
+    basic_bitset_set(&bitset, 0);
+    basic_bitset_set(&bitset, 63);
+    basic_bitset_set(&bitset, 64);
+    basic_bitset_set(&bitset, bit_count - 1);
+    basic_bitset_flip(&bitset, 500);
+    basic_bitset_flip(&bitset, 63);
+
+    assert_true(basic_bitset_test(&bitset, 0));
+    assert_false(basic_bitset_test(&bitset, 63));
+    assert_true(basic_bitset_test(&bitset, 64));
+    assert_true(basic_bitset_test(&bitset, 500));
+    assert_true(basic_bitset_test(&bitset, bit_count - 1));
+    assert_true(basic_bitset_count(&bitset) == 4);
+
+    basic_bitset_clear(&bitset, 64);
+    assert_false(basic_bitset_test(&bitset, 64));
+    assert_true(basic_bitset_count(&bitset) == 3);
+
+    // Filling sets exactly bit_count bits
+    basic_bitset_fill(&bitset, true);
+    assert_true(basic_bitset_count(&bitset) == bit_count);
+    basic_bitset_fill(&bitset, false);
+    assert_true(basic_bitset_count(&bitset) == 0);
+
+    basic_bitset_destroy(&bitset);
+}
+
+static void test_bitset_next(void **state)
+{
+    (void) state;
+
+    basic_bitset bitset = make_bitset();
+    int const expected[] = {3, 64, 65, 511, 512, 999};
+    int const expected_count = sizeof expected / sizeof expected[0];
+
+    assert_true(basic_bitset_next(&bitset, 0) == -1);
+
+    for (int i = 0; i < expected_count; ++i) {
+        basic_bitset_set(&bitset, expected[i]);
+    }
+
+    // Iterating with next should visit exactly the set bits, in order
+    int visited = 0;
+    for (int i = basic_bitset_next(&bitset, 0); i != -1;
+            i = basic_bitset_next(&bitset, i + 1)) {
+        assert_true(visited < expected_count);
+        assert_true(i == expected[visited]);
+        ++visited;
+    }
+
+    assert_true(visited == expected_count);
+    expect_assert_failure(basic_bitset_next(&bitset, bit_count + 1));
+
+    basic_bitset_destroy(&bitset);
+}
+
+static void test_bitset_bulk(void **state)
+{
+    (void) state;
+
+    basic_bitset lhs = make_bitset();
+    basic_bitset rhs = make_bitset();
+    basic_bitset other = basic_bitset_new(bit_count / 2);
+
+    for (int i = 0; i < bit_count; ++i) {
+        if (i % 2 == 0) {
+            basic_bitset_set(&lhs, i);
+        }
+
+        if (i % 3 == 0) {
+            basic_bitset_set(&rhs, i);
+        }
+    }
+
+    // Mismatched sizes should assert
+    expect_assert_failure(basic_bitset_and(&lhs, &other));
+
+    basic_bitset result = basic_bitset_clone(&lhs);
+    basic_bitset_and(&result, &rhs);
+    for (int i = 0; i < bit_count; ++i) {
+        assert_true(basic_bitset_test(&result, i) == (i % 6 == 0));
+    }
+
+    basic_bitset_destroy(&result);
+    result = basic_bitset_clone(&lhs);
+    basic_bitset_or(&result, &rhs);
+    for (int i = 0; i < bit_count; ++i) {
+        assert_true(basic_bitset_test(&result, i) == (i % 2 == 0 || i % 3 == 0));
+    }
+
+    basic_bitset_destroy(&result);
+    result = basic_bitset_clone(&lhs);
+    basic_bitset_xor(&result, &rhs);
+    for (int i = 0; i < bit_count; ++i) {
+        assert_true(basic_bitset_test(&result, i)
+                == ((i % 2 == 0) != (i % 3 == 0)));
+    }
+
+    basic_bitset_destroy(&result);
+    result = basic_bitset_clone(&lhs);
+    basic_bitset_andnot(&result, &rhs);
+    for (int i = 0; i < bit_count; ++i) {
+        assert_true(basic_bitset_test(&result, i) == (i % 2 == 0 && i % 3 != 0));
+    }
+
+    basic_bitset_destroy(&result);
+    basic_bitset_destroy(&other);
+    basic_bitset_destroy(&rhs);
+    basic_bitset_destroy(&lhs);
+}
+
+static void test_bits_ceil_pow2(void **state)
+{
+    (void) state;
+
+    assert_true(basic_bits_ceil_pow2(0) == 1);
+    assert_true(basic_bits_ceil_pow2(1) == 1);
+    assert_true(basic_bits_ceil_pow2(2) == 2);
+    assert_true(basic_bits_ceil_pow2(3) == 4);
+    assert_true(basic_bits_ceil_pow2(64) == 64);
+    assert_true(basic_bits_ceil_pow2(65) == 128);
+    assert_true(basic_bits_ceil_pow2((UINT64_C(1) << 30) + 1)
+            == UINT64_C(1) << 31);
+    assert_true(basic_bits_ceil_pow2(UINT64_C(1) << 63) == UINT64_C(1) << 63);
+    assert_true(basic_bits_ceil_pow2((UINT64_C(1) << 63) + 1) == 0);
+    assert_true(basic_bits_ceil_pow2(UINT64_MAX) == 0);
+}
+
+static basic_bitvector make_bitvector(int bits, int every)
+{
+    basic_bitvector bitvector = basic_bitvector_new(1);
+    if (basic_bitvector_isnull(&bitvector)) {
+        fail_msg("Failed to allocate basic_bitvector for testing");
+    }
+
+    for (int i = 0; i < bits; ++i) {
+        if (!basic_bitvector_pushback(&bitvector, i % every == 0)) {
+            fail_msg("Failed to build basic_bitvector for testing");
+        }
+    }
+
+    return bitvector;
+}
+
+// The bits past bit_count must stay clear, so the whole storage counts the
+// same as the bitvector
+static void assert_tail_clear(basic_bitvector const *bitvector)
+{
+    assert_true(basic_bitset_count(&bitvector->bits)
+            == basic_bitvector_count(bitvector));
+}
+
+static void test_bitvector_growth(void **state)
+{
+    (void) state;
+
+    expect_assert_failure(basic_bitvector_new(0));
+
+    // Pushing past the capacity grows it, one word at first
+    basic_bitvector bitvector = make_bitvector(0, 1);
+    assert_true(basic_bitvector_isempty(&bitvector));
+    assert_true(bitvector.bits.bit_count == BASIC_BITS_PER_WORD);
+    expect_assert_failure(basic_bitvector_popback(&bitvector));
+
+    for (int i = 0; i < bit_count; ++i) {
+        assert_true(basic_bitvector_pushback(&bitvector, i % 3 == 0));
+    }
+
+    assert_true(bitvector.bit_count == bit_count);
+    assert_true(bitvector.bits.bit_count >= bit_count);
+    assert_true(basic_bitvector_count(&bitvector) == (bit_count + 2) / 3);
+    expect_assert_failure(basic_bitvector_test(&bitvector, bit_count));
+
+    int expected = 0;
+    for (int i = basic_bitvector_next(&bitvector, 0);
+            i != -1;
+            i = basic_bitvector_next(&bitvector, i + 1)) {
+        assert_true(i == expected);
+        expected += 3;
+    }
+
+    assert_true(expected == (bit_count + 2) / 3 * 3);
+    assert_true(basic_bitvector_next(&bitvector, bit_count) == -1);
+
+    // Popping clears the bit it removes
+    basic_bitvector_popback(&bitvector);
+    assert_true(bitvector.bit_count == bit_count - 1);
+    assert_true(basic_bitvector_test(&bitvector, bit_count - 2)
+            == ((bit_count - 2) % 3 == 0));
+    assert_tail_clear(&bitvector);
+
+    basic_bitvector clone = basic_bitvector_clone(&bitvector);
+    basic_bitvector_destroy(&bitvector);
+    assert_true(basic_bitvector_isnull(&bitvector));
+    assert_true(clone.bit_count == bit_count - 1);
+    assert_true(basic_bitvector_count(&clone) == (bit_count + 1) / 3);
+    basic_bitvector_destroy(&clone);
+}
+
+static void test_bitvector_shrink_regrow(void **state)
+{
+    (void) state;
+
+    basic_bitvector bitvector = make_bitvector(bit_count, 1);
+    expect_assert_failure(basic_bitvector_resize(&bitvector, -1));
+
+    // Shrinking into the middle of a word, then growing back, reads the
+    // dropped bits back clear
+    assert_true(basic_bitvector_resize(&bitvector, 70));
+    assert_true(basic_bitvector_count(&bitvector) == 70);
+    assert_tail_clear(&bitvector);
+
+    assert_true(basic_bitvector_resize(&bitvector, bit_count));
+    for (int i = 0; i < bit_count; ++i) {
+        assert_true(basic_bitvector_test(&bitvector, i) == (i < 70));
+    }
+
+    // The same through popping and pushing across a word boundary
+    while (bitvector.bit_count > 60) {
+        basic_bitvector_popback(&bitvector);
+    }
+
+    for (int i = 60; i < 130; ++i) {
+        assert_true(basic_bitvector_pushback(&bitvector, false));
+    }
+
+    assert_true(basic_bitvector_count(&bitvector) == 60);
+    assert_true(basic_bitvector_next(&bitvector, 60) == -1);
+    assert_tail_clear(&bitvector);
+
+    // Shrinking to nothing and growing past the old capacity
+    int const cap = bitvector.bits.bit_count;
+    assert_true(basic_bitvector_resize(&bitvector, 0));
+    assert_true(basic_bitvector_isempty(&bitvector));
+    assert_true(basic_bitvector_resize(&bitvector, cap + 1));
+    assert_true(bitvector.bits.bit_count > cap);
+    assert_true(basic_bitvector_count(&bitvector) == 0);
+    assert_tail_clear(&bitvector);
+
+    basic_bitvector_destroy(&bitvector);
+}
+
+static void test_bitvector_bulk(void **state)
+{
+    (void) state;
+
+    // Neither count is a multiple of a word, so the last word is partial
+    enum { bits = 3 * BASIC_BITS_PER_WORD + 17 };
+    basic_bitvector lhs = make_bitvector(bits, 2);
+    basic_bitvector rhs = make_bitvector(bits, 3);
+    basic_bitvector other = make_bitvector(bits - 1, 2);
+
+    expect_assert_failure(basic_bitvector_and(&lhs, &other));
+    expect_assert_failure(basic_bitvector_or(&lhs, &other));
+
+    basic_bitvector result = basic_bitvector_clone(&lhs);
+    basic_bitvector_and(&result, &rhs);
+    for (int i = 0; i < bits; ++i) {
+        assert_true(basic_bitvector_test(&result, i) == (i % 6 == 0));
+    }
+
+    assert_tail_clear(&result);
+    basic_bitvector_destroy(&result);
+
+    result = basic_bitvector_clone(&lhs);
+    basic_bitvector_or(&result, &rhs);
+    for (int i = 0; i < bits; ++i) {
+        assert_true(basic_bitvector_test(&result, i)
+                == (i % 2 == 0 || i % 3 == 0));
+    }
+
+    assert_tail_clear(&result);
+    basic_bitvector_destroy(&result);
+
+    result = basic_bitvector_clone(&lhs);
+    basic_bitvector_xor(&result, &rhs);
+    for (int i = 0; i < bits; ++i) {
+        assert_true(basic_bitvector_test(&result, i)
+                == ((i % 2 == 0) != (i % 3 == 0)));
+    }
+
+    assert_tail_clear(&result);
+    basic_bitvector_destroy(&result);
+
+    result = basic_bitvector_clone(&lhs);
+    basic_bitvector_andnot(&result, &rhs);
+    for (int i = 0; i < bits; ++i) {
+        assert_true(basic_bitvector_test(&result, i)
+                == (i % 2 == 0 && i % 3 != 0));
+    }
+
+    assert_tail_clear(&result);
+    basic_bitvector_destroy(&result);
+
+    basic_bitvector_destroy(&other);
+    basic_bitvector_destroy(&rhs);
+    basic_bitvector_destroy(&lhs);
+}
+
+static void test_rank_select(void **state)
+{
+    (void) state;
+
+    basic_bitset bitset = make_bitset();
+    for (int i = 0; i < bit_count; i += 7) {
+        basic_bitset_set(&bitset, i);
+    }
+
+    basic_rank_select rank_select = basic_rank_select_new(&bitset);
+    assert_true(basic_rank_select_isinit(&rank_select));
+
+    // rank(i) is the number of set bits before i, and select inverts it
+    for (int i = 0; i <= bit_count; ++i) {
+        assert_true(basic_rank_select_rank(&rank_select, &bitset, i)
+                == (i + 6) / 7);
+    }
+
+    int const set_count = basic_bitset_count(&bitset);
+    for (int rank = 0; rank < set_count; ++rank) {
+        assert_true(basic_rank_select_select(&rank_select, &bitset, rank)
+                == rank * 7);
+    }
+
+    assert_true(basic_rank_select_select(&rank_select, &bitset, set_count)
+            == -1);
+    expect_assert_failure(
+            basic_rank_select_rank(&rank_select, &bitset, bit_count + 1));
+
+    basic_rank_select_destroy(&rank_select);
+    assert_true(basic_rank_select_isnull(&rank_select));
+    basic_bitset_destroy(&bitset);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_bitset_new),
+        cmocka_unit_test(test_bitset_set_clear_test),
+        cmocka_unit_test(test_bitset_next),
+        cmocka_unit_test(test_bitset_bulk),
+        cmocka_unit_test(test_bits_ceil_pow2),
+        cmocka_unit_test(test_bitvector_growth),
+        cmocka_unit_test(test_bitvector_shrink_regrow),
+        cmocka_unit_test(test_bitvector_bulk),
+        cmocka_unit_test(test_rank_select),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
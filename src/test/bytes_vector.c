@@ -0,0 +1,185 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+
+#include "bytes_vector.h"
+#include "hash.h"
+
+enum { string_count = 300 };
+
+// Strings of 0..9 bytes with a NUL in the middle of each one that has
+// room for it
+static basic_span make_string(unsigned char *buf, int i)
+{
+    size_t const size = (size_t)(i % 10);
+    for (size_t j = 0; j < size; ++j) {
+        buf[j] = j == size / 2 ? 0 : (unsigned char)(i + (int)j);
+    }
+
+    return (basic_span){buf, size};
+}
+
+static basic_bytes_vector make_bytes_vector(void)
+{
+    basic_bytes_vector bytes_vector = basic_bytes_vector_new(1, 1);
+    if (basic_bytes_vector_isnull(&bytes_vector)) {
+        fail_msg("Failed to allocate basic_bytes_vector for testing");
+    }
+
+    return bytes_vector;
+}
+
+static void assert_string_at(
+        basic_bytes_vector const *bytes_vector,
+        size_t index,
+        int i)
+{
+    unsigned char buf[16];
+    basic_span const expected = make_string(buf, i);
+    basic_span const actual = basic_bytes_vector_get(bytes_vector, index);
+
+    assert_true(actual.size == expected.size);
+    assert_true(basic_bytes_vector_size(bytes_vector, index) == expected.size);
+    assert_memory_equal(actual.ptr, expected.ptr, expected.size);
+}
+
+static void test_bytes_vector_insertback(void **state)
+{
+    (void) state;
+
+    expect_assert_failure(basic_bytes_vector_new(0, 1));
+
+    basic_bytes_vector bytes_vector = make_bytes_vector();
+    assert_true(basic_bytes_vector_isempty(&bytes_vector));
+    expect_assert_failure(basic_bytes_vector_get(&bytes_vector, 0));
+    expect_assert_failure(basic_bytes_vector_removeback(&bytes_vector));
+
+    unsigned char buf[16];
+    for (int i = 0; i < string_count; ++i) {
+        basic_span const string = make_string(buf, i);
+        assert_true(basic_bytes_vector_insertback(&bytes_vector, &string));
+    }
+
+    // An empty string needs no data at all
+    basic_span const empty = BASIC_SPAN_NULL;
+    assert_true(basic_bytes_vector_insertback(&bytes_vector, &empty));
+    assert_true(basic_bytes_vector_size(&bytes_vector, string_count) == 0);
+    basic_bytes_vector_removeback(&bytes_vector);
+
+    assert_true(basic_bytes_vector_count(&bytes_vector) == string_count);
+    for (int i = 0; i < string_count; ++i) {
+        assert_string_at(&bytes_vector, (size_t)i, i);
+    }
+
+    // Views hash and compare by their length, NULs included
+    basic_span const first = basic_bytes_vector_get(&bytes_vector, 3);
+    basic_span const second = basic_bytes_vector_get(&bytes_vector, 3);
+    basic_span const other = basic_bytes_vector_get(&bytes_vector, 13);
+    assert_true(basic_span_equal(&first, &second));
+    assert_false(basic_span_equal(&first, &other));
+    assert_true(basic_hash_span(&first) == basic_hash_span(&second));
+
+    basic_bytes_vector clone = basic_bytes_vector_clone(&bytes_vector);
+    basic_bytes_vector_destroy(&bytes_vector);
+    assert_true(basic_bytes_vector_isnull(&bytes_vector));
+    assert_string_at(&clone, string_count - 1, string_count - 1);
+    basic_bytes_vector_destroy(&clone);
+}
+
+static void test_bytes_vector_insert_remove(void **state)
+{
+    (void) state;
+
+    basic_bytes_vector bytes_vector = make_bytes_vector();
+    unsigned char buf[16];
+
+    // Insert the even strings, then slot the odd ones in between
+    for (int i = 0; i < string_count; i += 2) {
+        basic_span const string = make_string(buf, i);
+        assert_true(basic_bytes_vector_insert(&bytes_vector,
+                    (size_t)i / 2,
+                    &string));
+    }
+
+    for (int i = 1; i < string_count; i += 2) {
+        basic_span const string = make_string(buf, i);
+        assert_true(basic_bytes_vector_insert(&bytes_vector,
+                    (size_t)i,
+                    &string));
+    }
+
+    for (int i = 0; i < string_count; ++i) {
+        assert_string_at(&bytes_vector, (size_t)i, i);
+    }
+
+    // Removing the odd strings again leaves the even ones in order
+    for (size_t i = 1; i < basic_bytes_vector_count(&bytes_vector); ++i) {
+        basic_bytes_vector_remove(&bytes_vector, i);
+    }
+
+    assert_true(basic_bytes_vector_count(&bytes_vector) == string_count / 2);
+    for (int i = 0; i < string_count / 2; ++i) {
+        assert_string_at(&bytes_vector, (size_t)i, 2 * i);
+    }
+
+    while (!basic_bytes_vector_isempty(&bytes_vector)) {
+        basic_bytes_vector_remove(&bytes_vector, 0);
+    }
+
+    assert_true(bytes_vector.bytes.elem_count == 0);
+    basic_bytes_vector_destroy(&bytes_vector);
+}
+
+static void test_bytes_vector_insert_own(void **state)
+{
+    (void) state;
+
+    enum { count = 20 };
+    basic_bytes_vector bytes_vector = make_bytes_vector();
+    unsigned char buf[16];
+
+    for (int i = 0; i < count; ++i) {
+        basic_span const string = make_string(buf, i);
+        assert_true(basic_bytes_vector_insertback(&bytes_vector, &string));
+    }
+
+    // Duplicating each string through its own view, which points into the
+    // storage the insertion grows and shifts
+    for (int i = 0; i < count; ++i) {
+        basic_span const string = basic_bytes_vector_get(&bytes_vector,
+                2 * (size_t)i);
+        assert_true(basic_bytes_vector_insert(&bytes_vector,
+                    2 * (size_t)i + 1,
+                    &string));
+    }
+
+    for (int i = 0; i < count; ++i) {
+        assert_string_at(&bytes_vector, 2 * (size_t)i, i);
+        assert_string_at(&bytes_vector, 2 * (size_t)i + 1, i);
+    }
+
+    // A view of a string after the insertion point moves with the tail
+    basic_span const last = basic_bytes_vector_get(&bytes_vector,
+            2 * count - 1);
+    assert_true(basic_bytes_vector_insert(&bytes_vector, 0, &last));
+    assert_string_at(&bytes_vector, 0, count - 1);
+    assert_string_at(&bytes_vector, 2 * count, count - 1);
+
+    basic_bytes_vector_destroy(&bytes_vector);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_bytes_vector_insertback),
+        cmocka_unit_test(test_bytes_vector_insert_remove),
+        cmocka_unit_test(test_bytes_vector_insert_own),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
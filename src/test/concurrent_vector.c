@@ -0,0 +1,251 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+
+#include "concurrent_vector.h"
+
+enum {
+    base_cap = 3,
+    elem_count = 1000,
+    thread_count = 4,
+    values_per_thread = 5000
+};
+
+// Each value is stored with its complement, so a reader can tell a fully
+// written element from a torn or zeroed one
+typedef struct {
+    int value;
+    int check;
+} tagged;
+
+typedef struct {
+    basic_concurrent_vector *vector;
+    int thread;
+    int failed;
+} appender;
+
+typedef struct {
+    basic_concurrent_vector *vector;
+    atomic_bool *done;
+    int torn;
+    int lost;
+} watcher;
+
+static basic_concurrent_vector make_vector(void)
+{
+    basic_concurrent_vector vector =
+        basic_concurrent_vector_new(sizeof(int), base_cap);
+    if (basic_concurrent_vector_isnull(&vector)) {
+        fail_msg("Failed to allocate basic_concurrent_vector for testing");
+    }
+
+    return vector;
+}
+
+static void test_concurrent_vector_append(void **state)
+{
+    (void) state;
+
+    expect_assert_failure(basic_concurrent_vector_new(0, base_cap));
+    expect_assert_failure(basic_concurrent_vector_new(sizeof(int), 0));
+
+    // A base capacity that cannot be rounded up within an int is rejected
+    basic_concurrent_vector huge =
+        basic_concurrent_vector_new(sizeof(int), INT_MAX);
+    assert_true(basic_concurrent_vector_isnull(&huge));
+
+    basic_concurrent_vector vector = make_vector();
+    assert_true(vector.base_cap == 4);
+
+    // Unreserved indices read as unpublished rather than out of range
+    assert_null(basic_concurrent_vector_at(&vector, 0));
+    assert_null(basic_concurrent_vector_at(&vector, elem_count));
+
+    int *first = NULL;
+    for (int i = 0; i < elem_count; ++i) {
+        assert_true(basic_concurrent_vector_append(&vector, &i) == i);
+        if (!i) {
+            first = basic_concurrent_vector_at(&vector, 0);
+        }
+    }
+
+    assert_true(basic_concurrent_vector_count(&vector) == elem_count);
+
+    // Every element reads back across the segment boundaries, and earlier
+    // pointers are still valid after later segments were allocated
+    for (int i = 0; i < elem_count; ++i) {
+        int const *const elem = basic_concurrent_vector_at_c(&vector, i);
+        assert_non_null(elem);
+        assert_true(*elem == i);
+    }
+
+    assert_ptr_equal(first, basic_concurrent_vector_at(&vector, 0));
+
+    basic_concurrent_vector_destroy(&vector);
+    assert_true(basic_concurrent_vector_isnull(&vector));
+}
+
+static void test_concurrent_vector_append_n(void **state)
+{
+    (void) state;
+
+    basic_concurrent_vector vector = make_vector();
+    int elems[elem_count];
+
+    for (int i = 0; i < elem_count; ++i) {
+        elems[i] = i;
+    }
+
+    expect_assert_failure(basic_concurrent_vector_append_n(&vector, elems, 0));
+
+    // Ranges that straddle several segments are split between them
+    assert_true(basic_concurrent_vector_append_n(&vector, elems, 2) == 0);
+    assert_true(basic_concurrent_vector_append_n(&vector, elems + 2, 100) == 2);
+    assert_true(basic_concurrent_vector_append_n(&vector,
+                elems + 102,
+                elem_count - 102) == 102);
+
+    for (int i = 0; i < elem_count; ++i) {
+        assert_true(*(int *)basic_concurrent_vector_at(&vector, i) == i);
+    }
+
+    // An append that would pass INT_MAX reserves nothing
+    atomic_store(&vector.elem_count, INT_MAX - 1);
+    assert_true(basic_concurrent_vector_append_n(&vector, elems, 2) == -1);
+    assert_true(basic_concurrent_vector_count(&vector) == INT_MAX - 1);
+    atomic_store(&vector.elem_count, elem_count);
+
+    basic_concurrent_vector_destroy(&vector);
+}
+
+static void *append_values(void *arg)
+{
+    // Singles and pairs alternate, so pairs land across segment and bitmap
+    // word boundaries alongside other threads' appends
+    appender *const self = arg;
+    int const first = self->thread * values_per_thread;
+
+    for (int i = 0; i < values_per_thread;) {
+        tagged elems[2];
+        int const n = i % 3 == 0 && i + 1 < values_per_thread ? 2 : 1;
+        for (int j = 0; j < n; ++j) {
+            elems[j] = (tagged){first + i + j, ~(first + i + j)};
+        }
+
+        if (basic_concurrent_vector_append_n(self->vector, elems, n) < 0) {
+            ++self->failed;
+        }
+
+        i += n;
+    }
+
+    return NULL;
+}
+
+static void *watch_values(void *arg)
+{
+    // An element reads as NULL until it is published and never goes back,
+    // and once published it is whole
+    watcher *const self = arg;
+    bool seen[thread_count * values_per_thread] = {false};
+
+    while (!atomic_load(self->done)) {
+        int const count = basic_concurrent_vector_count(self->vector);
+        for (int i = 0; i < count; ++i) {
+            tagged const *const elem =
+                basic_concurrent_vector_at_c(self->vector, i);
+            if (!elem) {
+                self->lost += seen[i];
+                continue;
+            }
+
+            self->torn += elem->check != ~elem->value;
+            seen[i] = true;
+        }
+    }
+
+    return NULL;
+}
+
+static void test_concurrent_vector_threads(void **state)
+{
+    (void) state;
+
+    // A single-element first segment makes the appenders race to allocate
+    // most of the segments
+    basic_concurrent_vector vector =
+        basic_concurrent_vector_new(sizeof(tagged), 1);
+    assert_true(basic_concurrent_vector_isinit(&vector));
+
+    atomic_bool done;
+    atomic_init(&done, false);
+    watcher reader = {.vector = &vector, .done = &done};
+    pthread_t reader_id;
+    assert_true(!pthread_create(&reader_id, NULL, watch_values, &reader));
+
+    appender appenders[thread_count];
+    pthread_t appender_ids[thread_count];
+    for (int i = 0; i < thread_count; ++i) {
+        appenders[i] = (appender){.vector = &vector, .thread = i};
+        assert_true(!pthread_create(&appender_ids[i],
+                    NULL,
+                    append_values,
+                    &appenders[i]));
+    }
+
+    for (int i = 0; i < thread_count; ++i) {
+        pthread_join(appender_ids[i], NULL);
+        assert_true(appenders[i].failed == 0);
+    }
+
+    atomic_store(&done, true);
+    pthread_join(reader_id, NULL);
+    assert_true(reader.torn == 0);
+    assert_true(reader.lost == 0);
+
+    // Every value was appended exactly once, and each thread's values are
+    // in the order it appended them
+    enum { total = thread_count * values_per_thread };
+    assert_true(basic_concurrent_vector_count(&vector) == total);
+
+    static int index_of[total];
+    for (int i = 0; i < total; ++i) {
+        index_of[i] = -1;
+    }
+
+    for (int i = 0; i < total; ++i) {
+        tagged const *const elem = basic_concurrent_vector_at_c(&vector, i);
+        assert_non_null(elem);
+        assert_true(elem->check == ~elem->value);
+        assert_true(elem->value >= 0 && elem->value < total);
+        assert_true(index_of[elem->value] == -1);
+        index_of[elem->value] = i;
+    }
+
+    for (int i = 0; i < total; ++i) {
+        assert_true(i % values_per_thread == 0
+                || index_of[i] > index_of[i - 1]);
+    }
+
+    basic_concurrent_vector_destroy(&vector);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_concurrent_vector_append),
+        cmocka_unit_test(test_concurrent_vector_append_n),
+        cmocka_unit_test(test_concurrent_vector_threads),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
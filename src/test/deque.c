@@ -0,0 +1,173 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <limits.h>
+#include <string.h>
+
+#include "deque.h"
+
+enum { initial_cap = 3, elem_count = 100 };
+
+static basic_deque make_deque(void)
+{
+    basic_deque deque = basic_deque_new(sizeof(int), initial_cap);
+    if (basic_deque_isnull(&deque)) {
+        fail_msg("Failed to allocate basic_deque for testing");
+    }
+
+    return deque;
+}
+
+static void test_deque_new(void **state)
+{
+    (void) state;
+
+    expect_assert_failure(basic_deque_new(0, initial_cap));
+    expect_assert_failure(basic_deque_new(sizeof(int), 0));
+
+    // A capacity that cannot be rounded up within an int is rejected
+    basic_deque huge = basic_deque_new(sizeof(int), INT_MAX / 2 + 2);
+    assert_true(basic_deque_isnull(&huge));
+
+    // The capacity is rounded up to a power of two
+    basic_deque deque = make_deque();
+    assert_true(basic_deque_isinit(&deque));
+    assert_true(basic_deque_isempty(&deque));
+    assert_true(deque.elem_cap == 4);
+
+    basic_deque_destroy(&deque);
+    assert_true(basic_deque_isnull(&deque));
+}
+
+static void test_deque_push_pop(void **state)
+{
+    (void) state;
+
+    basic_deque deque = make_deque();
+
+    // Popping an empty deque should assert
+    expect_assert_failure(basic_deque_popfront(&deque));
+    expect_assert_failure(basic_deque_popback(&deque));
+
+    // Interleave pushes at both ends so that the contents wrap and the
+    // ring buffer grows several times
+    for (int i = 0; i < elem_count; ++i) {
+        if (i % 2) {
+            assert_true(basic_deque_pushback(&deque, &i));
+        } else {
+            assert_true(basic_deque_pushfront(&deque, &i));
+        }
+    }
+
+    assert_true(deque.elem_count == elem_count);
+
+    // The front holds the even values descending, then the odd values
+    // ascending
+    for (int i = 0; i < elem_count; ++i) {
+        int const expected = i < elem_count / 2
+            ? elem_count - 2 - 2 * i
+            : 2 * (i - elem_count / 2) + 1;
+        assert_true(*(int *)basic_deque_at(&deque, i) == expected);
+    }
+
+    expect_assert_failure(basic_deque_at(&deque, elem_count));
+
+    assert_true(*(int *)basic_deque_front(&deque) == elem_count - 2);
+    assert_true(*(int *)basic_deque_back(&deque) == elem_count - 1);
+
+    basic_deque_popfront(&deque);
+    basic_deque_popback(&deque);
+    assert_true(*(int *)basic_deque_front(&deque) == elem_count - 4);
+    assert_true(*(int *)basic_deque_back(&deque) == elem_count - 3);
+
+    basic_deque_destroy(&deque);
+}
+
+static void test_deque_fifo(void **state)
+{
+    (void) state;
+
+    basic_deque deque = make_deque();
+
+    // Used as a FIFO at a steady size, the deque should wrap without
+    // growing past the working set
+    int next_in = 0;
+    int next_out = 0;
+    for (; next_in < 3; ++next_in) {
+        assert_true(basic_deque_pushback(&deque, &next_in));
+    }
+
+    for (int round = 0; round < elem_count; ++round, ++next_in, ++next_out) {
+        assert_true(*(int *)basic_deque_front(&deque) == next_out);
+        basic_deque_popfront(&deque);
+        assert_true(basic_deque_pushback(&deque, &next_in));
+    }
+
+    assert_true(deque.elem_cap == 4);
+
+    basic_deque_destroy(&deque);
+}
+
+static void test_deque_spans(void **state)
+{
+    (void) state;
+
+    basic_deque deque = make_deque();
+    basic_span first;
+    basic_span second;
+
+    // An empty deque has two null spans
+    basic_deque_spans(&deque, &first, &second);
+    assert_true(basic_span_isnull(&first));
+    assert_true(basic_span_isnull(&second));
+
+    // Wrap the contents: push 3, pop 2, push 3 more into a 4-slot ring
+    for (int i = 0; i < 3; ++i) {
+        assert_true(basic_deque_pushback(&deque, &i));
+    }
+
+    basic_deque_popfront(&deque);
+    basic_deque_popfront(&deque);
+
+    for (int i = 3; i < 6; ++i) {
+        assert_true(basic_deque_pushback(&deque, &i));
+    }
+
+    assert_true(deque.elem_cap == 4);
+    basic_deque_spans(&deque, &first, &second);
+    assert_true(first.size + second.size == 4 * sizeof(int));
+    assert_false(basic_span_isnull(&second));
+
+    // Concatenating the spans gives the contents in order
+    int contents[4];
+    memcpy(contents, first.ptr, first.size);
+    memcpy((char *)contents + first.size, second.ptr, second.size);
+    for (int i = 0; i < 4; ++i) {
+        assert_true(contents[i] == i + 2);
+    }
+
+    // Growing unwraps the contents into a single span
+    int const value = 6;
+    assert_true(basic_deque_pushback(&deque, &value));
+    basic_deque_spans(&deque, &first, &second);
+    assert_true(first.size == 5 * sizeof(int));
+    assert_true(basic_span_isnull(&second));
+
+    basic_deque_destroy(&deque);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_deque_new),
+        cmocka_unit_test(test_deque_push_pop),
+        cmocka_unit_test(test_deque_fifo),
+        cmocka_unit_test(test_deque_spans),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
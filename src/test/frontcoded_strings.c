@@ -0,0 +1,179 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "frontcoded_strings.h"
+
+enum { string_count = 400 };
+
+static basic_string_vector make_sorted(void)
+{
+    basic_string_vector sorted = basic_string_vector_new(8, 1);
+    if (basic_string_vector_isnull(&sorted)) {
+        fail_msg("Failed to allocate basic_string_vector for testing");
+    }
+
+    // Paths sharing prefixes of many lengths, with an empty string,
+    // duplicates, and a string that is a prefix of the next
+    char buf[64];
+    for (int i = 0; i < string_count; ++i) {
+        if (i % 50 == 0) {
+            snprintf(buf, sizeof(buf), "https://example.com/%d", i / 100);
+        } else {
+            snprintf(buf, sizeof(buf), "https://example.com/%d/%s/%d",
+                    i / 100,
+                    i % 3 ? "docs" : "images",
+                    i % 7);
+        }
+
+        assert_true(basic_string_vector_insertback(&sorted, buf));
+    }
+
+    assert_true(basic_string_vector_insertback(&sorted, ""));
+    assert_true(basic_string_vector_sort(&sorted));
+    return sorted;
+}
+
+static size_t count_prefixed(
+        basic_string_vector const *sorted,
+        char const *prefix,
+        size_t *first)
+{
+    size_t count = 0;
+    *first = sorted->string_count;
+    for (size_t i = 0; i < sorted->string_count; ++i) {
+        if (!strncmp(basic_string_vector_at(sorted, i),
+                    prefix,
+                    strlen(prefix))) {
+            *first = count ? *first : i;
+            ++count;
+        }
+    }
+
+    return count;
+}
+
+static void test_frontcoded_strings_search(void **state)
+{
+    (void) state;
+
+    basic_string_vector sorted = make_sorted();
+    size_t const bucket_sizes[] = {1, 3, 16};
+
+    for (size_t b = 0; b < sizeof(bucket_sizes) / sizeof(bucket_sizes[0]);
+            ++b) {
+        basic_frontcoded_strings strings =
+            basic_frontcoded_strings_new(&sorted, bucket_sizes[b]);
+        assert_true(basic_frontcoded_strings_isinit(&strings));
+        assert_true(basic_frontcoded_strings_count(&strings)
+                == sorted.string_count);
+
+        char buf[64];
+        for (size_t i = 0; i < sorted.string_count; ++i) {
+            char const *const expected = basic_string_vector_at(&sorted, i);
+            size_t const len = strlen(expected);
+
+            assert_true(basic_frontcoded_strings_get(&strings,
+                        i,
+                        buf,
+                        sizeof(buf)) == len);
+            assert_string_equal(buf, expected);
+
+            // Truncated as snprintf would
+            assert_true(basic_frontcoded_strings_get(&strings, i, buf, 10)
+                    == len);
+            assert_true(strlen(buf) == (len < 9 ? len : 9));
+            assert_memory_equal(buf, expected, strlen(buf));
+
+            size_t index = sorted.string_count;
+            assert_true(basic_frontcoded_strings_find(&strings,
+                        expected,
+                        &index));
+            assert_true(index == basic_string_vector_lower_bound(&sorted,
+                        expected));
+
+            // Just after and just before each string, which are absent
+            snprintf(buf, sizeof(buf), "%s!", expected);
+            assert_false(basic_frontcoded_strings_find(&strings, buf, &index));
+            assert_true(basic_frontcoded_strings_lower_bound(&strings, buf)
+                    == basic_string_vector_lower_bound(&sorted, buf));
+
+            if (len) {
+                snprintf(buf, sizeof(buf), "%.*s", (int)len - 1, expected);
+                assert_true(basic_frontcoded_strings_lower_bound(&strings,
+                            buf)
+                        == basic_string_vector_lower_bound(&sorted, buf));
+            }
+        }
+
+        char const *const prefixes[] = {
+            "", "h", "https://example.com/1", "https://example.com/1/",
+            "https://example.com/2/docs/", "https://example.com/3/images/6",
+            "https://example.com/9", "zzz",
+        };
+        for (size_t p = 0; p < sizeof(prefixes) / sizeof(prefixes[0]); ++p) {
+            size_t first;
+            size_t expected_first;
+            size_t const count = basic_frontcoded_strings_prefix_range(
+                    &strings,
+                    prefixes[p],
+                    &first);
+            size_t const expected = count_prefixed(&sorted,
+                    prefixes[p],
+                    &expected_first);
+
+            assert_true(count == expected);
+            assert_true(!count || first == expected_first);
+        }
+
+        basic_frontcoded_strings_destroy(&strings);
+        assert_true(basic_frontcoded_strings_isnull(&strings));
+    }
+
+    basic_string_vector_destroy(&sorted);
+}
+
+static void test_frontcoded_strings_empty(void **state)
+{
+    (void) state;
+
+    basic_string_vector empty = basic_string_vector_new(8, 1);
+    expect_assert_failure(basic_frontcoded_strings_new(&empty, 0));
+
+    basic_frontcoded_strings strings = basic_frontcoded_strings_new(&empty, 4);
+    assert_true(basic_frontcoded_strings_isinit(&strings));
+    assert_true(basic_frontcoded_strings_count(&strings) == 0);
+    assert_true(basic_frontcoded_strings_lower_bound(&strings, "a") == 0);
+
+    size_t index;
+    size_t first;
+    assert_false(basic_frontcoded_strings_find(&strings, "", &index));
+    assert_true(basic_frontcoded_strings_prefix_range(&strings, "", &first)
+            == 0);
+    assert_true(first == 0);
+
+    char buf[4];
+    expect_assert_failure(basic_frontcoded_strings_get(&strings,
+                0,
+                buf,
+                sizeof(buf)));
+
+    basic_frontcoded_strings_destroy(&strings);
+    basic_string_vector_destroy(&empty);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_frontcoded_strings_search),
+        cmocka_unit_test(test_frontcoded_strings_empty),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,171 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdint.h>
+
+#include "hashmap.h"
+
+enum { entry_count = 5000 };
+
+static basic_hashmap make_map(basic_hash_fn hash)
+{
+    basic_hashmap map = basic_hashmap_new(sizeof(int), sizeof(int), hash, 0);
+    if (basic_hashmap_isnull(&map)) {
+        fail_msg("Failed to allocate basic_hashmap for testing");
+    }
+
+    return map;
+}
+
+// A deliberately poor hash that sends every key to one of four probe runs,
+// so that erasure has to shift long runs back
+static uint64_t clumped_hash(basic_span const *key)
+{
+    return (uint64_t)(*(int const *)key->ptr % 4) << 7
+        | (uint64_t)(*(int const *)key->ptr & 0x7f);
+}
+
+static void check_insert_find_erase(basic_hash_fn hash, int count)
+{
+    basic_hashmap map = make_map(hash);
+
+    for (int i = 0; i < count; ++i) {
+        int const value = i * 10;
+        assert_true(basic_hashmap_insert(&map, &i, &value));
+    }
+
+    assert_true(map.elem_count == count);
+
+    // Inserting an existing key overwrites its value
+    int const key = 7;
+    int const value = -1;
+    assert_true(basic_hashmap_insert(&map, &key, &value));
+    assert_true(map.elem_count == count);
+    assert_true(*(int *)basic_hashmap_find(&map, &key) == -1);
+
+    // Erase the even keys, then every remaining key must still be found
+    for (int i = 0; i < count; i += 2) {
+        assert_true(basic_hashmap_erase(&map, &i));
+        assert_false(basic_hashmap_erase(&map, &i));
+    }
+
+    assert_true(map.elem_count == count / 2);
+    for (int i = 0; i < count; ++i) {
+        int const *const found = basic_hashmap_find_c(&map, &i);
+        if (i % 2 == 0) {
+            assert_null(found);
+        } else {
+            assert_non_null(found);
+            assert_true(*found == (i == key ? -1 : i * 10));
+        }
+    }
+
+    basic_hashmap_destroy(&map);
+    assert_true(basic_hashmap_isnull(&map));
+}
+
+static void test_hashmap_new(void **state)
+{
+    (void) state;
+
+    expect_assert_failure(basic_hashmap_new(0, sizeof(int), NULL, 0));
+    expect_assert_failure(basic_hashmap_new(sizeof(int), 0, NULL, -1));
+
+    // Values are placed at their natural alignment after the key
+    basic_hashmap map = basic_hashmap_new(sizeof(char), sizeof(uint64_t),
+            NULL,
+            100);
+    assert_true(basic_hashmap_isempty(&map));
+    assert_true(map.value_offset == sizeof(uint64_t));
+    assert_true(map.slot_cap >= 100);
+
+    basic_hashmap_destroy(&map);
+}
+
+static void test_hashmap_insert_erase(void **state)
+{
+    (void) state;
+
+    check_insert_find_erase(NULL, entry_count);
+    check_insert_find_erase(clumped_hash, 500);
+}
+
+static void test_hashmap_emplace(void **state)
+{
+    (void) state;
+
+    basic_hashmap map = make_map(NULL);
+    bool inserted = false;
+    int const key = 42;
+
+    *(int *)basic_hashmap_emplace(&map, &key, &inserted) = 1;
+    assert_true(inserted);
+
+    int *const value = basic_hashmap_emplace(&map, &key, &inserted);
+    assert_false(inserted);
+    assert_true(*value == 1);
+    assert_true(basic_hashmap_contains(&map, &key));
+
+    basic_hashmap_destroy(&map);
+}
+
+static void test_hashmap_iterate_rehash(void **state)
+{
+    (void) state;
+
+    basic_hashmap map = make_map(NULL);
+    for (int i = 0; i < entry_count; ++i) {
+        assert_true(basic_hashmap_insert(&map, &i, &i));
+    }
+
+    // Iteration visits every entry exactly once
+    long sum = 0;
+    int visited = 0;
+    for (int i = basic_hashmap_next(&map, 0); i != -1;
+            i = basic_hashmap_next(&map, i + 1), ++visited) {
+        int const key = *(int const *)basic_hashmap_key_at(&map, i);
+        assert_true(*(int *)basic_hashmap_value_at(&map, i) == key);
+        sum += key;
+    }
+
+    assert_true(visited == entry_count);
+    assert_true(sum == (long)entry_count * (entry_count - 1) / 2);
+
+    // Shrinking after mass erasure keeps the survivors
+    for (int i = 10; i < entry_count; ++i) {
+        assert_true(basic_hashmap_erase(&map, &i));
+    }
+
+    assert_true(basic_hashmap_rehash(&map, 0));
+    assert_true(map.slot_cap == 16);
+    for (int i = 0; i < 10; ++i) {
+        assert_true(*(int *)basic_hashmap_find(&map, &i) == i);
+    }
+
+    // Reserving makes room without changing the contents
+    assert_true(basic_hashmap_reserve(&map, entry_count));
+    assert_true(map.slot_cap / 8 * 7 >= entry_count);
+    assert_true(map.elem_count == 10);
+
+    basic_hashmap_clear(&map);
+    assert_true(basic_hashmap_isempty(&map));
+    assert_true(basic_hashmap_next(&map, 0) == -1);
+
+    basic_hashmap_destroy(&map);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_hashmap_new),
+        cmocka_unit_test(test_hashmap_insert_erase),
+        cmocka_unit_test(test_hashmap_emplace),
+        cmocka_unit_test(test_hashmap_iterate_rehash),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,227 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "heap.h"
+
+enum { initial_cap = 2, elem_count = 200 };
+
+typedef struct {
+    int id;
+    uint64_t deadline;
+} timer;
+
+static int cmp_int_desc(void const *lhs, void const *rhs, void *ctx)
+{
+    (void) ctx;
+    int const a = *(int const *)lhs;
+    int const b = *(int const *)rhs;
+    return (a < b) - (a > b);
+}
+
+static basic_heap make_timer_heap(int arity)
+{
+    basic_heap_order order = BASIC_HEAP_BY_KEY(offsetof(timer, deadline));
+    order.arity = arity;
+
+    basic_heap heap = basic_heap_new(sizeof(timer), initial_cap, order);
+    if (basic_heap_isnull(&heap)) {
+        fail_msg("Failed to allocate basic_heap for testing");
+    }
+
+    return heap;
+}
+
+// A permutation of [0, elem_count) with no runs
+static uint64_t scrambled(int i)
+{
+    return (uint64_t)i * 73 % elem_count;
+}
+
+static void test_heap_new(void **state)
+{
+    (void) state;
+
+    basic_heap_order bad = BASIC_HEAP_BY_KEY(0);
+    bad.arity = 1;
+
+    expect_assert_failure(basic_heap_new(0, initial_cap, BASIC_HEAP_BY_KEY(0)));
+    expect_assert_failure(basic_heap_new(sizeof(int), 0, BASIC_HEAP_BY_KEY(0)));
+    expect_assert_failure(basic_heap_new(sizeof(int), initial_cap, bad));
+
+    basic_heap heap = make_timer_heap(BASIC_HEAP_ARITY);
+    assert_true(basic_heap_isinit(&heap));
+    assert_true(basic_heap_isempty(&heap));
+    expect_assert_failure(basic_heap_top(&heap));
+    expect_assert_failure(basic_heap_pop(&heap, NULL));
+
+    basic_heap_destroy(&heap);
+    assert_true(basic_heap_isnull(&heap));
+}
+
+static void test_heap_push_pop(void **state)
+{
+    (void) state;
+
+    // Every arity should produce the same order
+    for (int arity = 2; arity <= 8; ++arity) {
+        basic_heap heap = make_timer_heap(arity);
+
+        for (int i = 0; i < elem_count; ++i) {
+            timer t = {i, scrambled(i)};
+            assert_true(basic_heap_push(&heap, &t) == i);
+        }
+
+        for (int i = 0; i < elem_count; ++i) {
+            timer t;
+            basic_heap_pop(&heap, &t);
+            assert_true(t.deadline == (uint64_t)i);
+            assert_true(scrambled(t.id) == t.deadline);
+        }
+
+        assert_true(basic_heap_isempty(&heap));
+        basic_heap_destroy(&heap);
+    }
+}
+
+static void test_heap_push_growth(void **state)
+{
+    (void) state;
+
+    enum { push_count = 100000 };
+    basic_heap heap = make_timer_heap(BASIC_HEAP_ARITY);
+
+    // Pushes grow the storage geometrically, not one slot at a time
+    int reallocs = 0;
+    size_t elem_cap = heap.elems.elem_cap;
+    for (int i = 0; i < push_count; ++i) {
+        timer t = {i, (uint64_t)i};
+        assert_true(basic_heap_push(&heap, &t) == i);
+
+        if (heap.elems.elem_cap != elem_cap) {
+            assert_true(heap.elems.elem_cap >= 2 * elem_cap);
+            elem_cap = heap.elems.elem_cap;
+            ++reallocs;
+        }
+    }
+
+    assert_true(reallocs <= 17);
+    assert_true(heap.handle_of.elem_cap <= 2 * (size_t)push_count);
+    assert_true(heap.index_of.elem_cap <= 2 * (size_t)push_count);
+    basic_heap_destroy(&heap);
+}
+
+static void test_heap_handles(void **state)
+{
+    (void) state;
+
+    basic_heap heap = make_timer_heap(BASIC_HEAP_ARITY);
+    int handles[elem_count];
+
+    for (int i = 0; i < elem_count; ++i) {
+        timer t = {i, scrambled(i) + elem_count};
+        handles[i] = basic_heap_push(&heap, &t);
+    }
+
+    // Decrease the key of the last timer so that it comes first
+    timer t = {elem_count - 1, 0};
+    basic_heap_update(&heap, handles[elem_count - 1], &t);
+    assert_true(basic_heap_top_handle(&heap) == handles[elem_count - 1]);
+
+    // Increase it again so that it comes last
+    t.deadline = 3 * elem_count;
+    basic_heap_update(&heap, handles[elem_count - 1], &t);
+    assert_true(((timer const *)basic_heap_at_handle(
+                    &heap, handles[elem_count - 1]))->deadline == t.deadline);
+
+    // Cancel every even timer
+    for (int i = 0; i < elem_count; i += 2) {
+        basic_heap_erase(&heap, handles[i]);
+    }
+
+    expect_assert_failure(basic_heap_erase(&heap, handles[0]));
+    expect_assert_failure(basic_heap_update(&heap, elem_count, &t));
+
+    // Freed handles are reused
+    t.deadline = 0;
+    int const reused = basic_heap_push(&heap, &t);
+    assert_true(reused < elem_count && reused % 2 == 0);
+    basic_heap_pop(&heap, NULL);
+
+    uint64_t prev = 0;
+    int popped = 0;
+    while (!basic_heap_isempty(&heap)) {
+        basic_heap_pop(&heap, &t);
+        assert_true(t.id % 2 == 1);
+        assert_true(t.deadline >= prev);
+        prev = t.deadline;
+        ++popped;
+    }
+
+    assert_true(popped == elem_count / 2);
+    assert_true(t.id == elem_count - 1);
+
+    basic_heap_destroy(&heap);
+}
+
+static void test_heap_from_vector(void **state)
+{
+    (void) state;
+
+    basic_vector vector = basic_vector_new(sizeof(int), elem_count);
+    for (int i = 0; i < elem_count; ++i) {
+        int const value = (int)scrambled(i);
+        assert_true(basic_vector_insertback(&vector, (void *)&value));
+    }
+
+    basic_heap heap = basic_heap_from_vector(&vector,
+            BASIC_HEAP_BY_CMP(cmp_int_desc, NULL));
+    assert_true(basic_heap_isinit(&heap));
+    assert_true(basic_vector_isnull(&vector));
+
+    // The handle of each element is its original index
+    for (int i = 0; i < elem_count; ++i) {
+        assert_true(*(int const *)basic_heap_at_handle(&heap, i)
+                == (int)scrambled(i));
+    }
+
+    // Replacing the top with a smaller value sinks it to its place
+    int const low = -1;
+    basic_heap_replace_top(&heap, &low);
+    assert_true(*(int const *)basic_heap_top(&heap) == elem_count - 2);
+
+    for (int i = elem_count - 2; i >= 0; --i) {
+        int value;
+        basic_heap_pop(&heap, &value);
+        assert_true(value == i);
+    }
+
+    int value;
+    basic_heap_pop(&heap, &value);
+    assert_true(value == low);
+
+    basic_heap clone = basic_heap_clone(&heap);
+    assert_true(basic_heap_isempty(&clone));
+
+    basic_heap_destroy(&clone);
+    basic_heap_destroy(&heap);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_heap_new),
+        cmocka_unit_test(test_heap_push_pop),
+        cmocka_unit_test(test_heap_push_growth),
+        cmocka_unit_test(test_heap_handles),
+        cmocka_unit_test(test_heap_from_vector),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
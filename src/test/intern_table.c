@@ -0,0 +1,283 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "intern_table.h"
+
+enum { string_count = 2000, thread_count = 4 };
+
+typedef struct {
+    basic_intern_table *table;
+    pthread_barrier_t *start;
+    int thread;
+    int ids[string_count];
+    int failed;
+    int mismatched;
+} interner;
+
+typedef struct {
+    basic_intern_table *table;
+    atomic_bool *done;
+    int seen[string_count];
+    int mismatched;
+    int changed;
+} finder;
+
+static basic_intern_table make_intern_table(void)
+{
+    basic_intern_table table = basic_intern_table_new(1);
+    if (basic_intern_table_isnull(&table)) {
+        fail_msg("Failed to allocate basic_intern_table for testing");
+    }
+
+    return table;
+}
+
+static basic_span make_string(char *buf, size_t size, int i)
+{
+    int const written = snprintf(buf, size, "string %d", i);
+    return (basic_span){buf, (size_t)written};
+}
+
+static bool stored_as(
+        basic_intern_table const *table,
+        int id,
+        basic_span const *string)
+{
+    basic_span const stored = basic_intern_table_get(table, id);
+    return stored.size == string->size
+        && !memcmp(stored.ptr, string->ptr, string->size);
+}
+
+static void *intern_strings(void *arg)
+{
+    interner *const self = arg;
+    char buf[32];
+    pthread_barrier_wait(self->start);
+
+    // Half the threads run forwards and half backwards, so that each string
+    // is raced for by the threads walking in the same direction, and the
+    // two groups meet in the middle
+    for (int n = 0; n < string_count; ++n) {
+        int const i = self->thread % 2 ? string_count - 1 - n : n;
+        basic_span const string = make_string(buf, sizeof(buf), i);
+
+        int const id = basic_intern_table_intern(self->table, &string);
+        self->ids[i] = id;
+        if (id == -1) {
+            ++self->failed;
+        } else if (basic_intern_table_find(self->table, &string) != id
+                || !stored_as(self->table, id, &string)) {
+            ++self->mismatched;
+        }
+
+        sched_yield();
+    }
+
+    return NULL;
+}
+
+static void *find_strings(void *arg)
+{
+    finder *const self = arg;
+    char buf[32];
+
+    for (int i = 0; i < string_count; ++i) {
+        self->seen[i] = -1;
+    }
+
+    // Lookups race with the index being grown and replaced, and a string
+    // once found must keep its id
+    while (!atomic_load(self->done)) {
+        for (int i = 0; i < string_count; ++i) {
+            basic_span const string = make_string(buf, sizeof(buf), i);
+            int const id = basic_intern_table_find(self->table, &string);
+            if (id == -1) {
+                self->changed += self->seen[i] != -1;
+                continue;
+            }
+
+            self->mismatched += !stored_as(self->table, id, &string);
+            self->changed += self->seen[i] != -1 && self->seen[i] != id;
+            self->seen[i] = id;
+        }
+    }
+
+    return NULL;
+}
+
+static void test_intern_table_intern(void **state)
+{
+    (void) state;
+
+    expect_assert_failure(basic_intern_table_new(0));
+
+    basic_intern_table table = make_intern_table();
+    assert_true(basic_intern_table_count(&table) == 0);
+    expect_assert_failure(basic_intern_table_get(&table, 0));
+
+    // Embedded NULs are part of the string, and the empty string is one too
+    char const with_nul[] = {'a', '\0', 'b'};
+    basic_span const strings[] = {
+        {(void *)"alpha", 5},
+        {(void *)with_nul, sizeof(with_nul)},
+        {(void *)"a", 1},
+        BASIC_SPAN_NULL,
+    };
+    int const count = (int)(sizeof(strings) / sizeof(strings[0]));
+
+    for (int i = 0; i < count; ++i) {
+        assert_true(basic_intern_table_find(&table, &strings[i]) == -1);
+        assert_true(basic_intern_table_intern(&table, &strings[i]) == i);
+    }
+
+    // Interning again hands back the same ids without storing anything
+    for (int i = 0; i < count; ++i) {
+        char copy[8];
+        memcpy(copy, strings[i].ptr ? strings[i].ptr : "", strings[i].size);
+        basic_span const again = {copy, strings[i].size};
+        assert_true(basic_intern_table_intern(&table, &again) == i);
+        assert_true(basic_intern_table_find(&table, &again) == i);
+    }
+
+    assert_true(basic_intern_table_count(&table) == count);
+
+    for (int i = 0; i < count; ++i) {
+        basic_span const stored = basic_intern_table_get(&table, i);
+        assert_true(stored.size == strings[i].size);
+        assert_memory_equal(stored.ptr, strings[i].ptr ? strings[i].ptr : "",
+                stored.size);
+        assert_true(((char const *)stored.ptr)[stored.size] == '\0');
+    }
+
+    expect_assert_failure(basic_intern_table_get(&table, count));
+    basic_intern_table_destroy(&table);
+    assert_true(basic_intern_table_isnull(&table));
+}
+
+static void test_intern_table_grow(void **state)
+{
+    (void) state;
+
+    basic_intern_table table = make_intern_table();
+    char buf[32];
+
+    // Starting from one string, the index grows many times over
+    for (int i = 0; i < string_count; ++i) {
+        basic_span const string = make_string(buf, sizeof(buf), i);
+        assert_true(basic_intern_table_intern(&table, &string) == i);
+    }
+
+    // A string large enough to get a block of its own
+    static char large[64 * 1024];
+    memset(large, 'x', sizeof(large));
+    basic_span const large_string = {large, sizeof(large)};
+    assert_true(basic_intern_table_intern(&table, &large_string)
+            == string_count);
+
+    for (int i = 0; i < string_count; ++i) {
+        basic_span const string = make_string(buf, sizeof(buf), i);
+        assert_true(basic_intern_table_find(&table, &string) == i);
+        basic_span const stored = basic_intern_table_get(&table, i);
+        assert_true(stored.size == string.size);
+        assert_string_equal(stored.ptr, buf);
+    }
+
+    basic_span const stored = basic_intern_table_get(&table, string_count);
+    assert_true(stored.size == sizeof(large));
+    assert_memory_equal(stored.ptr, large, sizeof(large));
+
+    basic_span const absent = make_string(buf, sizeof(buf), string_count);
+    assert_true(basic_intern_table_find(&table, &absent) == -1);
+    basic_intern_table_destroy(&table);
+}
+
+static void test_intern_table_threads(void **state)
+{
+    (void) state;
+
+    // Starting from one string makes the index grow under the finders
+    basic_intern_table table = make_intern_table();
+
+    atomic_bool done;
+    atomic_init(&done, false);
+    static finder reader;
+    reader = (finder){.table = &table, .done = &done};
+    pthread_t reader_id;
+    assert_true(!pthread_create(&reader_id, NULL, find_strings, &reader));
+
+    pthread_barrier_t start;
+    assert_true(!pthread_barrier_init(&start, NULL, thread_count));
+
+    static interner interners[thread_count];
+    pthread_t interner_ids[thread_count];
+    for (int i = 0; i < thread_count; ++i) {
+        interners[i] = (interner){
+            .table = &table,
+            .start = &start,
+            .thread = i
+        };
+
+        assert_true(!pthread_create(&interner_ids[i],
+                    NULL,
+                    intern_strings,
+                    &interners[i]));
+    }
+
+    for (int i = 0; i < thread_count; ++i) {
+        pthread_join(interner_ids[i], NULL);
+        assert_true(interners[i].failed == 0);
+        assert_true(interners[i].mismatched == 0);
+    }
+
+    pthread_barrier_destroy(&start);
+
+    atomic_store(&done, true);
+    pthread_join(reader_id, NULL);
+    assert_true(reader.mismatched == 0);
+    assert_true(reader.changed == 0);
+
+    // Every thread got the same id for each string, and the ids are
+    // exactly 0 to string_count - 1
+    assert_true(basic_intern_table_count(&table) == string_count);
+
+    static bool taken[string_count];
+    char buf[32];
+    for (int i = 0; i < string_count; ++i) {
+        int const id = interners[0].ids[i];
+        assert_true(id >= 0 && id < string_count);
+        assert_false(taken[id]);
+        taken[id] = true;
+
+        for (int t = 1; t < thread_count; ++t) {
+            assert_true(interners[t].ids[i] == id);
+        }
+
+        basic_span const string = make_string(buf, sizeof(buf), i);
+        assert_true(basic_intern_table_find(&table, &string) == id);
+    }
+
+    basic_intern_table_destroy(&table);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_intern_table_intern),
+        cmocka_unit_test(test_intern_table_grow),
+        cmocka_unit_test(test_intern_table_threads),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
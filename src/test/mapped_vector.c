@@ -0,0 +1,139 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include "mapped_vector.h"
+
+enum { initial_cap = 4, elem_count = 100000 };
+
+#define PATH_TEMPLATE "/tmp/basic_mapped_vector_XXXXXX"
+
+static void make_file(char *path)
+{
+    int const fd = mkstemp(path);
+    if (fd < 0) {
+        fail_msg("Failed to create a file for testing");
+    }
+
+    close(fd);
+}
+
+static basic_mapped_vector open_vector(char const *path)
+{
+    basic_mapped_vector vector =
+        basic_mapped_vector_open(path, sizeof(int), initial_cap);
+    if (basic_mapped_vector_isnull(&vector)) {
+        fail_msg("Failed to open basic_mapped_vector for testing");
+    }
+
+    return vector;
+}
+
+static void test_mapped_vector_reopen(void **state)
+{
+    (void) state;
+
+    char path[] = PATH_TEMPLATE;
+    make_file(path);
+
+    expect_assert_failure(basic_mapped_vector_open(path, 0, initial_cap));
+    expect_assert_failure(basic_mapped_vector_open(path, sizeof(int), 0));
+
+    basic_mapped_vector vector = open_vector(path);
+    assert_true(basic_mapped_vector_isempty(&vector));
+    assert_true(vector.elem_cap == initial_cap);
+    expect_assert_failure(basic_mapped_vector_at(&vector, 0));
+    expect_assert_failure(basic_mapped_vector_removeback(&vector));
+
+    // Appending one at a time grows the file through several remaps
+    for (int i = 0; i < elem_count; ++i) {
+        assert_true(basic_mapped_vector_insertback(&vector, &i));
+    }
+
+    int const block[] = {-1, -2, -3};
+    assert_true(basic_mapped_vector_append(&vector, block, 3));
+    basic_mapped_vector_removeback(&vector);
+    assert_true(basic_mapped_vector_flush(&vector));
+    basic_mapped_vector_close(&vector);
+    assert_true(basic_mapped_vector_isnull(&vector));
+
+    // Reopening sees every element without rebuilding anything
+    vector = open_vector(path);
+    assert_true(basic_mapped_vector_count(&vector) == elem_count + 2);
+    for (int i = 0; i < elem_count; ++i) {
+        assert_true(*(int *)basic_mapped_vector_at(&vector, (size_t)i) == i);
+    }
+
+    assert_true(*(int *)basic_mapped_vector_at(&vector, elem_count + 1) == -2);
+
+    // Elements can be changed in place and survive the next reopen
+    *(int *)basic_mapped_vector_at(&vector, 0) = 42;
+    assert_true(basic_mapped_vector_reserve(&vector, 2 * elem_count));
+    assert_true(vector.elem_cap >= 2 * elem_count);
+    basic_mapped_vector_close(&vector);
+
+    vector = open_vector(path);
+    assert_true(*(int *)basic_mapped_vector_at(&vector, 0) == 42);
+    basic_mapped_vector_close(&vector);
+
+    // A file holding another element size is rejected
+    basic_mapped_vector other =
+        basic_mapped_vector_open(path, sizeof(double), initial_cap);
+    assert_true(basic_mapped_vector_isnull(&other));
+
+    unlink(path);
+}
+
+static void test_mapped_vector_corrupt(void **state)
+{
+    (void) state;
+
+    char path[] = PATH_TEMPLATE;
+    make_file(path);
+    basic_mapped_vector vector = open_vector(path);
+    for (int i = 0; i < initial_cap; ++i) {
+        assert_true(basic_mapped_vector_insertback(&vector, &i));
+    }
+
+    basic_mapped_vector_close(&vector);
+
+    // A changed count no longer matches the checksum
+    FILE *const file = fopen(path, "r+b");
+    assert_non_null(file);
+
+    uint64_t const count = initial_cap - 1;
+    assert_true(!fseek(file,
+                offsetof(basic_mapped_vector_header, elem_count),
+                SEEK_SET));
+    assert_true(fwrite(&count, sizeof(count), 1, file) == 1);
+    fclose(file);
+
+    vector = basic_mapped_vector_open(path, sizeof(int), initial_cap);
+    assert_true(basic_mapped_vector_isnull(&vector));
+
+    // Files too short to hold a header are rejected rather than mapped
+    assert_true(!truncate(path, BASIC_MAPPED_VECTOR_DATA_OFFSET / 2));
+    vector = basic_mapped_vector_open(path, sizeof(int), initial_cap);
+    assert_true(basic_mapped_vector_isnull(&vector));
+
+    unlink(path);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_mapped_vector_reopen),
+        cmocka_unit_test(test_mapped_vector_corrupt),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
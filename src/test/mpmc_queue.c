@@ -0,0 +1,202 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <limits.h>
+#include <pthread.h>
+
+#include "mpmc_queue.h"
+
+enum {
+    queue_cap = 6,
+    lap_count = 5,
+    thread_count = 2,
+    values_per_thread = 20000
+};
+
+static basic_mpmc_queue make_queue(void)
+{
+    basic_mpmc_queue queue = basic_mpmc_queue_new(sizeof(int), queue_cap);
+    if (basic_mpmc_queue_isnull(&queue)) {
+        fail_msg("Failed to allocate basic_mpmc_queue for testing");
+    }
+
+    return queue;
+}
+
+static void test_mpmc_queue_push_pop(void **state)
+{
+    (void) state;
+
+    expect_assert_failure(basic_mpmc_queue_new(0, queue_cap));
+    expect_assert_failure(basic_mpmc_queue_new(sizeof(int), 0));
+
+    // Capacities round up to a power of two no smaller than two
+    basic_mpmc_queue small = basic_mpmc_queue_new(sizeof(int), 1);
+    assert_true(small.elem_cap == 2);
+    basic_mpmc_queue_destroy(&small);
+
+    // A capacity that cannot be rounded up within an int is rejected
+    basic_mpmc_queue huge = basic_mpmc_queue_new(sizeof(int), INT_MAX);
+    assert_true(basic_mpmc_queue_isnull(&huge));
+
+    basic_mpmc_queue queue = make_queue();
+    assert_true(queue.elem_cap == 8);
+
+    // Popping an empty queue fails without blocking
+    int value = -1;
+    assert_false(basic_mpmc_queue_try_pop(&queue, &value));
+    assert_true(value == -1);
+
+    // Pushing past the capacity fails without overwriting
+    for (int i = 0; i < queue.elem_cap; ++i) {
+        assert_true(basic_mpmc_queue_try_push(&queue, &i));
+    }
+    assert_false(basic_mpmc_queue_try_push(&queue, &value));
+
+    for (int i = 0; i < queue.elem_cap; ++i) {
+        assert_true(basic_mpmc_queue_try_pop(&queue, &value));
+        assert_true(value == i);
+    }
+    assert_false(basic_mpmc_queue_try_pop(&queue, &value));
+
+    basic_mpmc_queue_destroy(&queue);
+    assert_true(basic_mpmc_queue_isnull(&queue));
+}
+
+static void test_mpmc_queue_batch(void **state)
+{
+    (void) state;
+
+    basic_mpmc_queue queue = make_queue();
+    int in[16];
+    int out[16];
+    for (int i = 0; i < 16; ++i) {
+        in[i] = i;
+    }
+
+    expect_assert_failure(basic_mpmc_queue_try_push_n(&queue, in, -1));
+    expect_assert_failure(basic_mpmc_queue_try_pop_n(&queue, out, -1));
+    assert_true(basic_mpmc_queue_try_push_n(&queue, in, 0) == 0);
+
+    // Only as many as there are free or full slots are moved
+    assert_true(basic_mpmc_queue_try_push_n(&queue, in, 6) == 6);
+    assert_true(basic_mpmc_queue_try_push_n(&queue, in + 6, 5) == 2);
+    assert_true(basic_mpmc_queue_try_push_n(&queue, in + 8, 1) == 0);
+
+    assert_true(basic_mpmc_queue_try_pop_n(&queue, out, 3) == 3);
+    assert_true(basic_mpmc_queue_try_pop_n(&queue, out + 3, 16) == 5);
+    assert_true(basic_mpmc_queue_try_pop_n(&queue, out, 1) == 0);
+    for (int i = 0; i < 8; ++i) {
+        assert_true(out[i] == i);
+    }
+
+    // Batches that straddle the end of the ring, lap after lap, come out in
+    // order
+    int next_in = 0;
+    int next_out = 0;
+    for (int lap = 0; lap < lap_count; ++lap) {
+        for (int pushed = 0; pushed < queue.elem_cap;) {
+            for (int i = 0; i < 3; ++i) {
+                in[i] = next_in + i;
+            }
+
+            int const count = basic_mpmc_queue_try_push_n(&queue, in, 3);
+            assert_true(count > 0);
+            next_in += count;
+            pushed += count;
+
+            int const popped = basic_mpmc_queue_try_pop_n(&queue, out, 2);
+            for (int i = 0; i < popped; ++i) {
+                assert_true(out[i] == next_out++);
+            }
+        }
+    }
+
+    int const left = basic_mpmc_queue_try_pop_n(&queue, out, 16);
+    for (int i = 0; i < left; ++i) {
+        assert_true(out[i] == next_out++);
+    }
+
+    assert_true(next_out == next_in);
+    assert_true(next_in >= lap_count * queue.elem_cap);
+    basic_mpmc_queue_destroy(&queue);
+}
+
+typedef struct {
+    basic_mpmc_queue *queue;
+    long long sum;
+} consumer;
+
+static void *produce(void *arg)
+{
+    basic_mpmc_queue *const queue = arg;
+    for (int i = 1; i <= values_per_thread; ++i) {
+        basic_mpmc_queue_push(queue, &i);
+    }
+
+    return NULL;
+}
+
+static void *consume(void *arg)
+{
+    consumer *const c = arg;
+    for (int i = 0; i < values_per_thread; ++i) {
+        int value;
+        basic_mpmc_queue_pop(c->queue, &value);
+        c->sum += value;
+    }
+
+    return NULL;
+}
+
+static void test_mpmc_queue_threads(void **state)
+{
+    (void) state;
+
+    basic_mpmc_queue queue = make_queue();
+    pthread_t producers[thread_count];
+    pthread_t consumer_ids[thread_count];
+    consumer consumers[thread_count];
+
+    for (int i = 0; i < thread_count; ++i) {
+        consumers[i] = (consumer){.queue = &queue};
+        assert_true(!pthread_create(&producers[i], NULL, produce, &queue));
+        assert_true(!pthread_create(&consumer_ids[i],
+                    NULL,
+                    consume,
+                    &consumers[i]));
+    }
+
+    // Every value pushed is popped exactly once
+    long long sum = 0;
+    for (int i = 0; i < thread_count; ++i) {
+        pthread_join(producers[i], NULL);
+        pthread_join(consumer_ids[i], NULL);
+        sum += consumers[i].sum;
+    }
+
+    long long const per_thread =
+        (long long)values_per_thread * (values_per_thread + 1) / 2;
+    assert_true(sum == thread_count * per_thread);
+
+    int value;
+    assert_false(basic_mpmc_queue_try_pop(&queue, &value));
+    basic_mpmc_queue_destroy(&queue);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_mpmc_queue_push_pop),
+        cmocka_unit_test(test_mpmc_queue_batch),
+        cmocka_unit_test(test_mpmc_queue_threads),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,150 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <string.h>
+
+#include "persistent_vector.h"
+
+// Enough elements for a tree three levels deep
+enum { elem_count = 40000, snapshot_count = 1000 };
+
+static int value_at(basic_persistent_vector const *vector, size_t index)
+{
+    return *(int const *)basic_persistent_vector_at(vector, index);
+}
+
+static basic_persistent_vector make_vector(int count)
+{
+    basic_persistent_vector vector = basic_persistent_vector_new(sizeof(int));
+    for (int i = 0; i < count; ++i) {
+        if (!basic_persistent_vector_pushback(&vector, &i)) {
+            fail_msg("Failed to build basic_persistent_vector for testing");
+        }
+    }
+
+    return vector;
+}
+
+static void test_persistent_vector_new(void **state)
+{
+    (void) state;
+
+    expect_assert_failure(basic_persistent_vector_new(0));
+
+    basic_persistent_vector vector = basic_persistent_vector_new(sizeof(int));
+    assert_true(basic_persistent_vector_isinit(&vector));
+    assert_true(basic_persistent_vector_isempty(&vector));
+    expect_assert_failure(basic_persistent_vector_at(&vector, 0));
+    expect_assert_failure(basic_persistent_vector_popback(&vector));
+
+    basic_persistent_vector_destroy(&vector);
+    assert_true(basic_persistent_vector_isnull(&vector));
+}
+
+static void test_persistent_vector_push_pop(void **state)
+{
+    (void) state;
+
+    basic_persistent_vector vector = make_vector(elem_count);
+    assert_true(vector.elem_count == elem_count);
+    assert_true(vector.shift == 3 * BASIC_PERSISTENT_VECTOR_BITS);
+
+    for (int i = 0; i < elem_count; ++i) {
+        assert_true(value_at(&vector, (size_t)i) == i);
+    }
+
+    expect_assert_failure(basic_persistent_vector_at(&vector, elem_count));
+
+    // Popping back down crosses every leaf and level boundary
+    for (int i = elem_count - 1; i >= 0; --i) {
+        assert_true(value_at(&vector, (size_t)i) == i);
+        assert_true(basic_persistent_vector_popback(&vector));
+    }
+
+    assert_true(basic_persistent_vector_isempty(&vector));
+    assert_true(vector.shift == BASIC_PERSISTENT_VECTOR_BITS);
+
+    basic_persistent_vector_destroy(&vector);
+}
+
+static void test_persistent_vector_set(void **state)
+{
+    (void) state;
+
+    basic_persistent_vector vector = make_vector(elem_count);
+
+    // Both tree and tail elements can be overwritten in place
+    for (int i = 0; i < elem_count; i += 7) {
+        int const value = -i;
+        assert_true(basic_persistent_vector_set(&vector, (size_t)i, &value));
+    }
+
+    for (int i = 0; i < elem_count; ++i) {
+        assert_true(value_at(&vector, (size_t)i) == (i % 7 ? i : -i));
+    }
+
+    basic_persistent_vector_destroy(&vector);
+}
+
+static void test_persistent_vector_snapshots(void **state)
+{
+    (void) state;
+
+    basic_persistent_vector base = make_vector(snapshot_count);
+    basic_persistent_vector snapshot = basic_persistent_vector_clone(&base);
+    assert_ptr_equal(snapshot.root, base.root);
+
+    // Changing the base must not show through the snapshot
+    int const value = -1;
+    assert_true(basic_persistent_vector_set(&base, 5, &value));
+    assert_true(basic_persistent_vector_set(&base, snapshot_count - 1, &value));
+    assert_true(basic_persistent_vector_popback(&base));
+    assert_true(basic_persistent_vector_popback(&base));
+    for (int i = 0; i < 100; ++i) {
+        assert_true(basic_persistent_vector_pushback(&base, &value));
+    }
+
+    assert_true(snapshot.elem_count == snapshot_count);
+    for (int i = 0; i < snapshot_count; ++i) {
+        assert_true(value_at(&snapshot, (size_t)i) == i);
+    }
+
+    assert_true(value_at(&base, 5) == -1);
+    assert_true(value_at(&base, snapshot_count - 2) == -1);
+
+    // Each version built with the with functions differs from its parent
+    // only where it was changed
+    basic_persistent_vector one = basic_persistent_vector_with(
+            &snapshot, 10, &value);
+    basic_persistent_vector two = basic_persistent_vector_with_pushback(
+            &one, &value);
+    assert_true(value_at(&snapshot, 10) == 10);
+    assert_true(value_at(&one, 10) == -1);
+    assert_true(one.elem_count == snapshot_count);
+    assert_true(two.elem_count == snapshot_count + 1);
+    assert_true(value_at(&two, snapshot_count) == -1);
+    assert_true(value_at(&two, 11) == 11);
+
+    // Versions can be released in any order
+    basic_persistent_vector_destroy(&snapshot);
+    basic_persistent_vector_destroy(&base);
+    basic_persistent_vector_destroy(&one);
+    assert_true(value_at(&two, 10) == -1);
+    basic_persistent_vector_destroy(&two);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_persistent_vector_new),
+        cmocka_unit_test(test_persistent_vector_push_pop),
+        cmocka_unit_test(test_persistent_vector_set),
+        cmocka_unit_test(test_persistent_vector_snapshots),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,306 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <limits.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdbool.h>
+
+#include "rcu_vector.h"
+
+enum {
+    reader_cap = 2,
+    elem_count = 100,
+    thread_count = 3,
+    version_count = 2000
+};
+
+// A reader holds each snapshot until the writer has published this many
+// more versions, so that the snapshot is retired while still in use
+enum { hold_publishes = 2 };
+
+typedef struct {
+    basic_rcu_vector *rcu;
+    atomic_int *published;
+    atomic_int *unheld;
+    atomic_bool *done;
+    int torn;
+    int backwards;
+    int held;
+} snapshot_reader;
+
+static basic_vector make_version(int first)
+{
+    basic_vector vector = basic_vector_new(sizeof(int), elem_count);
+    for (int i = 0; i < elem_count; ++i) {
+        int const value = first + i;
+        if (!basic_vector_insertback(&vector, (void *)&value)) {
+            fail_msg("Failed to build basic_vector for testing");
+        }
+    }
+
+    return vector;
+}
+
+static int first_of(basic_vector const *version)
+{
+    return *(int const *)version->data.data.ptr;
+}
+
+static bool version_intact(basic_vector const *version)
+{
+    if (version->elem_count != elem_count) {
+        return false;
+    }
+
+    int const *const elems = version->data.data.ptr;
+    for (int i = 0; i < elem_count; ++i) {
+        if (elems[i] != elems[0] + i) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+static void *read_snapshots(void *arg)
+{
+    snapshot_reader *const reader = arg;
+    int const slot = basic_rcu_vector_register(reader->rcu);
+    int last_first = 0;
+
+    while (!atomic_load(reader->done)) {
+        int const target = atomic_load(reader->published) + hold_publishes;
+        basic_vector const *const snapshot =
+            basic_rcu_vector_read_lock(reader->rcu, slot);
+
+        int const first = first_of(snapshot);
+        if (first < last_first) {
+            ++reader->backwards;
+        }
+
+        last_first = first;
+
+        // Keep checking the snapshot while newer versions replace it
+        bool intact = true;
+        do {
+            intact = intact && version_intact(snapshot);
+            sched_yield();
+        } while (atomic_load(reader->published) < target
+                && !atomic_load(reader->done));
+
+        if (!intact || first_of(snapshot) != first) {
+            ++reader->torn;
+        }
+
+        if (atomic_load(reader->published) >= target && !reader->held++) {
+            atomic_fetch_sub(reader->unheld, 1);
+        }
+
+        basic_rcu_vector_read_unlock(reader->rcu, slot);
+    }
+
+    basic_rcu_vector_unregister(reader->rcu, slot);
+    return NULL;
+}
+
+static basic_rcu_vector make_rcu(void)
+{
+    basic_vector initial = make_version(0);
+    basic_rcu_vector rcu = basic_rcu_vector_new(&initial, reader_cap);
+    if (basic_rcu_vector_isnull(&rcu)) {
+        fail_msg("Failed to allocate basic_rcu_vector for testing");
+    }
+
+    assert_true(basic_vector_isnull(&initial));
+    return rcu;
+}
+
+static void test_rcu_vector_new(void **state)
+{
+    (void) state;
+
+    basic_vector initial = make_version(0);
+    expect_assert_failure(basic_rcu_vector_new(NULL, reader_cap));
+    expect_assert_failure(basic_rcu_vector_new(&initial, 0));
+    basic_vector_destroy(&initial);
+
+    basic_rcu_vector rcu = make_rcu();
+    assert_true(basic_rcu_vector_isinit(&rcu));
+
+    // Slots run out after reader_cap registrations
+    assert_true(basic_rcu_vector_register(&rcu) == 0);
+    assert_true(basic_rcu_vector_register(&rcu) == 1);
+    assert_true(basic_rcu_vector_register(&rcu) == -1);
+    expect_assert_failure(basic_rcu_vector_read_lock(&rcu, reader_cap));
+
+    basic_rcu_vector_destroy(&rcu);
+    assert_true(basic_rcu_vector_isnull(&rcu));
+}
+
+static void test_rcu_vector_unregister(void **state)
+{
+    (void) state;
+
+    basic_rcu_vector rcu = make_rcu();
+    int const first = basic_rcu_vector_register(&rcu);
+    int const second = basic_rcu_vector_register(&rcu);
+    assert_true(basic_rcu_vector_register(&rcu) == -1);
+
+    // A slot cannot be released from inside a read section
+    basic_rcu_vector_read_lock(&rcu, first);
+    expect_assert_failure(basic_rcu_vector_unregister(&rcu, first));
+    basic_rcu_vector_read_unlock(&rcu, first);
+
+    // Released slots are handed out again and cannot be read on until then
+    basic_rcu_vector_unregister(&rcu, first);
+    expect_assert_failure(basic_rcu_vector_read_lock(&rcu, first));
+    expect_assert_failure(basic_rcu_vector_unregister(&rcu, first));
+    assert_true(basic_rcu_vector_register(&rcu) == first);
+    assert_true(basic_rcu_vector_register(&rcu) == -1);
+
+    basic_rcu_vector_unregister(&rcu, second);
+    basic_rcu_vector_unregister(&rcu, first);
+    assert_true(basic_rcu_vector_register(&rcu) == 0);
+    assert_true(basic_rcu_vector_register(&rcu) == 1);
+
+    // A reader that registers while another holds an old version does not
+    // let it be reclaimed
+    basic_rcu_vector_unregister(&rcu, second);
+    basic_vector const *const old = basic_rcu_vector_read_lock(&rcu, first);
+    basic_vector version = make_version(1000);
+    assert_true(basic_rcu_vector_publish(&rcu, &version));
+
+    int const late = basic_rcu_vector_register(&rcu);
+    assert_true(late == second);
+    basic_vector const *const current = basic_rcu_vector_read_lock(&rcu,
+            late);
+    assert_true(first_of(current) == 1000);
+    assert_true(basic_rcu_vector_reclaim(&rcu) == 1);
+    assert_true(first_of(old) == 0);
+
+    basic_rcu_vector_read_unlock(&rcu, late);
+    basic_rcu_vector_read_unlock(&rcu, first);
+    assert_true(basic_rcu_vector_reclaim(&rcu) == 0);
+
+    basic_rcu_vector_destroy(&rcu);
+}
+
+static void test_rcu_vector_reclaim(void **state)
+{
+    (void) state;
+
+    basic_rcu_vector rcu = make_rcu();
+    int const old_reader = basic_rcu_vector_register(&rcu);
+    int const new_reader = basic_rcu_vector_register(&rcu);
+
+    basic_vector const *const old = basic_rcu_vector_read_lock(&rcu,
+            old_reader);
+    assert_true(first_of(old) == 0);
+    expect_assert_failure(basic_rcu_vector_read_lock(&rcu, old_reader));
+
+    // A version stays readable while a read section that saw it is open
+    basic_vector version = make_version(1000);
+    assert_true(basic_rcu_vector_publish(&rcu, &version));
+    assert_true(basic_vector_isnull(&version));
+    assert_true(basic_rcu_vector_reclaim(&rcu) == 1);
+
+    basic_vector const *const current = basic_rcu_vector_read_lock(&rcu,
+            new_reader);
+    assert_true(first_of(current) == 1000);
+    assert_true(first_of(old) == 0);
+
+    // Readers of a newer version do not hold back older ones
+    basic_rcu_vector_read_unlock(&rcu, old_reader);
+    assert_true(basic_rcu_vector_reclaim(&rcu) == 0);
+
+    version = make_version(2000);
+    assert_true(basic_rcu_vector_publish(&rcu, &version));
+    assert_true(basic_rcu_vector_reclaim(&rcu) == 1);
+    assert_true(first_of(current) == 1000);
+
+    basic_rcu_vector_read_unlock(&rcu, new_reader);
+    basic_rcu_vector_synchronize(&rcu);
+    assert_true(basic_rcu_vector_reclaim(&rcu) == 0);
+
+    basic_vector const *const latest = basic_rcu_vector_read_lock(&rcu,
+            old_reader);
+    assert_true(first_of(latest) == 2000);
+    basic_rcu_vector_read_unlock(&rcu, old_reader);
+
+    basic_rcu_vector_destroy(&rcu);
+}
+
+static void test_rcu_vector_threads(void **state)
+{
+    (void) state;
+
+    basic_vector initial = make_version(0);
+    basic_rcu_vector rcu = basic_rcu_vector_new(&initial, thread_count);
+    assert_true(basic_rcu_vector_isinit(&rcu));
+
+    atomic_int published;
+    atomic_int unheld;
+    atomic_bool done;
+    atomic_init(&published, 0);
+    atomic_init(&unheld, thread_count);
+    atomic_init(&done, false);
+
+    snapshot_reader readers[thread_count];
+    pthread_t reader_ids[thread_count];
+    for (int i = 0; i < thread_count; ++i) {
+        readers[i] = (snapshot_reader){
+            .rcu = &rcu,
+            .published = &published,
+            .unheld = &unheld,
+            .done = &done
+        };
+
+        assert_true(!pthread_create(&reader_ids[i],
+                    NULL,
+                    read_snapshots,
+                    &readers[i]));
+    }
+
+    // Publish and reclaim until every reader has held a snapshot across
+    // several publishes, and for at least version_count versions
+    for (int k = 1; k <= version_count || atomic_load(&unheld) > 0; ++k) {
+        assert_true(k < INT_MAX / elem_count);
+
+        basic_vector version = make_version(k * elem_count);
+        assert_true(basic_rcu_vector_publish(&rcu, &version));
+        atomic_store(&published, k);
+        basic_rcu_vector_reclaim(&rcu);
+    }
+
+    atomic_store(&done, true);
+    for (int i = 0; i < thread_count; ++i) {
+        pthread_join(reader_ids[i], NULL);
+        assert_true(readers[i].torn == 0);
+        assert_true(readers[i].backwards == 0);
+        assert_true(readers[i].held > 0);
+    }
+
+    // With every reader gone, nothing is left to reclaim
+    assert_true(basic_rcu_vector_reclaim(&rcu) == 0);
+
+    basic_rcu_vector_destroy(&rcu);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_rcu_vector_new),
+        cmocka_unit_test(test_rcu_vector_unregister),
+        cmocka_unit_test(test_rcu_vector_reclaim),
+        cmocka_unit_test(test_rcu_vector_threads),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
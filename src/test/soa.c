@@ -0,0 +1,268 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "soa.h"
+
+enum { initial_cap = 2, record_count = 16 };
+
+typedef struct {
+    int id;
+    double value;
+    char tag;
+} record;
+
+static size_t const field_sizes[] = {
+    sizeof(int),
+    sizeof(double),
+    sizeof(char)
+};
+
+enum { field_count = sizeof field_sizes / sizeof field_sizes[0] };
+
+static basic_soa make_soa(void)
+{
+    basic_soa soa = basic_soa_new(field_sizes, field_count, initial_cap);
+    if (basic_soa_isnull(&soa)) {
+        fail_msg("Failed to allocate basic_soa for testing");
+    }
+
+    return soa;
+}
+
+static bool insert_record(basic_soa *soa, size_t index, record const *rec)
+{
+    void const *const fields[field_count] = {&rec->id, &rec->value, &rec->tag};
+    return basic_soa_insert(soa, index, fields);
+}
+
+static void assert_record_at(
+        basic_soa const *soa,
+        size_t index,
+        record const *rec)
+{
+    assert_memory_equal(basic_soa_at_c(soa, index, 0), &rec->id, sizeof rec->id);
+    assert_memory_equal(basic_soa_at_c(soa, index, 1),
+            &rec->value,
+            sizeof rec->value);
+    assert_memory_equal(basic_soa_at_c(soa, index, 2),
+            &rec->tag,
+            sizeof rec->tag);
+}
+
+static void test_soa_new(void **state)
+{
+    (void) state;
+
+    size_t const bad_sizes[] = {sizeof(int), 0};
+
+    // Passing NULL field sizes, a zero field count or capacity,
+    // or a zero field size should assert
+    expect_assert_failure(basic_soa_new(NULL, field_count, initial_cap));
+    expect_assert_failure(basic_soa_new(field_sizes, 0, initial_cap));
+    expect_assert_failure(basic_soa_new(field_sizes, field_count, 0));
+    expect_assert_failure(basic_soa_new(bad_sizes, 2, initial_cap));
+
+    // A new basic_soa should be initialised and empty, with one column
+    // per field of the requested size
+    basic_soa soa = make_soa();
+    assert_true(basic_soa_isinit(&soa));
+    assert_true(basic_soa_isempty(&soa));
+    assert_true(soa.field_count == field_count);
+    assert_true(soa.elem_cap == initial_cap);
+
+    for (size_t field = 0; field < field_count; ++field) {
+        assert_true(basic_soa_field_size(&soa, field) == field_sizes[field]);
+    }
+
+    basic_soa_destroy(&soa);
+    assert_true(basic_soa_isnull(&soa));
+}
+
+static void test_soa_insert(void **state)
+{
+    (void) state;
+
+    basic_soa soa = make_soa();
+    record const first = {1, 1.5, 'a'};
+    record const middle = {2, 2.5, 'b'};
+    record const last = {3, 3.5, 'c'};
+
+    // Inserting out of range should assert
+    void const *const fields[field_count] = {&first.id, &first.value, &first.tag};
+    expect_assert_failure(basic_soa_insert(&soa, SIZE_MAX, fields));
+    expect_assert_failure(basic_soa_insert(&soa, 1, fields));
+
+    // Inserting at the back, the front, and the middle should keep every
+    // column in sync, growing past the initial capacity as needed
+    assert_true(insert_record(&soa, 0, &last));
+    assert_true(insert_record(&soa, 0, &first));
+    assert_true(insert_record(&soa, 1, &middle));
+    assert_true(soa.elem_count == 3);
+    assert_true(soa.elem_cap >= 3);
+
+    assert_record_at(&soa, 0, &first);
+    assert_record_at(&soa, 1, &middle);
+    assert_record_at(&soa, 2, &last);
+
+    basic_soa_destroy(&soa);
+}
+
+static void test_soa_growth(void **state)
+{
+    (void) state;
+
+    basic_soa soa = make_soa();
+
+    // A fixed policy needs a positive increment
+    expect_assert_failure(basic_soa_set_growth(&soa, BASIC_GROWTH_FIXED(0)));
+
+    // By default every column doubles when the basic_soa is full
+    record const rec = {7, 7.5, 'g'};
+    for (int i = 0; i <= initial_cap; ++i) {
+        assert_true(insert_record(&soa, 0, &rec));
+    }
+
+    assert_true(soa.elem_cap == initial_cap * 2);
+
+    // A fixed policy adds its increment to every column at once
+    basic_soa_set_growth(&soa, BASIC_GROWTH_FIXED(3));
+    while (soa.elem_count < soa.elem_cap) {
+        assert_true(insert_record(&soa, 0, &rec));
+    }
+
+    assert_true(insert_record(&soa, 0, &rec));
+    assert_true(soa.elem_cap == initial_cap * 2 + 3);
+
+    for (size_t field = 0; field < field_count; ++field) {
+        basic_array const *column = basic_array_at_c(&soa.columns, field);
+        assert_true(basic_array_cap(column) == soa.elem_cap);
+    }
+
+    for (size_t i = 0; i < soa.elem_count; ++i) {
+        assert_record_at(&soa, i, &rec);
+    }
+
+    // A clone keeps the policy
+    basic_soa clone = basic_soa_clone(&soa);
+    assert_true(clone.growth.kind == basic_growth_fixed);
+    assert_true(clone.growth.increment == 3);
+
+    basic_soa_destroy(&clone);
+    basic_soa_destroy(&soa);
+}
+
+static void test_soa_remove(void **state)
+{
+    (void) state;
+
+    basic_soa soa = make_soa();
+    record records[record_count];
+    for (int i = 0; i < record_count; ++i) {
+        records[i] = (record){i, i * 0.5, (char)('a' + i)};
+        assert_true(basic_soa_insertback(&soa, (void const *const[]){
+                    &records[i].id, &records[i].value, &records[i].tag}));
+    }
+
+    // Removing out of range should assert
+    expect_assert_failure(basic_soa_remove(&soa, SIZE_MAX));
+    expect_assert_failure(basic_soa_remove(&soa, record_count));
+
+    // Removing from the middle, front and back should remove the whole
+    // record from every column
+    basic_soa_remove(&soa, 5);
+    basic_soa_removefront(&soa);
+    basic_soa_removeback(&soa);
+    assert_true(soa.elem_count == record_count - 3);
+
+    int expected = 1;
+    for (size_t i = 0; i < soa.elem_count; ++i, ++expected) {
+        if (expected == 5) {
+            ++expected;
+        }
+
+        assert_record_at(&soa, i, &records[expected]);
+    }
+
+    basic_soa_destroy(&soa);
+}
+
+static void test_soa_column(void **state)
+{
+    (void) state;
+
+    basic_soa soa = make_soa();
+
+    // An empty basic_soa has null column spans, and an invalid field
+    // should assert
+    basic_span empty = basic_soa_column(&soa, 0);
+    assert_true(basic_span_isnull(&empty));
+    expect_assert_failure(basic_soa_column(&soa, field_count));
+
+    for (int i = 0; i < record_count; ++i) {
+        record const rec = {i, i * 2.0, 'x'};
+        assert_true(insert_record(&soa, i, &rec));
+    }
+
+    // A column span should cover exactly elem_count contiguous values
+    basic_span ids = basic_soa_column(&soa, 0);
+    assert_true(ids.size == record_count * sizeof(int));
+
+    int const *id = ids.ptr;
+    for (int i = 0; i < record_count; ++i) {
+        assert_true(id[i] == i);
+    }
+
+    basic_soa_destroy(&soa);
+}
+
+static void test_soa_clone(void **state)
+{
+    (void) state;
+
+    basic_soa soa = make_soa();
+    for (int i = 0; i < record_count; ++i) {
+        record const rec = {i, -i * 1.0, 'z'};
+        assert_true(insert_record(&soa, i, &rec));
+    }
+
+    // Cloning a null basic_soa gives a null basic_soa
+    basic_soa null_clone = basic_soa_clone(&BASIC_SOA_NULL);
+    assert_true(basic_soa_isnull(&null_clone));
+
+    // A clone has equal shape and bytewise-equal but distinct columns
+    basic_soa clone = basic_soa_clone(&soa);
+    assert_true(basic_soa_isinit(&clone));
+    assert_true(clone.field_count == soa.field_count);
+    assert_true(clone.elem_count == soa.elem_count);
+
+    for (size_t field = 0; field < field_count; ++field) {
+        basic_span lhs = basic_soa_column(&soa, field);
+        basic_span rhs = basic_soa_column(&clone, field);
+        assert_true(lhs.ptr != rhs.ptr);
+        assert_true(basic_span_equal(&lhs, &rhs));
+    }
+
+    basic_soa_destroy(&clone);
+    basic_soa_destroy(&soa);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_soa_new),
+        cmocka_unit_test(test_soa_insert),
+        cmocka_unit_test(test_soa_growth),
+        cmocka_unit_test(test_soa_remove),
+        cmocka_unit_test(test_soa_column),
+        cmocka_unit_test(test_soa_clone),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,104 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <limits.h>
+
+#include "spsc_queue.h"
+
+enum { queue_cap = 6, batch_size = 5 };
+
+static basic_spsc_queue make_queue(void)
+{
+    basic_spsc_queue queue = basic_spsc_queue_new(sizeof(int), queue_cap);
+    if (basic_spsc_queue_isnull(&queue)) {
+        fail_msg("Failed to allocate basic_spsc_queue for testing");
+    }
+
+    return queue;
+}
+
+static void test_spsc_queue_push_pop(void **state)
+{
+    (void) state;
+
+    expect_assert_failure(basic_spsc_queue_new(0, queue_cap));
+    expect_assert_failure(basic_spsc_queue_new(sizeof(int), 0));
+
+    // A capacity that cannot be rounded up within an int is rejected
+    basic_spsc_queue huge = basic_spsc_queue_new(sizeof(int), INT_MAX);
+    assert_true(basic_spsc_queue_isnull(&huge));
+
+    basic_spsc_queue queue = make_queue();
+    assert_true(queue.elem_cap == 8);
+
+    // Popping an empty queue fails without blocking
+    int value = 0;
+    assert_false(basic_spsc_queue_pop(&queue, &value));
+
+    // Pushing past the capacity fails without overwriting
+    for (int i = 0; i < queue.elem_cap; ++i) {
+        assert_true(basic_spsc_queue_push(&queue, &i));
+    }
+    assert_false(basic_spsc_queue_push(&queue, &value));
+
+    for (int i = 0; i < queue.elem_cap; ++i) {
+        assert_true(basic_spsc_queue_pop(&queue, &value));
+        assert_true(value == i);
+    }
+    assert_false(basic_spsc_queue_pop(&queue, &value));
+
+    basic_spsc_queue_destroy(&queue);
+    assert_true(basic_spsc_queue_isnull(&queue));
+}
+
+static void test_spsc_queue_batch(void **state)
+{
+    (void) state;
+
+    basic_spsc_queue queue = make_queue();
+    int in[batch_size];
+    int out[batch_size];
+    int next_in = 0;
+    int next_out = 0;
+
+    expect_assert_failure(basic_spsc_queue_push_n(&queue, in, -1));
+
+    // Batches of five through an eight slot ring wrap on most rounds
+    for (int round = 0; round < 20; ++round) {
+        for (int i = 0; i < batch_size; ++i) {
+            in[i] = next_in++;
+        }
+
+        assert_true(basic_spsc_queue_push_n(&queue, in, batch_size)
+                == batch_size);
+        assert_true(basic_spsc_queue_pop_n(&queue, out, batch_size)
+                == batch_size);
+
+        for (int i = 0; i < batch_size; ++i) {
+            assert_true(out[i] == next_out++);
+        }
+    }
+
+    // Batches are truncated to the room or elements available
+    assert_true(basic_spsc_queue_push_n(&queue, in, batch_size) == batch_size);
+    assert_true(basic_spsc_queue_push_n(&queue, in, batch_size) == 3);
+    assert_true(basic_spsc_queue_pop_n(&queue, out, batch_size) == batch_size);
+    assert_true(basic_spsc_queue_pop_n(&queue, out, batch_size) == 3);
+    assert_true(basic_spsc_queue_pop_n(&queue, out, batch_size) == 0);
+
+    basic_spsc_queue_destroy(&queue);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_spsc_queue_push_pop),
+        cmocka_unit_test(test_spsc_queue_batch),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,225 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdint.h>
+
+#include "stable_vector.h"
+
+// Four elements per chunk, so that a few dozen span many chunks
+enum { chunk_cap = 3, elem_count = 50 };
+
+static basic_stable_vector make_stable_vector(void)
+{
+    basic_stable_vector vector = basic_stable_vector_new(sizeof(int),
+            chunk_cap);
+    if (basic_stable_vector_isnull(&vector)) {
+        fail_msg("Failed to allocate basic_stable_vector for testing");
+    }
+
+    return vector;
+}
+
+static void fill(basic_stable_vector *vector, int count)
+{
+    for (int i = 0; i < count; ++i) {
+        assert_true(basic_stable_vector_pushback(vector, &i));
+    }
+}
+
+static void test_stable_vector_new(void **state)
+{
+    (void) state;
+
+    expect_assert_failure(basic_stable_vector_new(0, chunk_cap));
+    expect_assert_failure(basic_stable_vector_new(sizeof(int), 0));
+
+    // Chunk capacities past 2^30 still round up, and ones that cannot be
+    // rounded up within a size_t are rejected
+    basic_stable_vector large = basic_stable_vector_new(1,
+            ((size_t)1 << 30) + 1);
+    assert_true(large.chunk_shift == 31);
+    basic_stable_vector_destroy(&large);
+
+    basic_stable_vector huge = basic_stable_vector_new(1, SIZE_MAX);
+    assert_true(basic_stable_vector_isnull(&huge));
+
+    basic_stable_vector vector = make_stable_vector();
+    assert_true(basic_stable_vector_isempty(&vector));
+    assert_true(vector.chunk_shift == 2);
+
+    // No chunk exists until the first element
+    assert_true(vector.chunks.elem_count == 0);
+    assert_true(basic_stable_vector_chunk_count(&vector) == 0);
+    expect_assert_failure(basic_stable_vector_at(&vector, 0));
+    expect_assert_failure(basic_stable_vector_chunk(&vector, 0));
+    expect_assert_failure(basic_stable_vector_popback(&vector));
+
+    basic_stable_vector_destroy(&vector);
+    assert_true(basic_stable_vector_isnull(&vector));
+
+    // Destroying a null basic_stable_vector does nothing
+    basic_stable_vector_destroy(&vector);
+    assert_true(basic_stable_vector_isnull(&vector));
+}
+
+static void test_stable_vector_growth(void **state)
+{
+    (void) state;
+
+    basic_stable_vector vector = make_stable_vector();
+    int *pointers[elem_count];
+
+    // Pointers taken along the way stay valid as chunks are added and the
+    // directory itself is reallocated
+    for (int i = 0; i < elem_count; ++i) {
+        int *const slot = basic_stable_vector_emplace_back(&vector);
+        assert_non_null(slot);
+        *slot = i;
+        pointers[i] = slot;
+    }
+
+    assert_true(vector.elem_count == elem_count);
+    assert_true(basic_stable_vector_chunk_count(&vector)
+            == (elem_count + 3) / 4);
+
+    for (int i = 0; i < elem_count; ++i) {
+        assert_ptr_equal(basic_stable_vector_at(&vector, (size_t)i),
+                pointers[i]);
+        assert_true(*(int const *)basic_stable_vector_at_c(&vector,
+                    (size_t)i) == i);
+    }
+
+    expect_assert_failure(basic_stable_vector_at(&vector, elem_count));
+    expect_assert_failure(basic_stable_vector_at(&vector, -1));
+
+    // Every chunk but the last is full, and the chunks cover the elements in
+    // order
+    size_t const chunk_count = basic_stable_vector_chunk_count(&vector);
+    int next = 0;
+    for (size_t chunk = 0; chunk < chunk_count; ++chunk) {
+        basic_span const span = basic_stable_vector_chunk(&vector, chunk);
+        size_t const count = span.size / sizeof(int);
+        assert_true(count == (chunk < chunk_count - 1 ? 4 : elem_count % 4));
+
+        int const *const elems = span.ptr;
+        for (size_t i = 0; i < count; ++i) {
+            assert_true(elems[i] == next++);
+        }
+    }
+
+    assert_true(next == elem_count);
+    expect_assert_failure(basic_stable_vector_chunk(&vector, chunk_count));
+    basic_stable_vector_destroy(&vector);
+}
+
+static void test_stable_vector_truncate(void **state)
+{
+    (void) state;
+
+    basic_stable_vector vector = make_stable_vector();
+    fill(&vector, elem_count);
+    int *const kept = basic_stable_vector_at(&vector, 9);
+
+    expect_assert_failure(basic_stable_vector_truncate(&vector,
+                elem_count + 1));
+    expect_assert_failure(basic_stable_vector_truncate(&vector, -1));
+
+    // Chunks past the last element are freed, except for one spare
+    basic_stable_vector_truncate(&vector, 10);
+    assert_true(vector.elem_count == 10);
+    assert_true(basic_stable_vector_chunk_count(&vector) == 3);
+    assert_true(vector.chunks.elem_count == 4);
+    assert_ptr_equal(basic_stable_vector_at(&vector, 9), kept);
+
+    // Popping across a chunk boundary keeps the emptied chunk as the spare
+    basic_stable_vector_popback(&vector);
+    basic_stable_vector_popback(&vector);
+    assert_true(vector.elem_count == 8);
+    assert_true(basic_stable_vector_chunk_count(&vector) == 2);
+    assert_true(vector.chunks.elem_count == 3);
+
+    // and pushing back into it does not allocate
+    basic_array const *const spare = basic_vector_at_c(&vector.chunks, 2);
+    void const *const spare_data = spare->data.ptr;
+    fill(&vector, 1);
+    assert_ptr_equal(basic_stable_vector_at(&vector, 8), spare_data);
+
+    basic_stable_vector_truncate(&vector, 0);
+    assert_true(basic_stable_vector_isempty(&vector));
+    assert_true(vector.chunks.elem_count == 1);
+    basic_stable_vector_destroy(&vector);
+}
+
+static void test_stable_vector_shrink_to_fit(void **state)
+{
+    (void) state;
+
+    basic_stable_vector vector = make_stable_vector();
+    fill(&vector, elem_count);
+    basic_stable_vector_truncate(&vector, 6);
+    assert_true(vector.chunks.elem_count == 3);
+
+    // The spare goes, and so does the directory's unused capacity
+    assert_true(basic_stable_vector_shrink_to_fit(&vector));
+    assert_true(vector.chunks.elem_count == 2);
+    assert_true(vector.chunks.elem_cap == 2);
+    for (size_t i = 0; i < 6; ++i) {
+        assert_true(*(int *)basic_stable_vector_at(&vector, i) == (int)i);
+    }
+
+    // Growing again after shrinking works as before
+    fill(&vector, elem_count);
+    assert_true(vector.elem_count == 6 + elem_count);
+    assert_true(*(int *)basic_stable_vector_at(&vector, 6) == 0);
+    basic_stable_vector_destroy(&vector);
+}
+
+static void test_stable_vector_clone_move(void **state)
+{
+    (void) state;
+
+    basic_stable_vector vector = make_stable_vector();
+    fill(&vector, elem_count);
+    basic_stable_vector_truncate(&vector, elem_count - 4);
+
+    // The clone holds only the chunks with elements, not the spare
+    basic_stable_vector clone = basic_stable_vector_clone(&vector);
+    assert_true(basic_stable_vector_isinit(&clone));
+    assert_true(clone.elem_count == vector.elem_count);
+    assert_true(clone.chunks.elem_count
+            == basic_stable_vector_chunk_count(&vector));
+    for (size_t i = 0; i < clone.elem_count; ++i) {
+        assert_true(*(int *)basic_stable_vector_at(&clone, i) == (int)i);
+        assert_ptr_not_equal(basic_stable_vector_at(&clone, i),
+                basic_stable_vector_at(&vector, i));
+    }
+
+    int *const first = basic_stable_vector_at(&vector, 0);
+    basic_stable_vector moved = basic_stable_vector_move(&vector);
+    assert_true(basic_stable_vector_isnull(&vector));
+    assert_ptr_equal(basic_stable_vector_at(&moved, 0), first);
+    expect_assert_failure(basic_stable_vector_move(&vector));
+
+    basic_stable_vector null_clone = basic_stable_vector_clone(&vector);
+    assert_true(basic_stable_vector_isnull(&null_clone));
+
+    basic_stable_vector_destroy(&moved);
+    basic_stable_vector_destroy(&clone);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_stable_vector_new),
+        cmocka_unit_test(test_stable_vector_growth),
+        cmocka_unit_test(test_stable_vector_truncate),
+        cmocka_unit_test(test_stable_vector_shrink_to_fit),
+        cmocka_unit_test(test_stable_vector_clone_move),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
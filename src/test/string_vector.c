@@ -0,0 +1,372 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "string_vector.h"
+
+// Chunks small enough that most strings span several of them
+enum { chunk_size = 4, chunk_cap = 2, string_count = 500 };
+
+static void make_string(char *buf, size_t size, int i)
+{
+    // Lengths cycle through 0..10 so that strings fill chunks unevenly
+    int const len = i % 11;
+    int const written = snprintf(buf, size, "%d", i);
+    for (int j = written; j < len; ++j) {
+        buf[j] = 'a' + j;
+    }
+
+    buf[len > written ? len : written] = '\0';
+}
+
+static basic_string_vector make_string_vector(void)
+{
+    basic_string_vector string_vector =
+        basic_string_vector_new(chunk_size, chunk_cap);
+    if (basic_string_vector_isnull(&string_vector)) {
+        fail_msg("Failed to allocate basic_string_vector for testing");
+    }
+
+    return string_vector;
+}
+
+static void test_string_vector_insertback(void **state)
+{
+    (void) state;
+
+    basic_string_vector string_vector = make_string_vector();
+    char buf[32];
+
+    expect_assert_failure(basic_string_vector_at(&string_vector, 0));
+
+    for (int i = 0; i < string_count; ++i) {
+        make_string(buf, sizeof(buf), i);
+        assert_true(basic_string_vector_insertback(&string_vector, buf));
+    }
+
+    assert_true(string_vector.string_count == string_count);
+    for (int i = 0; i < string_count; ++i) {
+        make_string(buf, sizeof(buf), i);
+        assert_string_equal(basic_string_vector_at(&string_vector, (size_t)i),
+                buf);
+    }
+
+    make_string(buf, sizeof(buf), string_count - 1);
+    assert_string_equal(basic_string_vector_back(&string_vector), buf);
+
+    basic_string_vector clone = basic_string_vector_clone(&string_vector);
+    basic_string_vector_destroy(&string_vector);
+    assert_true(basic_string_vector_isnull(&string_vector));
+    assert_string_equal(basic_string_vector_back(&clone), buf);
+    basic_string_vector_destroy(&clone);
+}
+
+static void test_string_vector_reserve(void **state)
+{
+    (void) state;
+
+    basic_string_vector string_vector = make_string_vector();
+    char buf[32];
+
+    size_t chunks = 0;
+    for (int i = 0; i < string_count; ++i) {
+        make_string(buf, sizeof(buf), i);
+        chunks += strlen(buf) / chunk_size + 1;
+    }
+
+    // Reserving both the chunks and the offsets up front means appending
+    // the strings moves neither
+    assert_true(basic_string_vector_reserve(&string_vector,
+                chunks,
+                string_count));
+    assert_true(basic_array_cap(&string_vector.chunk_data) == chunks);
+    assert_true(string_vector.string_offsets.elem_cap == string_count);
+
+    void const *const chunk_ptr = string_vector.chunk_data.data.ptr;
+    void const *const offset_ptr = string_vector.string_offsets.data.data.ptr;
+    for (int i = 0; i < string_count; ++i) {
+        make_string(buf, sizeof(buf), i);
+        assert_true(basic_string_vector_insertback(&string_vector, buf));
+    }
+
+    assert_ptr_equal(string_vector.chunk_data.data.ptr, chunk_ptr);
+    assert_ptr_equal(string_vector.string_offsets.data.data.ptr, offset_ptr);
+    assert_true(string_vector.chunk_count == chunks);
+
+    // Reserving less than is held changes nothing
+    assert_true(basic_string_vector_reserve(&string_vector, 1, 1));
+    assert_true(basic_array_cap(&string_vector.chunk_data) == chunks);
+    assert_true(string_vector.string_offsets.elem_cap == string_count);
+
+    basic_string_vector_destroy(&string_vector);
+}
+
+static void test_string_vector_insert_remove(void **state)
+{
+    (void) state;
+
+    basic_string_vector string_vector = make_string_vector();
+    char buf[32];
+
+    // Building from the front and the middle exercises the shifts and
+    // keeps every later offset up to date
+    for (int i = 0; i < string_count; i += 2) {
+        make_string(buf, sizeof(buf), i);
+        assert_true(basic_string_vector_insert(&string_vector,
+                    (size_t)i / 2,
+                    buf));
+    }
+
+    for (int i = 1; i < string_count; i += 2) {
+        make_string(buf, sizeof(buf), i);
+        assert_true(basic_string_vector_insert(&string_vector, (size_t)i, buf));
+    }
+
+    for (int i = 0; i < string_count; ++i) {
+        make_string(buf, sizeof(buf), i);
+        assert_string_equal(basic_string_vector_at(&string_vector, (size_t)i),
+                buf);
+    }
+
+    // Remove every third string, then the ends
+    for (size_t i = 0; i < string_vector.string_count; i += 2) {
+        basic_string_vector_remove(&string_vector, i);
+    }
+
+    basic_string_vector_removefront(&string_vector);
+    basic_string_vector_removeback(&string_vector);
+
+    for (size_t i = 0; i < string_vector.string_count; ++i) {
+        // Survivors are the originals 3k + 1 and 3k + 2, less the first
+        int const original = (int)(i + 1) / 2 * 3 + (int)(i + 1) % 2 + 1;
+        make_string(buf, sizeof(buf), original);
+        assert_string_equal(basic_string_vector_at(&string_vector, i), buf);
+    }
+
+    while (!basic_string_vector_isempty(&string_vector)) {
+        basic_string_vector_removeback(&string_vector);
+    }
+
+    assert_true(string_vector.chunk_count == 0);
+    assert_true(basic_string_vector_shrink_to_fit(&string_vector));
+    basic_string_vector_destroy(&string_vector);
+}
+
+static void test_string_vector_insert_many(void **state)
+{
+    (void) state;
+
+    basic_string_vector string_vector = make_string_vector();
+    char bufs[string_count][32];
+    char const *strings[string_count];
+    for (int i = 0; i < string_count; ++i) {
+        make_string(bufs[i], sizeof(bufs[i]), i);
+        strings[i] = bufs[i];
+    }
+
+    // The outer thirds, then the middle third between them
+    int const third = string_count / 3;
+    assert_true(basic_string_vector_append(&string_vector, strings, 0));
+    assert_true(basic_string_vector_append(&string_vector,
+                strings + 2 * third,
+                (size_t)(string_count - 2 * third)));
+    assert_true(basic_string_vector_insert_many(&string_vector,
+                0,
+                strings,
+                (size_t)third));
+    assert_true(basic_string_vector_insert_many(&string_vector,
+                (size_t)third,
+                strings + third,
+                (size_t)third));
+
+    assert_true(string_vector.string_count == string_count);
+    for (int i = 0; i < string_count; ++i) {
+        assert_string_equal(basic_string_vector_at(&string_vector, (size_t)i),
+                strings[i]);
+    }
+
+    // Strings inserted one by one take the same chunks
+    basic_string_vector one_by_one = make_string_vector();
+    for (int i = 0; i < string_count; ++i) {
+        assert_true(basic_string_vector_insertback(&one_by_one, strings[i]));
+    }
+
+    assert_true(one_by_one.chunk_count == string_vector.chunk_count);
+    assert_memory_equal(one_by_one.string_offsets.data.data.ptr,
+            string_vector.string_offsets.data.data.ptr,
+            string_count * sizeof(size_t));
+
+    basic_string_vector_destroy(&one_by_one);
+    basic_string_vector_destroy(&string_vector);
+}
+
+static void test_string_vector_from_buffer(void **state)
+{
+    (void) state;
+
+    // Long enough for the delimiter scan to cover whole blocks and a tail,
+    // with strings that straddle the block boundaries
+    char text[4096];
+    size_t size = 0;
+    for (int i = 0; i < string_count; ++i) {
+        make_string(text + size, sizeof(text) - size, i);
+        size += strlen(text + size);
+        text[size++] = '\n';
+    }
+
+    basic_span buffer = {text, size};
+    basic_string_vector string_vector =
+        basic_string_vector_from_buffer(&buffer, '\n', chunk_size);
+    assert_true(basic_string_vector_isinit(&string_vector));
+    assert_true(string_vector.string_count == string_count);
+
+    char buf[32];
+    for (int i = 0; i < string_count; ++i) {
+        make_string(buf, sizeof(buf), i);
+        assert_string_equal(basic_string_vector_at(&string_vector, (size_t)i),
+                buf);
+    }
+
+    // The result grows like any other
+    assert_true(basic_string_vector_insert(&string_vector, 1, "inserted"));
+    assert_string_equal(basic_string_vector_at(&string_vector, 1), "inserted");
+    assert_string_equal(basic_string_vector_at(&string_vector, 2), "1");
+    basic_string_vector_destroy(&string_vector);
+
+    // Without a final delimiter the last string still counts, and
+    // consecutive delimiters give empty strings
+    char const fields[] = ",a,,bc";
+    buffer = (basic_span){(void *)fields, sizeof(fields) - 1};
+    string_vector = basic_string_vector_from_buffer(&buffer, ',', chunk_size);
+    assert_true(string_vector.string_count == 4);
+    assert_string_equal(basic_string_vector_at(&string_vector, 0), "");
+    assert_string_equal(basic_string_vector_at(&string_vector, 1), "a");
+    assert_string_equal(basic_string_vector_at(&string_vector, 2), "");
+    assert_string_equal(basic_string_vector_at(&string_vector, 3), "bc");
+    basic_string_vector_destroy(&string_vector);
+
+    buffer = BASIC_SPAN_NULL;
+    string_vector = basic_string_vector_from_buffer(&buffer, ',', chunk_size);
+    assert_true(basic_string_vector_isempty(&string_vector));
+    basic_string_vector_destroy(&string_vector);
+}
+
+static void test_string_vector_from_file(void **state)
+{
+    (void) state;
+
+    char path[] = "/tmp/basic_string_vector_XXXXXX";
+    int const fd = mkstemp(path);
+    if (fd < 0) {
+        fail_msg("Failed to create a file for testing");
+    }
+
+    char const lines[] = "first\nsecond line\n\nlast";
+    assert_true(write(fd, lines, sizeof(lines) - 1)
+            == (ssize_t)(sizeof(lines) - 1));
+    close(fd);
+
+    // Mapping the file and reading it give the same strings
+    for (int map_file = 0; map_file < 2; ++map_file) {
+        basic_string_vector string_vector = basic_string_vector_from_file(
+                path, '\n', chunk_size, map_file);
+        assert_true(string_vector.string_count == 4);
+        assert_string_equal(basic_string_vector_at(&string_vector, 1),
+                "second line");
+        assert_string_equal(basic_string_vector_back(&string_vector), "last");
+        basic_string_vector_destroy(&string_vector);
+    }
+
+    unlink(path);
+
+    basic_string_vector missing = basic_string_vector_from_file(
+            path, '\n', chunk_size, true);
+    assert_true(basic_string_vector_isnull(&missing));
+}
+
+static int compare_strings(void const *a, void const *b)
+{
+    return strcmp(*(char const *const *)a, *(char const *const *)b);
+}
+
+static void test_string_vector_sort(void **state)
+{
+    (void) state;
+
+    basic_string_vector string_vector = make_string_vector();
+    assert_true(basic_string_vector_sort(&string_vector));
+    assert_true(basic_string_vector_lower_bound(&string_vector, "a") == 0);
+
+    // Duplicates, empty strings, shared prefixes and bytes above 0x7f, which
+    // strcmp orders as unsigned
+    char bufs[string_count][32];
+    char const *expected[string_count];
+    for (int i = 0; i < string_count; ++i) {
+        make_string(bufs[i], sizeof(bufs[i]), i % 7 ? i % 97 : i);
+        if (i % 11 == 0) {
+            bufs[i][0] = '\0';
+        } else if (i % 13 == 0) {
+            bufs[i][0] = (char)0xe9;
+        }
+
+        expected[i] = bufs[i];
+        assert_true(basic_string_vector_insertback(&string_vector, bufs[i]));
+    }
+
+    qsort(expected, string_count, sizeof(expected[0]), compare_strings);
+    assert_true(basic_string_vector_sort(&string_vector));
+    assert_true(string_vector.string_count == string_count);
+    for (int i = 0; i < string_count; ++i) {
+        assert_string_equal(basic_string_vector_at(&string_vector, (size_t)i),
+                expected[i]);
+    }
+
+    // Finds the first of equal strings, and where absent ones would go
+    for (int i = 0; i < string_count; ++i) {
+        size_t const found = basic_string_vector_lower_bound(&string_vector,
+                expected[i]);
+        assert_true(found <= (size_t)i);
+        assert_string_equal(basic_string_vector_at(&string_vector, found),
+                expected[i]);
+        assert_true(!found || strcmp(basic_string_vector_at(&string_vector,
+                        found - 1), expected[i]) < 0);
+    }
+
+    assert_true(basic_string_vector_lower_bound(&string_vector, "") == 0);
+    assert_string_equal(basic_string_vector_at(&string_vector, 0), "");
+    assert_true(basic_string_vector_lower_bound(&string_vector, "\xff")
+            == string_count);
+
+    // The sorted vector is as editable as any other
+    assert_true(basic_string_vector_insert(&string_vector, 0, "first"));
+    basic_string_vector_removeback(&string_vector);
+    assert_string_equal(basic_string_vector_front(&string_vector), "first");
+    assert_string_equal(basic_string_vector_back(&string_vector),
+            expected[string_count - 2]);
+    basic_string_vector_destroy(&string_vector);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_string_vector_insertback),
+        cmocka_unit_test(test_string_vector_reserve),
+        cmocka_unit_test(test_string_vector_insert_remove),
+        cmocka_unit_test(test_string_vector_insert_many),
+        cmocka_unit_test(test_string_vector_from_buffer),
+        cmocka_unit_test(test_string_vector_from_file),
+        cmocka_unit_test(test_string_vector_sort),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,432 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "vector.h"
+
+enum { initial_cap = 2, dummy_size = 32 };
+
+static basic_vector make_vector(void)
+{
+    basic_vector vector = basic_vector_new(sizeof(int), initial_cap);
+    if (basic_vector_isnull(&vector)) {
+        fail_msg("Failed to allocate basic_vector for testing");
+    }
+
+    return vector;
+}
+
+static void assert_vector_equals(
+        basic_vector const *vector,
+        int const *expected,
+        size_t count)
+{
+    assert_true(vector->elem_count == count);
+    for (size_t i = 0; i < count; ++i) {
+        assert_true(*(int const *)basic_vector_at_c(vector, i) == expected[i]);
+    }
+}
+
+static void test_vector_insert(void **state)
+{
+    (void) state;
+
+    basic_vector vector = make_vector();
+    int values[] = {1, 2, 3};
+
+    // Inserting out of range should assert
+    expect_assert_failure(basic_vector_insert(&vector, -1, &values[0]));
+    expect_assert_failure(basic_vector_insert(&vector, 1, &values[0]));
+
+    // Inserting at the front, back and middle should place each element
+    // and grow past the initial capacity
+    assert_true(basic_vector_insertfront(&vector, &values[2]));
+    assert_true(basic_vector_insertfront(&vector, &values[0]));
+    assert_true(basic_vector_insert(&vector, 1, &values[1]));
+    assert_vector_equals(&vector, values, 3);
+    assert_true(vector.elem_cap >= 3);
+
+    // Removing from the front, back and out of range
+    expect_assert_failure(basic_vector_remove(&vector, 3));
+    basic_vector_removefront(&vector);
+    basic_vector_removeback(&vector);
+    assert_vector_equals(&vector, &values[1], 1);
+
+    basic_vector_destroy(&vector);
+    assert_true(basic_vector_isnull(&vector));
+}
+
+static void test_vector_insert_range(void **state)
+{
+    (void) state;
+
+    basic_vector vector = make_vector();
+    int src[dummy_size];
+    int expected[dummy_size * 2];
+
+    for (int i = 0; i < dummy_size; ++i) {
+        src[i] = i;
+    }
+
+    // Out of range indices should assert, and a count whose size would
+    // overflow should fail without changing the vector
+    expect_assert_failure(basic_vector_insert_range(&vector, 1, src, 1));
+    assert_false(basic_vector_insert_range(&vector, 0, src, SIZE_MAX));
+    assert_true(basic_vector_isempty(&vector));
+
+    // Appending a range should copy it in order, growing once
+    assert_true(basic_vector_append(&vector, src, dummy_size));
+    assert_vector_equals(&vector, src, dummy_size);
+
+    // Inserting an empty range is a no-op
+    assert_true(basic_vector_insert_range(&vector, 3, src, 0));
+    assert_vector_equals(&vector, src, dummy_size);
+
+    // Inserting a range in the middle should shift the tail right by the
+    // range length
+    assert_true(basic_vector_insert_range(&vector, 4, src, 8));
+    memcpy(expected, src, 4 * sizeof(int));
+    memcpy(expected + 4, src, 8 * sizeof(int));
+    memcpy(expected + 12, src + 4, (dummy_size - 4) * sizeof(int));
+    assert_vector_equals(&vector, expected, dummy_size + 8);
+
+    basic_vector_destroy(&vector);
+}
+
+static void test_vector_insert_range_self(void **state)
+{
+    (void) state;
+
+    enum { count = 6 };
+    int src[count];
+    for (int i = 0; i < count; ++i) {
+        src[i] = i;
+    }
+
+    // Every range of a vector inserted back into it, at every index, whether
+    // the range ends up before, after or around the gap and whether the
+    // insertion reallocates or not
+    for (size_t index = 0; index <= count; ++index) {
+        for (size_t first = 0; first < count; ++first) {
+            for (size_t n = 1; first + n <= count; ++n) {
+                basic_vector vector = make_vector();
+                assert_true(basic_vector_append(&vector, src, count));
+
+                int expected[2 * count];
+                memcpy(expected, src, index * sizeof(int));
+                memcpy(expected + index, src + first, n * sizeof(int));
+                memcpy(expected + index + n,
+                        src + index,
+                        (count - index) * sizeof(int));
+
+                assert_true(basic_vector_insert_range(&vector,
+                            index,
+                            basic_vector_at(&vector, first),
+                            n));
+                assert_vector_equals(&vector, expected, count + n);
+                basic_vector_destroy(&vector);
+            }
+        }
+    }
+
+    // Appending a vector to itself doubles it
+    basic_vector vector = make_vector();
+    assert_true(basic_vector_append(&vector, src, count));
+    assert_true(basic_vector_append(&vector,
+                basic_vector_at(&vector, 0),
+                vector.elem_count));
+
+    int expected[2 * count];
+    memcpy(expected, src, sizeof(src));
+    memcpy(expected + count, src, sizeof(src));
+    assert_vector_equals(&vector, expected, 2 * count);
+    basic_vector_destroy(&vector);
+}
+
+static void test_vector_remove_range(void **state)
+{
+    (void) state;
+
+    basic_vector vector = make_vector();
+    int src[dummy_size];
+
+    for (int i = 0; i < dummy_size; ++i) {
+        src[i] = i;
+    }
+
+    assert_true(basic_vector_append(&vector, src, dummy_size));
+
+    // Ranges that extend past the end should assert
+    expect_assert_failure(basic_vector_remove_range(&vector, -1, 1));
+    expect_assert_failure(basic_vector_remove_range(&vector, 30, 3));
+
+    // Removing a middle range should close the gap
+    basic_vector_remove_range(&vector, 4, 8);
+    int expected[dummy_size];
+    memcpy(expected, src, 4 * sizeof(int));
+    memcpy(expected + 4, src + 12, (dummy_size - 12) * sizeof(int));
+    assert_vector_equals(&vector, expected, dummy_size - 8);
+
+    // Removing a tail range needs no shift
+    basic_vector_remove_range(&vector, 10, dummy_size - 18);
+    assert_vector_equals(&vector, expected, 10);
+
+    basic_vector_remove_range(&vector, 0, 10);
+    assert_true(basic_vector_isempty(&vector));
+
+    basic_vector_destroy(&vector);
+}
+
+static void test_vector_emplace(void **state)
+{
+    (void) state;
+
+    basic_vector vector = make_vector();
+
+    expect_assert_failure(basic_vector_emplace(&vector, 1));
+    expect_assert_failure(basic_vector_emplace_back_n(&vector, 0));
+
+    // Emplaced slots are written in place by the caller
+    *(int *)basic_vector_emplace_back(&vector) = 3;
+    *(int *)basic_vector_emplace(&vector, 0) = 1;
+    *(int *)basic_vector_emplace(&vector, 1) = 2;
+
+    int const expected[] = {1, 2, 3, 4, 5, 6, 7};
+    assert_vector_equals(&vector, expected, 3);
+
+    // emplace_back_n returns a span over exactly the new slots
+    basic_span slots = basic_vector_emplace_back_n(&vector, 4);
+    assert_true(slots.size == 4 * sizeof(int));
+    assert_ptr_equal(slots.ptr, basic_vector_at(&vector, 3));
+
+    int *const ints = slots.ptr;
+    for (int i = 0; i < 4; ++i) {
+        ints[i] = 4 + i;
+    }
+
+    assert_vector_equals(&vector, expected, 7);
+
+    basic_vector_destroy(&vector);
+}
+
+static void test_vector_reserve_shrink(void **state)
+{
+    (void) state;
+
+    basic_vector vector = make_vector();
+    int src[dummy_size] = {0};
+
+    // A capacity whose size would overflow cannot be reserved
+    assert_false(basic_vector_reserve(&vector, SIZE_MAX / sizeof(int) + 1));
+    assert_true(vector.elem_cap == initial_cap);
+
+    // Reserving grows the capacity to exactly what was asked, and
+    // reserving less than the capacity does nothing
+    assert_true(basic_vector_reserve(&vector, 100));
+    assert_true(vector.elem_cap == 100);
+    assert_true(basic_vector_reserve(&vector, 10));
+    assert_true(vector.elem_cap == 100);
+
+    // Appending within the reservation does not reallocate
+    void const *const data = vector.data.data.ptr;
+    assert_true(basic_vector_append(&vector, src, dummy_size));
+    assert_ptr_equal(vector.data.data.ptr, data);
+
+    // Shrinking to fit releases the spare capacity but keeps the contents
+    assert_true(basic_vector_shrink_to_fit(&vector));
+    assert_true(vector.elem_cap == dummy_size);
+    assert_vector_equals(&vector, src, dummy_size);
+
+    // An empty vector keeps a single slot
+    basic_vector_remove_range(&vector, 0, dummy_size);
+    assert_true(basic_vector_shrink_to_fit(&vector));
+    assert_true(vector.elem_cap == 1);
+
+    basic_vector_destroy(&vector);
+}
+
+static void test_vector_growth(void **state)
+{
+    (void) state;
+
+    basic_vector vector = make_vector();
+    int const value = 7;
+
+    // A fixed growth increment must be positive
+    expect_assert_failure(
+            basic_vector_set_growth(&vector, BASIC_GROWTH_FIXED(0)));
+
+    // Fixed increments add exactly that many slots per growth
+    basic_vector_set_growth(&vector, BASIC_GROWTH_FIXED(5));
+    for (int i = 0; i < 3; ++i) {
+        assert_true(basic_vector_insertback(&vector, (void *)&value));
+    }
+    assert_true(vector.elem_cap == initial_cap + 5);
+
+    // One and a half times growth
+    basic_vector_set_growth(&vector, BASIC_GROWTH_ONE_AND_HALF);
+    while (vector.elem_count < vector.elem_cap) {
+        assert_true(basic_vector_insertback(&vector, (void *)&value));
+    }
+    assert_true(basic_vector_insertback(&vector, (void *)&value));
+    assert_true(vector.elem_cap == (initial_cap + 5) * 3 / 2);
+
+    // Page-granular growth rounds the allocation to a whole page
+    basic_vector_set_growth(&vector, BASIC_GROWTH_PAGE);
+    while (vector.elem_count < vector.elem_cap) {
+        assert_true(basic_vector_insertback(&vector, (void *)&value));
+    }
+    assert_true(basic_vector_insertback(&vector, (void *)&value));
+    assert_true(vector.data.data.size % 4096 == 0);
+
+    // Growth clamps to the largest capacity whose size fits in a size_t,
+    // and reports 0 when even the minimum does not fit
+    size_t const max = SIZE_MAX / sizeof(int);
+    basic_growth_policy const doubling = BASIC_GROWTH_DOUBLE;
+    basic_growth_policy const fixed = BASIC_GROWTH_FIXED(max / 2);
+    assert_true(basic_growth_next_cap(&doubling, max / 2 + 1, max / 2 + 2,
+                sizeof(int)) == max);
+    assert_true(basic_growth_next_cap(&fixed, max / 2 + 1, max / 2 + 2,
+                sizeof(int)) == max);
+    assert_true(basic_growth_next_cap(&doubling, 1, max + 1,
+                sizeof(int)) == 0);
+
+    basic_vector_destroy(&vector);
+}
+
+static bool is_multiple_of(void const *elem, void *ctx)
+{
+    return *(int const *)elem % *(int const *)ctx == 0;
+}
+
+static void test_vector_remove_if(void **state)
+{
+    (void) state;
+
+    enum { n = 100 };
+
+    basic_vector vector = make_vector();
+    for (int i = 0; i < n; ++i) {
+        assert_true(basic_vector_insertback(&vector, &i));
+    }
+
+    // Removing multiples of three should keep the rest in order
+    int divisor = 3;
+    assert_true(basic_vector_remove_if(&vector, is_multiple_of, &divisor)
+            == (n + 2) / 3);
+    for (size_t i = 0; i < vector.elem_count; ++i) {
+        int const value = *(int *)basic_vector_at(&vector, i);
+        assert_true(value % 3 != 0);
+        assert_true(value == (int)(i + i / 2 + 1));
+    }
+
+    // Retaining even values should leave only those
+    divisor = 2;
+    size_t const before = vector.elem_count;
+    size_t const removed = basic_vector_retain(&vector, is_multiple_of, &divisor);
+    assert_true(vector.elem_count == before - removed);
+    for (size_t i = 0; i < vector.elem_count; ++i) {
+        assert_true(*(int *)basic_vector_at(&vector, i) % 6 != 0);
+        assert_true(*(int *)basic_vector_at(&vector, i) % 2 == 0);
+    }
+
+    basic_vector_destroy(&vector);
+}
+
+static void test_vector_dedup(void **state)
+{
+    (void) state;
+
+    int const sorted[] = {1, 1, 2, 3, 3, 3, 4, 5, 5};
+    int const unique[] = {1, 2, 3, 4, 5};
+
+    basic_vector vector = make_vector();
+    assert_true(basic_vector_append(&vector, sorted, 9));
+
+    assert_true(basic_vector_dedup(&vector) == 4);
+    assert_vector_equals(&vector, unique, 5);
+
+    // Deduplicating an already unique vector does nothing
+    assert_true(basic_vector_dedup(&vector) == 0);
+    assert_vector_equals(&vector, unique, 5);
+
+    basic_vector_destroy(&vector);
+}
+
+static void check_compact(size_t elem_size)
+{
+    enum { n = 203 };
+
+    basic_vector vector = basic_vector_new(elem_size, n);
+    basic_bitset mask = basic_bitset_new(n);
+    unsigned char elem[8];
+
+    for (int i = 0; i < n; ++i) {
+        memset(elem, i, sizeof elem);
+        assert_true(basic_vector_insertback(&vector, elem));
+
+        if (i % 3 == 0 || i % 7 == 0) {
+            basic_bitset_set(&mask, i);
+        }
+    }
+
+    // Only the elements whose mask bit is set should remain, in order
+    size_t const kept = (size_t)basic_bitset_count(&mask);
+    assert_true(basic_vector_compact(&vector, &mask) == n - kept);
+    assert_true(vector.elem_count == kept);
+
+    int index = 0;
+    for (int i = basic_bitset_next(&mask, 0); i != -1;
+            i = basic_bitset_next(&mask, i + 1), ++index) {
+        memset(elem, i, sizeof elem);
+        assert_memory_equal(basic_vector_at(&vector, index), elem, elem_size);
+    }
+
+    basic_bitset_destroy(&mask);
+    basic_vector_destroy(&vector);
+}
+
+static void test_vector_compact(void **state)
+{
+    (void) state;
+
+    basic_vector vector = make_vector();
+    basic_bitset small_mask = basic_bitset_new(1);
+    int src[dummy_size] = {0};
+
+    // A mask shorter than the vector should assert
+    assert_true(basic_vector_append(&vector, src, dummy_size));
+    expect_assert_failure(basic_vector_compact(&vector, &small_mask));
+
+    basic_bitset_destroy(&small_mask);
+    basic_vector_destroy(&vector);
+
+    // Check element sizes with and without a vector fast path
+    check_compact(4);
+    check_compact(8);
+    check_compact(3);
+}
+
+int main(int argc, char **argv)
+{
+    (void) argc;
+    (void) argv;
+
+    struct CMUnitTest const tests[] = {
+        cmocka_unit_test(test_vector_insert),
+        cmocka_unit_test(test_vector_insert_range),
+        cmocka_unit_test(test_vector_insert_range_self),
+        cmocka_unit_test(test_vector_remove_range),
+        cmocka_unit_test(test_vector_emplace),
+        cmocka_unit_test(test_vector_reserve_shrink),
+        cmocka_unit_test(test_vector_growth),
+        cmocka_unit_test(test_vector_remove_if),
+        cmocka_unit_test(test_vector_dedup),
+        cmocka_unit_test(test_vector_compact),
+    };
+
+    return cmocka_run_group_tests(tests, NULL, NULL);
+}
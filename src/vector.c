@@ -1,29 +1,43 @@
 #include "vector.h"
 
+#include <stdint.h>
 #include <string.h>
 
-enum {
-    vector_grow_factor = 2
-};
+#if defined(__AVX512F__) || (defined(__AVX2__) && defined(__BMI2__))
+    #include <immintrin.h>
+#endif
 
 static bool vector_isfull(basic_vector const *vector);
-static basic_vector *vector_grow(basic_vector *vector);
+static basic_vector *vector_grow(basic_vector *vector, size_t min_cap);
 
 static void vector_shift_elem_right(
         basic_vector *vector,
-        int index,
-        int shift_by);
+        size_t index,
+        size_t shift_by);
 
 static void vector_shift_elem_left(
         basic_vector *vector,
-        int index,
-        int shift_by);
+        size_t index,
+        size_t shift_by);
 
 static void vector_write_elem(
         basic_vector *vector,
-        int index,
+        size_t index,
         void *elem);
 
+static void *vector_open_gap(basic_vector *vector, size_t index, size_t count);
+
+static size_t vector_filter(
+        basic_vector *vector,
+        basic_vector_pred pred,
+        void *ctx,
+        bool keep);
+
+static size_t vector_compact_simd(
+        basic_vector *vector,
+        uint64_t const *mask_words,
+        size_t *kept);
+
 basic_vector basic_vector_move(basic_vector *vector)
 {
     BASIC_ASSERT_PTR_NONNULL(vector);
@@ -53,16 +67,17 @@ basic_vector basic_vector_clone(basic_vector const *vector)
     return (basic_vector) {
         .data = basic_array_move(&data),
         .elem_count = vector->elem_count,
-        .elem_cap = vector->elem_cap
+        .elem_cap = vector->elem_cap,
+        .growth = vector->growth
     };
 }
 
-basic_vector basic_vector_new(size_t elem_size, int initial_cap)
+basic_vector basic_vector_new(size_t elem_size, size_t initial_cap)
 {
     BASIC_ASSERT_NONZERO(elem_size);
     BASIC_ASSERT_POSITIVE(initial_cap);
 
-    basic_array data = basic_array_alloc(elem_size, (size_t)initial_cap);
+    basic_array data = basic_array_alloc(elem_size, initial_cap);
     if (basic_array_isnull(&data)) {
         return BASIC_VECTOR_NULL;
     }
@@ -70,7 +85,8 @@ basic_vector basic_vector_new(size_t elem_size, int initial_cap)
     return (basic_vector) {
         .data = basic_array_move(&data),
         .elem_count = 0,
-        .elem_cap = initial_cap
+        .elem_cap = initial_cap,
+        .growth = BASIC_GROWTH_DOUBLE
     };
 }
 
@@ -84,19 +100,72 @@ void basic_vector_destroy(basic_vector *vector)
     }
 }
 
-bool basic_vector_insert(basic_vector *vector, int index, void *elem)
+void basic_vector_set_growth(
+        basic_vector *vector,
+        basic_growth_policy growth)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+    BASIC_ASSERT(growth.kind != basic_growth_fixed || growth.increment > 0,
+            "fixed growth increment %zu must be positive", growth.increment);
+
+    vector->growth = growth;
+}
+
+bool basic_vector_reserve(basic_vector *vector, size_t elem_cap)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+
+    // Reserve allocates exactly what was asked for, bypassing the growth
+    // policy, since the caller knows the final size
+    if (elem_cap <= vector->elem_cap) {
+        return true;
+    }
+
+    if (!basic_array_realloc(&vector->data, elem_cap)) {
+        return false;
+    }
+
+    vector->elem_cap = elem_cap;
+    return true;
+}
+
+bool basic_vector_shrink_to_fit(basic_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+
+    // A basic_array cannot be empty, so an empty vector keeps one slot
+    size_t const elem_cap = vector->elem_count ? vector->elem_count : 1;
+    if (elem_cap == vector->elem_cap) {
+        return true;
+    }
+
+    if (!basic_array_realloc(&vector->data, elem_cap)) {
+        return false;
+    }
+
+    vector->elem_cap = elem_cap;
+    return true;
+}
+
+bool basic_vector_insert(basic_vector *vector, size_t index, void *elem)
 {
     BASIC_ASSERT_PTR_NONNULL(vector);
     BASIC_ASSERT_PTR_NONNULL(elem);
     BASIC_ASSERT(basic_vector_isinit(vector),
             "basic_vector object must be initialised");
-    BASIC_ASSERT_POSITIVE(index);
     BASIC_ASSERT(index <= vector->elem_count,
-            "insert index %d out of range",
+            "insert index %zu out of range",
             index);
 
     // Grow the vector if necessary
-    if (vector_isfull(vector) && !vector_grow(vector)) {
+    if (vector_isfull(vector)
+            && !vector_grow(vector, vector->elem_count + 1)) {
         return false;
     }
 
@@ -114,14 +183,13 @@ bool basic_vector_insert(basic_vector *vector, int index, void *elem)
     return true;
 }
 
-void basic_vector_remove(basic_vector *vector, int index)
+void basic_vector_remove(basic_vector *vector, size_t index)
 {
     BASIC_ASSERT_PTR_NONNULL(vector);
     BASIC_ASSERT(basic_vector_isinit(vector),
             "basic_vector object must be initialised");
-    BASIC_ASSERT_POSITIVE(index);
     BASIC_ASSERT(index < vector->elem_count,
-            "index %d out of range",
+            "index %zu out of range",
             index);
 
     if (index != vector->elem_count - 1) {
@@ -131,40 +199,241 @@ void basic_vector_remove(basic_vector *vector, int index)
     --vector->elem_count;
 }
 
-void *basic_vector_at(basic_vector *vector, int index)
+bool basic_vector_insert_range(
+        basic_vector *vector,
+        size_t index,
+        void const *src,
+        size_t count)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT_PTR_NONNULL(src);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+    BASIC_ASSERT(index <= vector->elem_count,
+            "insert index %zu out of range",
+            index);
+
+    if (!count) {
+        return true;
+    }
+
+    // The source may be elements of this vector, which opening the gap can
+    // move or reallocate, so it is kept as an offset until then
+    size_t const size = count * vector->data.elem_size;
+    uintptr_t const base = (uintptr_t)vector->data.data.ptr;
+    uintptr_t const from = (uintptr_t)src;
+    bool const aliased = from >= base
+        && from < base + vector->elem_count * vector->data.elem_size;
+
+    void *const gap = vector_open_gap(vector, index, count);
+    if (!gap) {
+        return false;
+    }
+
+    if (!aliased) {
+        memcpy(gap, src, size);
+        return true;
+    }
+
+    // Source bytes before the gap stayed put and those after it moved past
+    // it, so the range is copied in up to two pieces, neither of which
+    // overlaps the gap
+    unsigned char const *const data = vector->data.data.ptr;
+    size_t const offset = from - base;
+    size_t const gap_offset = index * vector->data.elem_size;
+    size_t const before = offset < gap_offset
+        ? (gap_offset - offset < size ? gap_offset - offset : size)
+        : 0;
+
+    memcpy(gap, data + offset, before);
+    memcpy((unsigned char *)gap + before,
+            data + offset + before + size,
+            size - before);
+    return true;
+}
+
+void basic_vector_remove_range(basic_vector *vector, size_t index, size_t count)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+    BASIC_ASSERT(index <= vector->elem_count
+            && count <= vector->elem_count - index,
+            "range [%zu, %zu) out of range",
+            index, index + count);
+
+    if (!count) {
+        return;
+    }
+
+    // Close the gap with a single shift of the tail
+    if (index + count != vector->elem_count) {
+        vector_shift_elem_left(vector, index + count, count);
+    }
+
+    vector->elem_count -= count;
+}
+
+void *basic_vector_emplace(basic_vector *vector, size_t index)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+    BASIC_ASSERT(index <= vector->elem_count,
+            "emplace index %zu out of range",
+            index);
+
+    return vector_open_gap(vector, index, 1);
+}
+
+basic_span basic_vector_emplace_back_n(basic_vector *vector, size_t count)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+    BASIC_ASSERT_POSITIVE(count);
+
+    void *const slots = vector_open_gap(vector, vector->elem_count, count);
+    if (!slots) {
+        return BASIC_SPAN_NULL;
+    }
+
+    return (basic_span) {
+        .ptr = slots,
+        .size = count * vector->data.elem_size
+    };
+}
+
+size_t basic_vector_remove_if(
+        basic_vector *vector,
+        basic_vector_pred pred,
+        void *ctx)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT_PTR_NONNULL(pred);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+
+    return vector_filter(vector, pred, ctx, false);
+}
+
+size_t basic_vector_retain(
+        basic_vector *vector,
+        basic_vector_pred pred,
+        void *ctx)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT_PTR_NONNULL(pred);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+
+    return vector_filter(vector, pred, ctx, true);
+}
+
+size_t basic_vector_dedup(basic_vector *vector)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+
+    if (vector->elem_count < 2) {
+        return 0;
+    }
+
+    // Elements are compared bytewise against the last element kept, so
+    // runs of equal elements collapse to their first member
+    size_t const elem_size = vector->data.elem_size;
+    char *const base = vector->data.data.ptr;
+    size_t write = 1;
+
+    for (size_t read = 1; read < vector->elem_count; ++read) {
+        char const *const elem = base + read * elem_size;
+        char *const last = base + (write - 1) * elem_size;
+
+        if (memcmp(elem, last, elem_size) != 0) {
+            if (write != read) {
+                memcpy(last + elem_size, elem, elem_size);
+            }
+
+            ++write;
+        }
+    }
+
+    size_t const removed = vector->elem_count - write;
+    vector->elem_count = write;
+    return removed;
+}
+
+size_t basic_vector_compact(basic_vector *vector, basic_bitset const *mask)
+{
+    BASIC_ASSERT_PTR_NONNULL(vector);
+    BASIC_ASSERT_PTR_NONNULL(mask);
+    BASIC_ASSERT(basic_vector_isinit(vector),
+            "basic_vector object must be initialised");
+    BASIC_ASSERT(basic_bitset_isinit(mask),
+            "basic_bitset object must be initialised");
+    BASIC_ASSERT((size_t)mask->bit_count >= vector->elem_count,
+            "mask has %d bits but the vector has %zu elements",
+            mask->bit_count, vector->elem_count);
+
+    uint64_t const *const words = mask->words.ptr;
+    size_t const elem_size = vector->data.elem_size;
+    char *const base = vector->data.data.ptr;
+
+    // The vector kernels handle whole blocks of 4- and 8-byte elements;
+    // the scalar loop finishes whatever they leave
+    size_t write = 0;
+    size_t read = vector_compact_simd(vector, words, &write);
+
+    for (; read < vector->elem_count; ++read) {
+        if ((words[read / BASIC_BITS_PER_WORD]
+                    >> (read % BASIC_BITS_PER_WORD)) & 1) {
+            if (write != read) {
+                memcpy(base + write * elem_size,
+                        base + read * elem_size,
+                        elem_size);
+            }
+
+            ++write;
+        }
+    }
+
+    size_t const removed = vector->elem_count - write;
+    vector->elem_count = write;
+    return removed;
+}
+
+void *basic_vector_at(basic_vector *vector, size_t index)
 {
     BASIC_ASSERT_PTR_NONNULL(vector);
     BASIC_ASSERT(basic_vector_isinit(vector),
             "basic_vector object must be initialised");
-    BASIC_ASSERT_POSITIVE(index);
     BASIC_ASSERT(index < vector->elem_count,
-            "index %d out of range",
+            "index %zu out of range",
             index);
 
     return basic_array_at(&vector->data, index);
 }
 
-void const *basic_vector_at_c(basic_vector const *vector, int index)
+void const *basic_vector_at_c(basic_vector const *vector, size_t index)
 {
     BASIC_ASSERT_PTR_NONNULL(vector);
     BASIC_ASSERT(basic_vector_isinit(vector),
             "basic_vector object must be initialised");
-    BASIC_ASSERT_POSITIVE(index);
     BASIC_ASSERT(index < vector->elem_count,
-            "index %d out of range",
+            "index %zu out of range",
             index);
 
     return basic_array_at_c(&vector->data, index);
 }
 
-basic_span basic_vector_get(basic_vector *vector, int index)
+basic_span basic_vector_get(basic_vector *vector, size_t index)
 {
     BASIC_ASSERT_PTR_NONNULL(vector);
     BASIC_ASSERT(basic_vector_isinit(vector),
             "basic_vector object must be initialised");
-    BASIC_ASSERT_POSITIVE(index);
     BASIC_ASSERT(index < vector->elem_count,
-            "index %d out of range",
+            "index %zu out of range",
             index);
 
     return basic_array_get(&vector->data, index);
@@ -175,10 +444,16 @@ bool vector_isfull(basic_vector const *vector)
     return vector->elem_count == vector->elem_cap;
 }
 
-basic_vector *vector_grow(basic_vector *vector)
+basic_vector *vector_grow(basic_vector *vector, size_t min_cap)
 {
-    int const new_elem_cap = vector->elem_cap * vector_grow_factor;
-    if (!basic_array_realloc(&vector->data, new_elem_cap)) {
+    size_t const new_elem_cap = basic_growth_next_cap(
+            &vector->growth,
+            vector->elem_cap,
+            min_cap,
+            vector->data.elem_size);
+
+    // A zero capacity means min_cap elements would not fit in a size_t
+    if (!new_elem_cap || !basic_array_realloc(&vector->data, new_elem_cap)) {
         return NULL;
     }
 
@@ -188,8 +463,8 @@ basic_vector *vector_grow(basic_vector *vector)
 
 void vector_shift_elem_right(
         basic_vector *vector,
-        int index,
-        int shift_by)
+        size_t index,
+        size_t shift_by)
 {
     void *const dest = basic_array_at(&vector->data, index + shift_by);
     void const *const src = basic_array_at_c(&vector->data, index);
@@ -199,8 +474,8 @@ void vector_shift_elem_right(
 
 void vector_shift_elem_left(
         basic_vector *vector,
-        int index,
-        int shift_by)
+        size_t index,
+        size_t shift_by)
 {
     void *const dest = basic_array_at(&vector->data, index - shift_by);
     void const *const src = basic_array_at(&vector->data, index);
@@ -210,10 +485,139 @@ void vector_shift_elem_left(
 
 void vector_write_elem(
         basic_vector *vector,
-        int index,
+        size_t index,
         void *elem)
 {
     void *const write_ptr = basic_array_at(&vector->data, index);
     memcpy(write_ptr, elem, vector->data.elem_size);
 }
 
+void *vector_open_gap(basic_vector *vector, size_t index, size_t count)
+{
+    // Grow once to fit the whole gap, rather than once per element. The
+    // new count is checked before it is formed, so it cannot wrap.
+    if (count > SIZE_MAX - vector->elem_count) {
+        return NULL;
+    }
+
+    size_t const elem_count = vector->elem_count + count;
+    if (elem_count > vector->elem_cap && !vector_grow(vector, elem_count)) {
+        return NULL;
+    }
+
+    // Open the gap with a single shift of the tail
+    if (index != vector->elem_count) {
+        vector_shift_elem_right(vector, index, count);
+    }
+
+    vector->elem_count = elem_count;
+    return basic_array_at(&vector->data, index);
+}
+
+size_t vector_filter(
+        basic_vector *vector,
+        basic_vector_pred pred,
+        void *ctx,
+        bool keep)
+{
+    size_t const elem_size = vector->data.elem_size;
+    char *const base = vector->data.data.ptr;
+    size_t write = 0;
+
+    // Kept elements are copied down over the removed ones in a single
+    // pass, so each element moves at most once
+    for (size_t read = 0; read < vector->elem_count; ++read) {
+        char const *const elem = base + read * elem_size;
+        if (pred(elem, ctx) == keep) {
+            if (write != read) {
+                memcpy(base + write * elem_size, elem, elem_size);
+            }
+
+            ++write;
+        }
+    }
+
+    size_t const removed = vector->elem_count - write;
+    vector->elem_count = write;
+    return removed;
+}
+
+size_t vector_compact_simd(
+        basic_vector *vector,
+        uint64_t const *mask_words,
+        size_t *kept)
+{
+    size_t read = 0;
+    size_t write = 0;
+
+#if defined(__AVX512F__)
+    // vpcompressd/vpcompressq store only the selected lanes, contiguously.
+    // Blocks are aligned to the mask words, so each block mask is a shift
+    // of a single word.
+    if (vector->data.elem_size == sizeof(uint32_t)) {
+        uint32_t *const base = vector->data.data.ptr;
+        for (; read + 16 <= vector->elem_count; read += 16) {
+            __mmask16 const mask = (__mmask16)(mask_words[read / 64]
+                    >> (read % 64));
+            __m512i const v = _mm512_loadu_si512((void const *)(base + read));
+            _mm512_mask_compressstoreu_epi32((void *)(base + write), mask, v);
+            write += basic_bits_popcount(mask);
+        }
+    } else if (vector->data.elem_size == sizeof(uint64_t)) {
+        uint64_t *const base = vector->data.data.ptr;
+        for (; read + 8 <= vector->elem_count; read += 8) {
+            __mmask8 const mask = (__mmask8)(mask_words[read / 64]
+                    >> (read % 64));
+            __m512i const v = _mm512_loadu_si512((void const *)(base + read));
+            _mm512_mask_compressstoreu_epi64((void *)(base + write), mask, v);
+            write += basic_bits_popcount(mask);
+        }
+    }
+#elif defined(__AVX2__) && defined(__BMI2__)
+    // AVX2 has no compress instruction, so build a vpermd index vector
+    // that moves the selected 32-bit lanes to the front: pdep spreads each
+    // lane bit to a byte, and pext picks the matching lane numbers out of
+    // the identity sequence. Storing a whole vector at the write position
+    // is safe because write <= read and the block was loaded first.
+    if (vector->data.elem_size == sizeof(uint32_t)) {
+        uint32_t *const base = vector->data.data.ptr;
+        for (; read + 8 <= vector->elem_count; read += 8) {
+            unsigned const mask = (unsigned)(mask_words[read / 64]
+                    >> (read % 64)) & 0xff;
+            uint64_t const lanes = _pdep_u64(mask, UINT64_C(0x0101010101010101))
+                * 0xff;
+            __m256i const perm = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(
+                        (long long)_pext_u64(UINT64_C(0x0706050403020100),
+                            lanes)));
+            __m256i const v = _mm256_loadu_si256((__m256i const *)(base + read));
+            _mm256_storeu_si256((__m256i *)(base + write),
+                    _mm256_permutevar8x32_epi32(v, perm));
+            write += basic_bits_popcount(mask);
+        }
+    } else if (vector->data.elem_size == sizeof(uint64_t)) {
+        uint64_t *const base = vector->data.data.ptr;
+        for (; read + 4 <= vector->elem_count; read += 4) {
+            unsigned const mask = (unsigned)(mask_words[read / 64]
+                    >> (read % 64)) & 0xf;
+
+            // Each 64-bit element is a pair of 32-bit lanes
+            unsigned const pairs = _pdep_u32(mask, 0x55) * 3;
+            uint64_t const lanes = _pdep_u64(pairs, UINT64_C(0x0101010101010101))
+                * 0xff;
+            __m256i const perm = _mm256_cvtepu8_epi32(_mm_cvtsi64_si128(
+                        (long long)_pext_u64(UINT64_C(0x0706050403020100),
+                            lanes)));
+            __m256i const v = _mm256_loadu_si256((__m256i const *)(base + read));
+            _mm256_storeu_si256((__m256i *)(base + write),
+                    _mm256_permutevar8x32_epi32(v, perm));
+            write += basic_bits_popcount(mask);
+        }
+    }
+#else
+    (void) vector;
+    (void) mask_words;
+#endif
+
+    *kept = write;
+    return read;
+}